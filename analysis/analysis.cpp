@@ -1,5 +1,13 @@
 #include "../avl/avlbst.h"
+#include "../avl/threadedavl.h"
 #include "../splay/splay.h"
+#include "../redblack/rbbst.h"
+#include "../wavl/wavlbst.h"
+#include "../scapegoat/scapegoat.h"
+#include "../treap/treap.h"
+#include "../bplus/bplustree.h"
+#include "../art/art.h"
+#include "../avl/avlbucket.h"
 
 #include <iostream>
 #include <fstream>
@@ -7,12 +15,294 @@
 #include <vector>
 #include <ctime>
 #include <string>
+#include <algorithm>
+#include <random>
+#include <cstdlib>
 
 using namespace std;
 
+// Plain AVL nodes only add a height and a subtree size to the base node. Threads
+// are kept in ThreadedAVLNode so that trees that do not use them do not pay for them.
+static_assert(sizeof(AVLNode<int, int>) == sizeof(Node<int, int>) + 2 * sizeof(int), "AVLNode<int, int> grew");
+static_assert(sizeof(AVLNode<string, int>) == sizeof(Node<string, int>) + 2 * sizeof(int), "AVLNode<string, int> grew");
+static_assert(sizeof(ThreadedAVLNode<int, int>) == sizeof(AVLNode<int, int>) + 2 * sizeof(void*), "ThreadedAVLNode<int, int> grew");
+
+/**
+* Times inserting every string into an empty tree, finding every string and then
+* removing every string, repeated 100 times. The durations are for one repetition.
+*/
+template <typename Tree>
+void timeOperations(const vector<string>& strings, double& insertDuration, double& findDuration, double& removeDuration) {
+    insertDuration = 0;
+    findDuration = 0;
+    removeDuration = 0;
+
+    // Keeps the finds from being optimized away
+    int found = 0;
+
+    for (int i = 0; i < 100; ++i) {
+    	Tree tree;
+
+    	clock_t start = clock();
+
+    	for (unsigned int j = 0; j < strings.size(); ++j) {
+    		tree.insert(make_pair(strings[j], 0));
+    	}
+
+    	insertDuration += (clock() - start) / (double) CLOCKS_PER_SEC;
+
+    	start = clock();
+
+    	for (unsigned int j = 0; j < strings.size(); ++j) {
+    		if (tree.find(strings[j]) != tree.end()) {
+    			++found;
+    		}
+    	}
+
+    	findDuration += (clock() - start) / (double) CLOCKS_PER_SEC;
+
+    	start = clock();
+
+    	for (unsigned int j = 0; j < strings.size(); ++j) {
+    		tree.remove(strings[j]);
+    	}
+
+    	removeDuration += (clock() - start) / (double) CLOCKS_PER_SEC;
+    }
+
+    if (found == 0) {
+    	cerr << "No strings were found." << endl;
+    }
+
+    insertDuration /= 100.0;
+    findDuration /= 100.0;
+    removeDuration /= 100.0;
+}
+
+/**
+* Inserts every string into an empty tree and then removes every string in a
+* shuffled order, and reports the average number of rotations per insert and per
+* remove, and the most rotations a single remove did. Removing in insertion order
+* makes AVL and weak AVL trees rotate the same way, so the order is shuffled, with
+* the same seed for every tree.
+*/
+template <typename Tree>
+void countRotations(const vector<string>& strings, double& insertRotations, double& removeRotations, long long& maxRemoveRotations) {
+    Tree tree;
+
+    for (unsigned int j = 0; j < strings.size(); ++j) {
+    	tree.insert(make_pair(strings[j], 0));
+    }
+
+    long long afterInserts = tree.rotations();
+
+    vector<string> removeOrder(strings);
+    mt19937 random(7);
+    shuffle(removeOrder.begin(), removeOrder.end(), random);
+
+    maxRemoveRotations = 0;
+
+    for (unsigned int j = 0; j < removeOrder.size(); ++j) {
+    	long long before = tree.rotations();
+
+    	tree.remove(removeOrder[j]);
+
+    	maxRemoveRotations = max(maxRemoveRotations, tree.rotations() - before);
+    }
+
+    insertRotations = afterInserts / (double) strings.size();
+    removeRotations = (tree.rotations() - afterInserts) / (double) strings.size();
+}
+
+/**
+* Builds one tree from the strings at even positions and one from the strings at
+* odd positions, then times merging the second into the first, repeated 100
+* times. The duration is for one merge.
+*/
+template <typename Tree>
+double timeUnion(const vector<string>& strings) {
+    double duration = 0;
+
+    for (int i = 0; i < 100; ++i) {
+    	Tree even;
+    	Tree odd;
+
+    	for (unsigned int j = 0; j < strings.size(); ++j) {
+    		if (j % 2 == 0) {
+    			even.insert(make_pair(strings[j], 0));
+    		}
+
+    		else {
+    			odd.insert(make_pair(strings[j], 1));
+    		}
+    	}
+
+    	clock_t start = clock();
+
+    	even.merge(odd);
+
+    	duration += (clock() - start) / (double) CLOCKS_PER_SEC;
+    }
+
+    return duration / 100.0;
+}
+
+/**
+* Times inserting the first count keys into an empty tree and then finding them in
+* a different random order, once. Unlike the string benchmarks this is run at sizes
+* where the tree no longer fits in cache, so one repetition is enough.
+*/
+template <typename Tree>
+void timeIntKeys(const vector<int>& keys, int count, const vector<int>& order, double& insertDuration, double& findDuration) {
+    Tree tree;
+
+    // Keeps the finds from being optimized away
+    int found = 0;
+
+    clock_t start = clock();
+
+    for (int j = 0; j < count; ++j) {
+    	tree.insert(make_pair(keys[j], j));
+    }
+
+    insertDuration = (clock() - start) / (double) CLOCKS_PER_SEC;
+
+    start = clock();
+
+    for (int j = 0; j < count; ++j) {
+    	if (tree.find(keys[order[j]]) != tree.end()) {
+    		++found;
+    	}
+    }
+
+    findDuration = (clock() - start) / (double) CLOCKS_PER_SEC;
+
+    if (found != count) {
+    	cerr << "Only " << found << " of " << count << " keys were found." << endl;
+    }
+}
+
+/**
+* Times one in-order pass over every item of a tree, summing the values.
+*/
+template <typename Tree>
+double timeScan(const Tree& tree) {
+    long long sum = 0;
+
+    clock_t start = clock();
+
+    for (typename Tree::const_iterator it = tree.begin(); it != tree.end(); ++it) {
+    	sum += it->second;
+    }
+
+    double duration = (clock() - start) / (double) CLOCKS_PER_SEC;
+
+    // Keeps the scan from being optimized away
+    if (sum == -1) {
+    	cerr << "Unexpected sum." << endl;
+    }
+
+    return duration;
+}
+
+/**
+* Builds an AVL tree from the first count keys, freezes it, and returns the lookup
+* throughput of the live tree and of the snapshot in millions of finds per second.
+* The keys are looked up in a different random order than they were inserted.
+*/
+void timeFrozenFinds(const vector<int>& keys, int count, const vector<int>& order, double& liveThroughput, double& frozenThroughput) {
+    AVLTree<int, int> tree;
+
+    for (int j = 0; j < count; ++j) {
+    	tree.insert(make_pair(keys[j], j));
+    }
+
+    EytzingerSnapshot<int, int> snapshot = tree.freeze();
+
+    // Keeps the finds from being optimized away
+    int found = 0;
+
+    clock_t start = clock();
+
+    for (int j = 0; j < count; ++j) {
+    	if (tree.find(keys[order[j]]) != tree.end()) {
+    		++found;
+    	}
+    }
+
+    liveThroughput = count / ((clock() - start) / (double) CLOCKS_PER_SEC) / 1e6;
+
+    start = clock();
+
+    for (int j = 0; j < count; ++j) {
+    	if (snapshot.find(keys[order[j]]) != snapshot.end()) {
+    		++found;
+    	}
+    }
+
+    frozenThroughput = count / ((clock() - start) / (double) CLOCKS_PER_SEC) / 1e6;
+
+    if (found != 2 * count) {
+    	cerr << "Only " << found << " of " << 2 * count << " keys were found." << endl;
+    }
+}
+
+/**
+* Times a scan of an AVL tree and returns it with the throughput of finding every
+* key in the given order, in millions of finds per second. Used to compare the
+* node layouts made by compact().
+*/
+void timeLayout(const AVLTree<int, int>& tree, const vector<int>& keys, const vector<int>& order, double& scanDuration, double& findThroughput) {
+    scanDuration = timeScan(tree);
+
+    // Keeps the finds from being optimized away
+    int found = 0;
+
+    clock_t start = clock();
+
+    for (unsigned int j = 0; j < order.size(); ++j) {
+    	if (tree.find(keys[order[j]]) != tree.end()) {
+    		++found;
+    	}
+    }
+
+    findThroughput = order.size() / ((clock() - start) / (double) CLOCKS_PER_SEC) / 1e6;
+
+    if (found != (int) order.size()) {
+    	cerr << "Only " << found << " of " << order.size() << " keys were found." << endl;
+    }
+}
+
+/**
+* Returns the throughput of looking every id up in a snapshot, in millions of finds
+* per second.
+*/
+template <typename Snapshot>
+double timeSnapshotFinds(const Snapshot& snapshot, const vector<unsigned long long>& ids, const vector<int>& order) {
+    // Keeps the finds from being optimized away
+    int found = 0;
+
+    clock_t start = clock();
+
+    for (unsigned int j = 0; j < ids.size(); ++j) {
+    	if (snapshot.find(ids[order[j]]) != snapshot.end()) {
+    		++found;
+    	}
+    }
+
+    double throughput = ids.size() / ((clock() - start) / (double) CLOCKS_PER_SEC) / 1e6;
+
+    if (found != (int) ids.size()) {
+    	cerr << "Only " << found << " of " << ids.size() << " ids were found." << endl;
+    }
+
+    return throughput;
+}
+
 int main(int argc, char* argv[]) {
     if (argc < 3) {
-        cerr << "Please provide an input and output file." << endl;
+        cerr << "Please provide an input and output file, and optionally the largest"
+        	<< " number of int keys to time the trees with." << endl;
         return 1;
     }
 
@@ -112,6 +402,286 @@ int main(int argc, char* argv[]) {
     splayDuration = totalDuration / 100.0;
 
 
+
+    // Sorted input analysis. Increasing keys take the append path of
+    // AVLTree::insert and are the worst case for a splay tree
+
+    vector<string> sortedStrings(strings);
+
+    sort(sortedStrings.begin(), sortedStrings.end());
+
+    // Remove duplicates so every insert is an append
+    sortedStrings.erase(unique(sortedStrings.begin(), sortedStrings.end()), sortedStrings.end());
+
+    i = 0;
+
+    double sortedAVLDuration;
+
+    // Start timing
+    start = clock();
+
+    // Repeat AVL insert algorithm 100 times on sorted input
+    while (i < 100) {
+    	AVLTree<string, int> avl;
+
+    	for (unsigned int j = 0; j < sortedStrings.size(); ++j) {
+    		avl.insert(make_pair(sortedStrings[j], 0));
+    	}
+
+    	++i;
+    }
+
+    // Duration for one repition of sorted AVL inserts
+    sortedAVLDuration = (clock() - start) / (double) CLOCKS_PER_SEC / 100.0;
+
+    i = 0;
+
+    double sortedAVLHintDuration;
+
+    // Start timing
+    start = clock();
+
+    // Repeat AVL insert algorithm 100 times on sorted input with begin() as the
+    // hint. For sorted input that hint is wrong after the second key, so this times
+    // the hint check followed by a search from the root, without the append path
+    while (i < 100) {
+    	AVLTree<string, int> avl;
+
+    	for (unsigned int j = 0; j < sortedStrings.size(); ++j) {
+    		avl.insert(avl.begin(), make_pair(sortedStrings[j], 0));
+    	}
+
+    	++i;
+    }
+
+    // Duration for one repition of sorted AVL inserts with the begin() hint
+    sortedAVLHintDuration = (clock() - start) / (double) CLOCKS_PER_SEC / 100.0;
+
+    i = 0;
+
+    double sortedSplayDuration;
+
+    // Start timing
+    start = clock();
+
+    // Repeat Splay insert algorithm 100 times on sorted input
+    while (i < 100) {
+    	SplayTree<string, int> splay;
+
+    	for (unsigned int j = 0; j < sortedStrings.size(); ++j) {
+    		splay.insert(make_pair(sortedStrings[j], 0));
+    	}
+
+    	++i;
+    }
+
+    // Duration for one repition of sorted Splay inserts
+    sortedSplayDuration = (clock() - start) / (double) CLOCKS_PER_SEC / 100.0;
+
+
+    // Insert, find and remove analysis for the three balanced trees
+
+    double avlInsert, avlFind, avlRemove;
+    double splayInsert, splayFind, splayRemove;
+    double rbInsert, rbFind, rbRemove;
+
+    timeOperations<AVLTree<string, int> >(strings, avlInsert, avlFind, avlRemove);
+    timeOperations<SplayTree<string, int> >(strings, splayInsert, splayFind, splayRemove);
+    timeOperations<RedBlackTree<string, int> >(strings, rbInsert, rbFind, rbRemove);
+
+    double wavlInsert, wavlFind, wavlRemove;
+
+    timeOperations<WAVLTree<string, int> >(strings, wavlInsert, wavlFind, wavlRemove);
+
+    double scapegoatInsert, scapegoatFind, scapegoatRemove;
+
+    timeOperations<ScapegoatTree<string, int> >(strings, scapegoatInsert, scapegoatFind, scapegoatRemove);
+
+    double treapInsert, treapFind, treapRemove;
+
+    timeOperations<Treap<string, int> >(strings, treapInsert, treapFind, treapRemove);
+
+    double artInsert, artFind, artRemove;
+
+    timeOperations<AdaptiveRadixTree<string, int> >(strings, artInsert, artFind, artRemove);
+
+
+    // Set union analysis for the trees that can merge
+
+    double avlUnion = timeUnion<AVLTree<string, int> >(strings);
+    double treapUnion = timeUnion<Treap<string, int> >(strings);
+
+
+    // Rotations per operation for the AVL and weak AVL trees
+
+    double avlInsertRotations, avlRemoveRotations;
+    double wavlInsertRotations, wavlRemoveRotations;
+    long long avlMaxRemoveRotations, wavlMaxRemoveRotations;
+
+    countRotations<AVLTree<string, int> >(strings, avlInsertRotations, avlRemoveRotations, avlMaxRemoveRotations);
+    countRotations<WAVLTree<string, int> >(strings, wavlInsertRotations, wavlRemoveRotations, wavlMaxRemoveRotations);
+
+
+    // AVL, splay, B+ and radix trees with int keys, at sizes up to argv[3] (default one million).
+    // Each size is ten times the last, so the largest sizes outgrow the caches:
+    // pass a size well past the last level cache to see the B+ tree's advantage.
+
+    int maxKeys = (argc > 3) ? atoi(argv[3]) : 1000000;
+
+    mt19937 random(42);
+    vector<int> keys(maxKeys);
+    vector<int> order(maxKeys);
+
+    for (int j = 0; j < maxKeys; ++j) {
+    	keys[j] = static_cast<int>(random());
+    	order[j] = j;
+    }
+
+    vector<int> sizes;
+    vector<double> avlIntInsert, avlIntFind;
+    vector<double> splayIntInsert, splayIntFind;
+    vector<double> bplusIntInsert, bplusIntFind;
+    vector<double> artIntInsert, artIntFind;
+    vector<double> bucketIntInsert, bucketIntFind;
+    vector<double> liveThroughput, frozenThroughput;
+
+    for (int count = 10000; count <= maxKeys; count *= 10) {
+    	// Look the keys up in a different order than they were inserted
+    	shuffle(order.begin(), order.begin() + count, random);
+
+    	double insertDuration, findDuration;
+
+    	sizes.push_back(count);
+
+    	timeIntKeys<AVLTree<int, int> >(keys, count, order, insertDuration, findDuration);
+    	avlIntInsert.push_back(insertDuration);
+    	avlIntFind.push_back(findDuration);
+
+    	timeIntKeys<SplayTree<int, int> >(keys, count, order, insertDuration, findDuration);
+    	splayIntInsert.push_back(insertDuration);
+    	splayIntFind.push_back(findDuration);
+
+    	timeIntKeys<BPlusTree<int, int> >(keys, count, order, insertDuration, findDuration);
+    	bplusIntInsert.push_back(insertDuration);
+    	bplusIntFind.push_back(findDuration);
+
+    	timeIntKeys<AdaptiveRadixTree<int, int> >(keys, count, order, insertDuration, findDuration);
+    	artIntInsert.push_back(insertDuration);
+    	artIntFind.push_back(findDuration);
+
+    	timeIntKeys<BucketedAVLTree<int, int> >(keys, count, order, insertDuration, findDuration);
+    	bucketIntInsert.push_back(insertDuration);
+    	bucketIntFind.push_back(findDuration);
+
+    	double live, frozen;
+
+    	timeFrozenFinds(keys, count, order, live, frozen);
+    	liveThroughput.push_back(live);
+    	frozenThroughput.push_back(frozen);
+    }
+
+
+    // Scan time and memory of the AVL tree and the bucketed hybrid at the
+    // largest size
+
+    AVLTree<int, int> scanAVL;
+    ThreadedAVLTree<int, int> scanThreaded;
+    BucketedAVLTree<int, int> scanBucketed;
+
+    for (int j = 0; j < maxKeys; ++j) {
+    	scanAVL.insert(make_pair(keys[j], j));
+    	scanThreaded.insert(make_pair(keys[j], j));
+    	scanBucketed.insert(make_pair(keys[j], j));
+    }
+
+    double avlScan = timeScan(scanAVL);
+    double threadedScan = timeScan(scanThreaded);
+    double bucketedScan = timeScan(scanBucketed);
+
+    double avlBytesPerKey = sizeof(AVLNode<int, int>);
+    double threadedBytesPerKey = sizeof(ThreadedAVLNode<int, int>);
+    double bucketedBytesPerKey = scanBucketed.memoryUsage() / (double) scanBucketed.size();
+
+
+    // The scan AVL tree was built from random keys, so its nodes lie in memory in
+    // insertion order rather than key order. Scan and lookup times as built and
+    // after compacting it into each layout.
+
+    shuffle(order.begin(), order.end(), random);
+
+    double scatteredScan, scatteredFind;
+    timeLayout(scanAVL, keys, order, scatteredScan, scatteredFind);
+
+    scanAVL.compact(AVLTree<int, int>::IN_ORDER);
+
+    double inOrderScan, inOrderFind;
+    timeLayout(scanAVL, keys, order, inOrderScan, inOrderFind);
+
+    scanAVL.compact(AVLTree<int, int>::VAN_EMDE_BOAS);
+
+    double vebScan, vebFind;
+    timeLayout(scanAVL, keys, order, vebScan, vebFind);
+
+    // Learned index on a dense id space: increasing ids with gaps of 1 to 4.
+    // Build time and lookup throughput for several error bounds, against the live
+    // tree, the Eytzinger snapshot and a binary search of the sorted ids.
+
+    int idCount = min(maxKeys, 1000000);
+
+    vector<unsigned long long> ids(idCount);
+    vector<int> idOrder(idCount);
+
+    unsigned long long nextId = 0;
+
+    for (int j = 0; j < idCount; ++j) {
+    	nextId += 1 + random() % 4;
+    	ids[j] = nextId;
+    	idOrder[j] = j;
+    }
+
+    shuffle(idOrder.begin(), idOrder.end(), random);
+
+    AVLTree<unsigned long long, int> idTree;
+
+    for (int j = 0; j < idCount; ++j) {
+    	idTree.push_back(make_pair(ids[j], j));
+    }
+
+    double idTreeThroughput = timeSnapshotFinds(idTree, ids, idOrder);
+    double idEytzingerThroughput = timeSnapshotFinds(idTree.freeze(), ids, idOrder);
+
+    // Binary search of the sorted ids
+    int binaryFound = 0;
+
+    start = clock();
+
+    for (int j = 0; j < idCount; ++j) {
+    	if (binary_search(ids.begin(), ids.end(), ids[idOrder[j]])) {
+    		++binaryFound;
+    	}
+    }
+
+    double idBinaryThroughput = idCount / ((clock() - start) / (double) CLOCKS_PER_SEC) / 1e6;
+
+    if (binaryFound != idCount) {
+    	cerr << "Binary search missed ids." << endl;
+    }
+
+    int epsilons[] = { 4, 16, 64, 256 };
+    vector<double> learnedBuild, learnedThroughput;
+    vector<int> learnedSegments;
+
+    for (int j = 0; j < 4; ++j) {
+    	start = clock();
+
+    	LearnedIndexSnapshot<unsigned long long, int> learned = idTree.freezeLearned(epsilons[j]);
+
+    	learnedBuild.push_back((clock() - start) / (double) CLOCKS_PER_SEC);
+    	learnedSegments.push_back(learned.segments());
+    	learnedThroughput.push_back(timeSnapshotFinds(learned, ids, idOrder));
+    }
+
+
     // Write to output file
 
     ofstream output(argv[2]);
@@ -124,6 +694,107 @@ int main(int argc, char* argv[]) {
 
     output << "Splay expensive: " << badInserts << endl;
 
+    output << sortedStrings.size() << " sorted insertions" << endl;
+
+    output << "AVL append: " << sortedAVLDuration << " seconds" << endl;
+
+    output << "AVL insert(begin(), item), wrong hint: " << sortedAVLHintDuration << " seconds" << endl;
+
+    output << "Splay: " << sortedSplayDuration << " seconds" << endl;
+
+    output << "Insert / find / remove" << endl;
+
+    output << "AVL: " << avlInsert << " / " << avlFind << " / " << avlRemove << " seconds" << endl;
+
+    output << "Splay: " << splayInsert << " / " << splayFind << " / " << splayRemove << " seconds" << endl;
+
+    output << "Red-black: " << rbInsert << " / " << rbFind << " / " << rbRemove << " seconds" << endl;
+
+    output << "Weak AVL: " << wavlInsert << " / " << wavlFind << " / " << wavlRemove << " seconds" << endl;
+
+    output << "Scapegoat: " << scapegoatInsert << " / " << scapegoatFind << " / " << scapegoatRemove << " seconds" << endl;
+
+    output << "Treap: " << treapInsert << " / " << treapFind << " / " << treapRemove << " seconds" << endl;
+
+    output << "Radix: " << artInsert << " / " << artFind << " / " << artRemove << " seconds" << endl;
+
+    output << "Union of two halves" << endl;
+
+    output << "AVL: " << avlUnion << " seconds" << endl;
+
+    output << "Treap: " << treapUnion << " seconds" << endl;
+
+    output << "Rotations per insert / remove (shuffled) / most in one remove" << endl;
+
+    output << "AVL: " << avlInsertRotations << " / " << avlRemoveRotations << " / " << avlMaxRemoveRotations << endl;
+
+    output << "Weak AVL: " << wavlInsertRotations << " / " << wavlRemoveRotations << " / " << wavlMaxRemoveRotations << endl;
+
+    // Node sizes for string keys and int values, not counting heap allocator overhead
+    output << "Bytes per node" << endl;
+
+    output << "AVL: " << sizeof(AVLNode<string, int>) << endl;
+
+    output << "Threaded AVL: " << sizeof(ThreadedAVLNode<string, int>) << endl;
+
+    output << "Red-black: " << sizeof(RBNode<string, int>) << endl;
+
+    output << "Weak AVL: " << sizeof(WAVLNode<string, int>) << endl;
+
+    output << "Treap: " << sizeof(TreapNode<string, int>) << endl;
+
+    output << "Scapegoat / Splay: " << sizeof(Node<string, int>) << endl;
+
+    output << "Int keys insert / find" << endl;
+
+    for (unsigned int j = 0; j < sizes.size(); ++j) {
+    	output << sizes[j] << " AVL: " << avlIntInsert[j] << " / " << avlIntFind[j] << " seconds" << endl;
+
+    	output << sizes[j] << " Splay: " << splayIntInsert[j] << " / " << splayIntFind[j] << " seconds" << endl;
+
+    	output << sizes[j] << " B+: " << bplusIntInsert[j] << " / " << bplusIntFind[j] << " seconds" << endl;
+
+    	output << sizes[j] << " Radix: " << artIntInsert[j] << " / " << artIntFind[j] << " seconds" << endl;
+
+    	output << sizes[j] << " Bucketed AVL: " << bucketIntInsert[j] << " / " << bucketIntFind[j] << " seconds" << endl;
+    }
+
+    output << "Scan of " << scanAVL.size() << " int keys: seconds / bytes per key" << endl;
+
+    output << "AVL: " << avlScan << " / " << avlBytesPerKey << endl;
+
+    output << "Threaded AVL: " << threadedScan << " / " << threadedBytesPerKey << endl;
+
+    output << "Bucketed AVL: " << bucketedScan << " / " << bucketedBytesPerKey << endl;
+
+    output << "AVL node layout: scan seconds / lookups per second" << endl;
+
+    output << "As inserted: " << scatteredScan << " / " << scatteredFind << " million" << endl;
+
+    output << "Compacted in order: " << inOrderScan << " / " << inOrderFind << " million" << endl;
+
+    output << "Compacted van Emde Boas: " << vebScan << " / " << vebFind << " million" << endl;
+
+    output << "Lookups per second, live AVL / frozen snapshot" << endl;
+
+    for (unsigned int j = 0; j < sizes.size(); ++j) {
+    	output << sizes[j] << ": " << liveThroughput[j] << " / " << frozenThroughput[j] << " million" << endl;
+    }
+
+    output << idCount << " dense ids, lookups per second" << endl;
+
+    output << "Live AVL: " << idTreeThroughput << " million" << endl;
+
+    output << "Eytzinger: " << idEytzingerThroughput << " million" << endl;
+
+    output << "Binary search: " << idBinaryThroughput << " million" << endl;
+
+    output << "Learned index, epsilon: build seconds / segments / lookups per second" << endl;
+
+    for (int j = 0; j < 4; ++j) {
+    	output << epsilons[j] << ": " << learnedBuild[j] << " / " << learnedSegments[j] << " / " << learnedThroughput[j] << " million" << endl;
+    }
+
     input.close();
 
     output.close();
@@ -0,0 +1,1836 @@
+#ifndef ART_H
+#define ART_H
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+* The bytes of a key as the radix tree sees them. Comparing two keys' bytes in
+* lexicographic order gives the same order as comparing the keys. This version is
+* for integer keys, which are stored big-endian with the sign bit flipped so that
+* negative numbers sort first.
+*/
+template <typename Key>
+class RadixKey
+{
+	static_assert(std::is_integral<Key>::value, "AdaptiveRadixTree keys must be integers or std::string");
+
+public:
+	explicit RadixKey(const Key& key);
+
+	const unsigned char* data() const;
+	int size() const;
+
+private:
+	unsigned char mBytes[sizeof(Key)];
+};
+
+/**
+* The bytes of a string key, which are the characters themselves. Nothing is copied.
+*/
+template <>
+class RadixKey<std::string>
+{
+public:
+	explicit RadixKey(const std::string& key);
+
+	const unsigned char* data() const;
+	int size() const;
+
+private:
+	const std::string& mKey;
+};
+
+/*
+--------------------------------------------
+Begin implementations for the RadixKey class.
+--------------------------------------------
+*/
+
+/**
+* Writes the key most significant byte first, flipping the sign bit of signed types.
+*/
+template<typename Key>
+RadixKey<Key>::RadixKey(const Key& key)
+{
+	typedef typename std::make_unsigned<Key>::type Bits;
+
+	Bits bits = static_cast<Bits>(key);
+
+	// Move negative numbers below positive ones
+	if (std::is_signed<Key>::value) {
+		bits ^= static_cast<Bits>(Bits(1) << (8 * sizeof(Key) - 1));
+	}
+
+	for (int i = sizeof(Key) - 1; i >= 0; --i) {
+		mBytes[i] = static_cast<unsigned char>(bits & 0xFF);
+		bits = static_cast<Bits>(bits >> 8);
+	}
+}
+
+template<typename Key>
+const unsigned char* RadixKey<Key>::data() const
+{
+	return mBytes;
+}
+
+template<typename Key>
+int RadixKey<Key>::size() const
+{
+	return sizeof(Key);
+}
+
+inline RadixKey<std::string>::RadixKey(const std::string& key)
+	: mKey(key)
+{
+
+}
+
+inline const unsigned char* RadixKey<std::string>::data() const
+{
+	return reinterpret_cast<const unsigned char*>(mKey.data());
+}
+
+inline int RadixKey<std::string>::size() const
+{
+	return static_cast<int>(mKey.size());
+}
+
+/*
+------------------------------------------
+End implementations for the RadixKey class.
+------------------------------------------
+*/
+
+/**
+* A templated ordered map implemented as an adaptive radix tree, with the same
+* insert/find/remove and in-order iterator interface as BinarySearchTree. Keys are
+* integers or strings (see RadixKey). Instead of comparing whole keys at every level,
+* the tree branches on one byte of the key per level, so a lookup costs O(key length)
+* no matter how many items there are. Inner nodes come in four sizes (4, 16, 48 and
+* 256 children) and grow or shrink as children are added or removed, and chains of
+* single-child nodes are stored as one node with a prefix, which keeps the tree small
+* for sparse keys. Every item lives in a leaf, and the leaves are linked in key order
+* for iteration.
+*/
+template <class Key, class Value>
+class AdaptiveRadixTree
+{
+private:
+	struct RadixLeaf;
+
+public:
+	AdaptiveRadixTree();
+	~AdaptiveRadixTree();
+
+	// Copies insert every item of other. Moves take over the nodes in O(1) and
+	// leave the source empty.
+	AdaptiveRadixTree(const AdaptiveRadixTree<Key, Value>& other);
+	AdaptiveRadixTree(AdaptiveRadixTree<Key, Value>&& other) noexcept;
+	AdaptiveRadixTree<Key, Value>& operator=(const AdaptiveRadixTree<Key, Value>& other);
+	AdaptiveRadixTree<Key, Value>& operator=(AdaptiveRadixTree<Key, Value>&& other) noexcept;
+
+	// Methods for inserting/removing elements from the tree. A duplicate key updates
+	// the value, and removing a missing key does nothing.
+	void insert(const std::pair<Key, Value>& keyValuePair);
+	void remove(const Key& key);
+	void clear();
+
+	// Returns the number of items in O(1)
+	int size() const;
+	bool empty() const;
+
+	/**
+	* An iterator over the items in key order. It walks the linked leaves, so ++
+	* and -- are O(1).
+	*/
+	class iterator
+	{
+	public:
+		typedef std::bidirectional_iterator_tag iterator_category;
+		typedef std::pair<Key, Value> value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef std::pair<Key, Value>* pointer;
+		typedef std::pair<Key, Value>& reference;
+
+		iterator();
+		iterator(RadixLeaf* leaf, const AdaptiveRadixTree<Key, Value>* tree);
+
+		std::pair<Key, Value>& operator*() const;
+		std::pair<Key, Value>* operator->() const;
+
+		bool operator==(const iterator& rhs) const;
+		bool operator!=(const iterator& rhs) const;
+
+		iterator& operator++();
+		iterator operator++(int);
+		iterator& operator--();
+		iterator operator--(int);
+
+	protected:
+		RadixLeaf* mCurrent;
+		const AdaptiveRadixTree<Key, Value>* mTree;
+
+		friend class AdaptiveRadixTree<Key, Value>;
+	};
+
+	/**
+	* The same as iterator, but only gives read access to the items. An iterator
+	* converts to a const_iterator.
+	*/
+	class const_iterator
+	{
+	public:
+		typedef std::bidirectional_iterator_tag iterator_category;
+		typedef std::pair<Key, Value> value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const std::pair<Key, Value>* pointer;
+		typedef const std::pair<Key, Value>& reference;
+
+		const_iterator();
+		const_iterator(RadixLeaf* leaf, const AdaptiveRadixTree<Key, Value>* tree);
+		const_iterator(const iterator& other);
+
+		const std::pair<Key, Value>& operator*() const;
+		const std::pair<Key, Value>* operator->() const;
+
+		bool operator==(const const_iterator& rhs) const;
+		bool operator!=(const const_iterator& rhs) const;
+
+		const_iterator& operator++();
+		const_iterator operator++(int);
+		const_iterator& operator--();
+		const_iterator operator--(int);
+
+	protected:
+		iterator mIterator;
+	};
+
+	iterator begin();
+	iterator end();
+	const_iterator begin() const;
+	const_iterator end() const;
+
+	iterator find(const Key& key);
+	const_iterator find(const Key& key) const;
+
+	// First item with key >= key, or end() if there is none
+	iterator lower_bound(const Key& key);
+	const_iterator lower_bound(const Key& key) const;
+
+private:
+	enum NodeType { LEAF, NODE4, NODE16, NODE48, NODE256 };
+
+	struct RadixNode
+	{
+		NodeType mType;
+	};
+
+	struct RadixLeaf : public RadixNode
+	{
+		std::pair<Key, Value> mItem;
+		RadixLeaf* mPrev;
+		RadixLeaf* mNext;
+	};
+
+	// Prefix bytes stored in an inner node. 12 fills the node header up to the
+	// terminal pointer, and covers every prefix of an integer key.
+	static const int MaxPrefix = 12;
+
+	// The part shared by the inner nodes. The prefix is the mPrefixLength key bytes
+	// that every item below the node shares after the node's parent, of which only
+	// the first MaxPrefix are kept in mPrefix. Searches for one key skip the rest
+	// and rely on the check of the whole key at the leaf; anything that needs the
+	// rest reads it from a leaf below the node. mTerminal holds the item whose key
+	// ends right after the prefix, if any (only string keys can have one key be a
+	// prefix of another).
+	struct InnerNode : public RadixNode
+	{
+		int mCount;
+		int mPrefixLength;
+		unsigned char mPrefix[MaxPrefix];
+		RadixLeaf* mTerminal;
+	};
+
+	// Up to 4 or 16 children, with their key bytes in sorted order
+	struct Node4 : public InnerNode
+	{
+		unsigned char mKeys[4];
+		RadixNode* mChildren[4];
+	};
+
+	struct Node16 : public InnerNode
+	{
+		unsigned char mKeys[16];
+		RadixNode* mChildren[16];
+	};
+
+	// Up to 48 children. mChildIndex maps a key byte to 1 + its slot in mChildren,
+	// or 0 if there is no such child.
+	struct Node48 : public InnerNode
+	{
+		unsigned char mChildIndex[256];
+		RadixNode* mChildren[48];
+	};
+
+	// One slot for every key byte
+	struct Node256 : public InnerNode
+	{
+		RadixNode* mChildren[256];
+	};
+
+	// Compares two keys' bytes lexicographically, returning <0, 0 or >0
+	static int compareBytes(const RadixKey<Key>& a, const RadixKey<Key>& b);
+
+	// Allocate/free single nodes. deleteNode does not free an inner node's children.
+	static RadixLeaf* createLeaf(const std::pair<Key, Value>& keyValuePair);
+	static InnerNode* createInner(NodeType type);
+	static void deleteNode(RadixNode* node);
+	static void deleteSubtree(RadixNode* node);
+
+	// Child access for every kind of inner node. findChild returns the slot holding
+	// the child for a key byte, or NULL if there is none.
+	static RadixNode** findChild(InnerNode* node, unsigned char byte);
+	static RadixNode* firstChild(const InnerNode* node);
+	static RadixNode* childAfter(const InnerNode* node, unsigned char byte);
+	static int getChildren(const InnerNode* node, unsigned char* bytes, RadixNode** children);
+
+	// Add/remove a child of the inner node held in ref, replacing it with a larger
+	// or smaller kind of node when needed
+	static void addChild(RadixNode*& ref, unsigned char byte, RadixNode* child);
+	static void removeChild(RadixNode*& ref, unsigned char byte);
+
+	// Copies node's prefix, terminal and children into a new node of another kind
+	static InnerNode* resize(InnerNode* node, NodeType type);
+
+	// Sets node's prefix to the length bytes at bytes
+	static void setPrefix(InnerNode* node, const unsigned char* bytes, int length);
+
+	// Returns byte i of node's prefix, which starts at depth in the keys below it.
+	// Bytes past MaxPrefix are read from source, a leaf below the node, which may
+	// be NULL for a prefix that is stored whole.
+	static unsigned char prefixByte(const InnerNode* node, const RadixLeaf* source, int depth, int i);
+
+	// Returns true if the key bytes at depth start with the stored part of node's
+	// prefix and are long enough for the whole prefix
+	static bool prefixMatches(const InnerNode* node, const RadixKey<Key>& bytes, int depth);
+
+	// Adds a child to a node that has room for it
+	static void addChildInPlace(InnerNode* node, unsigned char byte, RadixNode* child);
+
+	// Replaces an inner node that no longer needs to branch with its only item or child
+	static void collapse(RadixNode*& ref);
+
+	// Returns the smallest leaf in a subtree
+	static RadixLeaf* minimum(RadixNode* node);
+
+	// Returns the first leaf with a key greater than (or equal to, if inclusive) key,
+	// or NULL if there is none
+	RadixLeaf* internalCeiling(const RadixKey<Key>& key, bool inclusive) const;
+
+	RadixLeaf* internalFind(const Key& key) const;
+
+	// Links a new leaf into the list of leaves in key order
+	void linkLeaf(RadixLeaf* leaf);
+	void unlinkLeaf(RadixLeaf* leaf);
+
+	RadixNode* mRoot;
+	RadixLeaf* mFirst;
+	RadixLeaf* mLast;
+	int mSize;
+};
+
+/*
+	---------------------------------------------------------------
+	Begin implementations for the AdaptiveRadixTree::iterator class.
+	---------------------------------------------------------------
+*/
+
+/**
+* A default constructor that initializes the iterator to NULL.
+*/
+template<typename Key, typename Value>
+AdaptiveRadixTree<Key, Value>::iterator::iterator()
+	: mCurrent(NULL)
+	, mTree(NULL)
+{
+
+}
+
+/**
+* Constructor that initializes an iterator with a leaf and the tree it belongs to.
+*/
+template<typename Key, typename Value>
+AdaptiveRadixTree<Key, Value>::iterator::iterator(RadixLeaf* leaf, const AdaptiveRadixTree<Key, Value>* tree)
+	: mCurrent(leaf)
+	, mTree(tree)
+{
+
+}
+
+/**
+* Provides access to the item.
+*/
+template<typename Key, typename Value>
+std::pair<Key, Value>& AdaptiveRadixTree<Key, Value>::iterator::operator*() const
+{
+	return mCurrent->mItem;
+}
+
+/**
+* Provides access to the address of the item.
+*/
+template<typename Key, typename Value>
+std::pair<Key, Value>* AdaptiveRadixTree<Key, Value>::iterator::operator->() const
+{
+	return &(mCurrent->mItem);
+}
+
+/**
+* Checks if 'this' iterator points at the same item as 'rhs'.
+*/
+template<typename Key, typename Value>
+bool AdaptiveRadixTree<Key, Value>::iterator::operator==(const iterator& rhs) const
+{
+	return mCurrent == rhs.mCurrent;
+}
+
+/**
+* Checks if 'this' iterator points at a different item than 'rhs'.
+*/
+template<typename Key, typename Value>
+bool AdaptiveRadixTree<Key, Value>::iterator::operator!=(const iterator& rhs) const
+{
+	return mCurrent != rhs.mCurrent;
+}
+
+/**
+* Advances the iterator to the next leaf.
+*/
+template<typename Key, typename Value>
+typename AdaptiveRadixTree<Key, Value>::iterator& AdaptiveRadixTree<Key, Value>::iterator::operator++()
+{
+	mCurrent = mCurrent->mNext;
+	return *this;
+}
+
+/**
+* Post-increment.
+*/
+template<typename Key, typename Value>
+typename AdaptiveRadixTree<Key, Value>::iterator AdaptiveRadixTree<Key, Value>::iterator::operator++(int)
+{
+	iterator copy(*this);
+	++(*this);
+	return copy;
+}
+
+/**
+* Moves the iterator to the previous leaf. Decrementing end() moves to the last item.
+*/
+template<typename Key, typename Value>
+typename AdaptiveRadixTree<Key, Value>::iterator& AdaptiveRadixTree<Key, Value>::iterator::operator--()
+{
+	mCurrent = (mCurrent == NULL) ? mTree->mLast : mCurrent->mPrev;
+	return *this;
+}
+
+/**
+* Post-decrement.
+*/
+template<typename Key, typename Value>
+typename AdaptiveRadixTree<Key, Value>::iterator AdaptiveRadixTree<Key, Value>::iterator::operator--(int)
+{
+	iterator copy(*this);
+	--(*this);
+	return copy;
+}
+
+/*
+	-------------------------------------------------------------
+	End implementations for the AdaptiveRadixTree::iterator class.
+	-------------------------------------------------------------
+*/
+
+/*
+	---------------------------------------------------------------------
+	Begin implementations for the AdaptiveRadixTree::const_iterator class.
+	---------------------------------------------------------------------
+*/
+
+/**
+* A default constructor that initializes the iterator to NULL.
+*/
+template<typename Key, typename Value>
+AdaptiveRadixTree<Key, Value>::const_iterator::const_iterator()
+{
+
+}
+
+/**
+* Constructor that initializes an iterator with a leaf and the tree it belongs to.
+*/
+template<typename Key, typename Value>
+AdaptiveRadixTree<Key, Value>::const_iterator::const_iterator(RadixLeaf* leaf, const AdaptiveRadixTree<Key, Value>* tree)
+	: mIterator(leaf, tree)
+{
+
+}
+
+/**
+* Converts an iterator to a const_iterator.
+*/
+template<typename Key, typename Value>
+AdaptiveRadixTree<Key, Value>::const_iterator::const_iterator(const iterator& other)
+	: mIterator(other)
+{
+
+}
+
+/**
+* Provides read access to the item.
+*/
+template<typename Key, typename Value>
+const std::pair<Key, Value>& AdaptiveRadixTree<Key, Value>::const_iterator::operator*() const
+{
+	return *mIterator;
+}
+
+/**
+* Provides read access to the address of the item.
+*/
+template<typename Key, typename Value>
+const std::pair<Key, Value>* AdaptiveRadixTree<Key, Value>::const_iterator::operator->() const
+{
+	return mIterator.operator->();
+}
+
+/**
+* Checks if 'this' iterator points at the same item as 'rhs'.
+*/
+template<typename Key, typename Value>
+bool AdaptiveRadixTree<Key, Value>::const_iterator::operator==(const const_iterator& rhs) const
+{
+	return mIterator == rhs.mIterator;
+}
+
+/**
+* Checks if 'this' iterator points at a different item than 'rhs'.
+*/
+template<typename Key, typename Value>
+bool AdaptiveRadixTree<Key, Value>::const_iterator::operator!=(const const_iterator& rhs) const
+{
+	return mIterator != rhs.mIterator;
+}
+
+/**
+* Advances the iterator to the next leaf.
+*/
+template<typename Key, typename Value>
+typename AdaptiveRadixTree<Key, Value>::const_iterator& AdaptiveRadixTree<Key, Value>::const_iterator::operator++()
+{
+	++mIterator;
+	return *this;
+}
+
+/**
+* Post-increment.
+*/
+template<typename Key, typename Value>
+typename AdaptiveRadixTree<Key, Value>::const_iterator AdaptiveRadixTree<Key, Value>::const_iterator::operator++(int)
+{
+	const_iterator copy(*this);
+	++mIterator;
+	return copy;
+}
+
+/**
+* Moves the iterator to the previous leaf. Decrementing end() moves to the last item.
+*/
+template<typename Key, typename Value>
+typename AdaptiveRadixTree<Key, Value>::const_iterator& AdaptiveRadixTree<Key, Value>::const_iterator::operator--()
+{
+	--mIterator;
+	return *this;
+}
+
+/**
+* Post-decrement.
+*/
+template<typename Key, typename Value>
+typename AdaptiveRadixTree<Key, Value>::const_iterator AdaptiveRadixTree<Key, Value>::const_iterator::operator--(int)
+{
+	const_iterator copy(*this);
+	--mIterator;
+	return copy;
+}
+
+/*
+	-------------------------------------------------------------------
+	End implementations for the AdaptiveRadixTree::const_iterator class.
+	-------------------------------------------------------------------
+*/
+
+/*
+--------------------------------------------
+Begin implementations for the AdaptiveRadixTree class.
+--------------------------------------------
+*/
+
+/**
+* Default constructor for an AdaptiveRadixTree, which sets the root to NULL.
+*/
+template<typename Key, typename Value>
+AdaptiveRadixTree<Key, Value>::AdaptiveRadixTree()
+	: mRoot(NULL)
+	, mFirst(NULL)
+	, mLast(NULL)
+	, mSize(0)
+{
+
+}
+
+template<typename Key, typename Value>
+AdaptiveRadixTree<Key, Value>::~AdaptiveRadixTree()
+{
+	clear();
+}
+
+/**
+* Copy constructor. Inserts every item of other in order.
+*/
+template<typename Key, typename Value>
+AdaptiveRadixTree<Key, Value>::AdaptiveRadixTree(const AdaptiveRadixTree<Key, Value>& other)
+	: mRoot(NULL)
+	, mFirst(NULL)
+	, mLast(NULL)
+	, mSize(0)
+{
+	*this = other;
+}
+
+/**
+* Move constructor. Takes over other's nodes and leaves other empty.
+*/
+template<typename Key, typename Value>
+AdaptiveRadixTree<Key, Value>::AdaptiveRadixTree(AdaptiveRadixTree<Key, Value>&& other) noexcept
+	: mRoot(other.mRoot)
+	, mFirst(other.mFirst)
+	, mLast(other.mLast)
+	, mSize(other.mSize)
+{
+	other.mRoot = NULL;
+	other.mFirst = NULL;
+	other.mLast = NULL;
+	other.mSize = 0;
+}
+
+/**
+* Copy assignment. Frees this tree's nodes and inserts every item of other.
+*/
+template<typename Key, typename Value>
+AdaptiveRadixTree<Key, Value>& AdaptiveRadixTree<Key, Value>::operator=(const AdaptiveRadixTree<Key, Value>& other)
+{
+	// Self assignment
+	if (this == &other) {
+		return *this;
+	}
+
+	clear();
+
+	for (RadixLeaf* leaf = other.mFirst; leaf != NULL; leaf = leaf->mNext) {
+		insert(leaf->mItem);
+	}
+
+	return *this;
+}
+
+/**
+* Move assignment. Frees this tree's nodes, takes over other's and leaves other empty.
+*/
+template<typename Key, typename Value>
+AdaptiveRadixTree<Key, Value>& AdaptiveRadixTree<Key, Value>::operator=(AdaptiveRadixTree<Key, Value>&& other) noexcept
+{
+	// Self assignment
+	if (this == &other) {
+		return *this;
+	}
+
+	clear();
+
+	mRoot = other.mRoot;
+	mFirst = other.mFirst;
+	mLast = other.mLast;
+	mSize = other.mSize;
+
+	other.mRoot = NULL;
+	other.mFirst = NULL;
+	other.mLast = NULL;
+	other.mSize = 0;
+
+	return *this;
+}
+
+/**
+* Returns the number of items in O(1).
+*/
+template<typename Key, typename Value>
+int AdaptiveRadixTree<Key, Value>::size() const
+{
+	return mSize;
+}
+
+/**
+* Returns true if the tree holds no items.
+*/
+template<typename Key, typename Value>
+bool AdaptiveRadixTree<Key, Value>::empty() const
+{
+	return mSize == 0;
+}
+
+/**
+* Deletes all nodes inside the tree, resetting it to the empty tree.
+*/
+template<typename Key, typename Value>
+void AdaptiveRadixTree<Key, Value>::clear()
+{
+	if (mRoot != NULL) {
+		deleteSubtree(mRoot);
+	}
+
+	mRoot = NULL;
+	mFirst = NULL;
+	mLast = NULL;
+	mSize = 0;
+}
+
+/**
+* Returns an iterator to the smallest item.
+*/
+template<typename Key, typename Value>
+typename AdaptiveRadixTree<Key, Value>::iterator AdaptiveRadixTree<Key, Value>::begin()
+{
+	return iterator(mFirst, this);
+}
+
+/**
+* Returns an iterator past the largest item.
+*/
+template<typename Key, typename Value>
+typename AdaptiveRadixTree<Key, Value>::iterator AdaptiveRadixTree<Key, Value>::end()
+{
+	return iterator(NULL, this);
+}
+
+/**
+* Returns a const_iterator to the smallest item.
+*/
+template<typename Key, typename Value>
+typename AdaptiveRadixTree<Key, Value>::const_iterator AdaptiveRadixTree<Key, Value>::begin() const
+{
+	return const_iterator(mFirst, this);
+}
+
+/**
+* Returns a const_iterator past the largest item.
+*/
+template<typename Key, typename Value>
+typename AdaptiveRadixTree<Key, Value>::const_iterator AdaptiveRadixTree<Key, Value>::end() const
+{
+	return const_iterator(NULL, this);
+}
+
+/**
+* Returns an iterator to the item with the given key, or end() if it is not in
+* the tree.
+*/
+template<typename Key, typename Value>
+typename AdaptiveRadixTree<Key, Value>::iterator AdaptiveRadixTree<Key, Value>::find(const Key& key)
+{
+	return iterator(internalFind(key), this);
+}
+
+/**
+* Const version of find.
+*/
+template<typename Key, typename Value>
+typename AdaptiveRadixTree<Key, Value>::const_iterator AdaptiveRadixTree<Key, Value>::find(const Key& key) const
+{
+	return const_iterator(internalFind(key), this);
+}
+
+/**
+* Returns an iterator to the first item with a key >= key.
+*/
+template<typename Key, typename Value>
+typename AdaptiveRadixTree<Key, Value>::iterator AdaptiveRadixTree<Key, Value>::lower_bound(const Key& key)
+{
+	return iterator(internalCeiling(RadixKey<Key>(key), true), this);
+}
+
+/**
+* Const version of lower_bound.
+*/
+template<typename Key, typename Value>
+typename AdaptiveRadixTree<Key, Value>::const_iterator AdaptiveRadixTree<Key, Value>::lower_bound(const Key& key) const
+{
+	return const_iterator(internalCeiling(RadixKey<Key>(key), true), this);
+}
+
+/**
+* Compares two keys' bytes lexicographically. A key that is a prefix of the other
+* is the smaller one.
+*/
+template<typename Key, typename Value>
+int AdaptiveRadixTree<Key, Value>::compareBytes(const RadixKey<Key>& a, const RadixKey<Key>& b)
+{
+	int length = std::min(a.size(), b.size());
+	int result = (length == 0) ? 0 : std::memcmp(a.data(), b.data(), length);
+
+	// Equal up to the shorter length
+	if (result == 0) {
+		return a.size() - b.size();
+	}
+
+	return result;
+}
+
+/**
+* Allocates a leaf holding a copy of the item.
+*/
+template<typename Key, typename Value>
+typename AdaptiveRadixTree<Key, Value>::RadixLeaf* AdaptiveRadixTree<Key, Value>::createLeaf(const std::pair<Key, Value>& keyValuePair)
+{
+	RadixLeaf* leaf = new RadixLeaf();
+	leaf->mType = LEAF;
+	leaf->mItem = keyValuePair;
+	leaf->mPrev = NULL;
+	leaf->mNext = NULL;
+
+	return leaf;
+}
+
+/**
+* Allocates an empty inner node of the given kind.
+*/
+template<typename Key, typename Value>
+typename AdaptiveRadixTree<Key, Value>::InnerNode* AdaptiveRadixTree<Key, Value>::createInner(NodeType type)
+{
+	InnerNode* node = NULL;
+
+	switch (type) {
+	case NODE4:
+		node = new Node4();
+		break;
+	case NODE16:
+		node = new Node16();
+		break;
+	case NODE48: {
+		Node48* node48 = new Node48();
+		std::memset(node48->mChildIndex, 0, sizeof(node48->mChildIndex));
+		std::fill(node48->mChildren, node48->mChildren + 48, static_cast<RadixNode*>(NULL));
+		node = node48;
+		break;
+	}
+	default: {
+		Node256* node256 = new Node256();
+		std::fill(node256->mChildren, node256->mChildren + 256, static_cast<RadixNode*>(NULL));
+		node = node256;
+		break;
+	}
+	}
+
+	node->mType = type;
+	node->mCount = 0;
+	node->mTerminal = NULL;
+
+	return node;
+}
+
+/**
+* Frees a single node of any kind. An inner node's children and terminal leaf are
+* left alone.
+*/
+template<typename Key, typename Value>
+void AdaptiveRadixTree<Key, Value>::deleteNode(RadixNode* node)
+{
+	switch (node->mType) {
+	case LEAF:
+		delete static_cast<RadixLeaf*>(node);
+		break;
+	case NODE4:
+		delete static_cast<Node4*>(node);
+		break;
+	case NODE16:
+		delete static_cast<Node16*>(node);
+		break;
+	case NODE48:
+		delete static_cast<Node48*>(node);
+		break;
+	case NODE256:
+		delete static_cast<Node256*>(node);
+		break;
+	}
+}
+
+/**
+* Frees a subtree, children first.
+*/
+template<typename Key, typename Value>
+void AdaptiveRadixTree<Key, Value>::deleteSubtree(RadixNode* node)
+{
+	if (node->mType != LEAF) {
+		InnerNode* inner = static_cast<InnerNode*>(node);
+
+		unsigned char bytes[256];
+		RadixNode* children[256];
+		int count = getChildren(inner, bytes, children);
+
+		for (int i = 0; i < count; ++i) {
+			deleteSubtree(children[i]);
+		}
+
+		if (inner->mTerminal != NULL) {
+			deleteNode(inner->mTerminal);
+		}
+	}
+
+	deleteNode(node);
+}
+
+/**
+* Returns the slot holding the child for byte, or NULL if there is no such child.
+* A Node16 compares all 16 key bytes at once with SSE2 when it is available.
+*/
+template<typename Key, typename Value>
+typename AdaptiveRadixTree<Key, Value>::RadixNode** AdaptiveRadixTree<Key, Value>::findChild(InnerNode* node, unsigned char byte)
+{
+	switch (node->mType) {
+	case NODE4: {
+		Node4* node4 = static_cast<Node4*>(node);
+
+		for (int i = 0; i < node4->mCount; ++i) {
+			if (node4->mKeys[i] == byte) {
+				return &node4->mChildren[i];
+			}
+		}
+
+		return NULL;
+	}
+	case NODE16: {
+		Node16* node16 = static_cast<Node16*>(node);
+
+#if defined(__SSE2__)
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(node16->mKeys));
+		__m128i equal = _mm_cmpeq_epi8(block, _mm_set1_epi8(static_cast<char>(byte)));
+
+		// One bit for every used slot holding byte
+		int match = _mm_movemask_epi8(equal) & ((1 << node16->mCount) - 1);
+
+		if (match != 0) {
+			return &node16->mChildren[__builtin_ctz(match)];
+		}
+#else
+		for (int i = 0; i < node16->mCount; ++i) {
+			if (node16->mKeys[i] == byte) {
+				return &node16->mChildren[i];
+			}
+		}
+#endif
+
+		return NULL;
+	}
+	case NODE48: {
+		Node48* node48 = static_cast<Node48*>(node);
+		int index = node48->mChildIndex[byte];
+
+		return (index == 0) ? NULL : &node48->mChildren[index - 1];
+	}
+	default: {
+		Node256* node256 = static_cast<Node256*>(node);
+
+		return (node256->mChildren[byte] == NULL) ? NULL : &node256->mChildren[byte];
+	}
+	}
+}
+
+/**
+* Returns the child with the smallest key byte, or NULL if there are no children.
+*/
+template<typename Key, typename Value>
+typename AdaptiveRadixTree<Key, Value>::RadixNode* AdaptiveRadixTree<Key, Value>::firstChild(const InnerNode* node)
+{
+	switch (node->mType) {
+	case NODE4:
+		return (node->mCount == 0) ? NULL : static_cast<const Node4*>(node)->mChildren[0];
+	case NODE16:
+		return (node->mCount == 0) ? NULL : static_cast<const Node16*>(node)->mChildren[0];
+	case NODE48: {
+		const Node48* node48 = static_cast<const Node48*>(node);
+
+		for (int i = 0; i < 256; ++i) {
+			if (node48->mChildIndex[i] != 0) {
+				return node48->mChildren[node48->mChildIndex[i] - 1];
+			}
+		}
+
+		return NULL;
+	}
+	default: {
+		const Node256* node256 = static_cast<const Node256*>(node);
+
+		for (int i = 0; i < 256; ++i) {
+			if (node256->mChildren[i] != NULL) {
+				return node256->mChildren[i];
+			}
+		}
+
+		return NULL;
+	}
+	}
+}
+
+/**
+* Returns the child with the smallest key byte greater than byte, or NULL if there
+* is none.
+*/
+template<typename Key, typename Value>
+typename AdaptiveRadixTree<Key, Value>::RadixNode* AdaptiveRadixTree<Key, Value>::childAfter(const InnerNode* node, unsigned char byte)
+{
+	switch (node->mType) {
+	case NODE4: {
+		const Node4* node4 = static_cast<const Node4*>(node);
+
+		for (int i = 0; i < node4->mCount; ++i) {
+			if (node4->mKeys[i] > byte) {
+				return node4->mChildren[i];
+			}
+		}
+
+		return NULL;
+	}
+	case NODE16: {
+		const Node16* node16 = static_cast<const Node16*>(node);
+
+		for (int i = 0; i < node16->mCount; ++i) {
+			if (node16->mKeys[i] > byte) {
+				return node16->mChildren[i];
+			}
+		}
+
+		return NULL;
+	}
+	case NODE48: {
+		const Node48* node48 = static_cast<const Node48*>(node);
+
+		for (int i = byte + 1; i < 256; ++i) {
+			if (node48->mChildIndex[i] != 0) {
+				return node48->mChildren[node48->mChildIndex[i] - 1];
+			}
+		}
+
+		return NULL;
+	}
+	default: {
+		const Node256* node256 = static_cast<const Node256*>(node);
+
+		for (int i = byte + 1; i < 256; ++i) {
+			if (node256->mChildren[i] != NULL) {
+				return node256->mChildren[i];
+			}
+		}
+
+		return NULL;
+	}
+	}
+}
+
+/**
+* Writes the children and their key bytes in key order and returns how many there are.
+*/
+template<typename Key, typename Value>
+int AdaptiveRadixTree<Key, Value>::getChildren(const InnerNode* node, unsigned char* bytes, RadixNode** children)
+{
+	int count = 0;
+
+	switch (node->mType) {
+	case NODE4: {
+		const Node4* node4 = static_cast<const Node4*>(node);
+
+		std::copy(node4->mKeys, node4->mKeys + node4->mCount, bytes);
+		std::copy(node4->mChildren, node4->mChildren + node4->mCount, children);
+		count = node4->mCount;
+		break;
+	}
+	case NODE16: {
+		const Node16* node16 = static_cast<const Node16*>(node);
+
+		std::copy(node16->mKeys, node16->mKeys + node16->mCount, bytes);
+		std::copy(node16->mChildren, node16->mChildren + node16->mCount, children);
+		count = node16->mCount;
+		break;
+	}
+	case NODE48: {
+		const Node48* node48 = static_cast<const Node48*>(node);
+
+		for (int i = 0; i < 256; ++i) {
+			if (node48->mChildIndex[i] != 0) {
+				bytes[count] = static_cast<unsigned char>(i);
+				children[count] = node48->mChildren[node48->mChildIndex[i] - 1];
+				++count;
+			}
+		}
+
+		break;
+	}
+	default: {
+		const Node256* node256 = static_cast<const Node256*>(node);
+
+		for (int i = 0; i < 256; ++i) {
+			if (node256->mChildren[i] != NULL) {
+				bytes[count] = static_cast<unsigned char>(i);
+				children[count] = node256->mChildren[i];
+				++count;
+			}
+		}
+
+		break;
+	}
+	}
+
+	return count;
+}
+
+/**
+* Adds a child for byte to a node that is not full. Node4 and Node16 keep their
+* key bytes sorted.
+*/
+template<typename Key, typename Value>
+void AdaptiveRadixTree<Key, Value>::addChildInPlace(InnerNode* node, unsigned char byte, RadixNode* child)
+{
+	switch (node->mType) {
+	case NODE4:
+	case NODE16: {
+		unsigned char* keys;
+		RadixNode** children;
+
+		if (node->mType == NODE4) {
+			keys = static_cast<Node4*>(node)->mKeys;
+			children = static_cast<Node4*>(node)->mChildren;
+		}
+
+		else {
+			keys = static_cast<Node16*>(node)->mKeys;
+			children = static_cast<Node16*>(node)->mChildren;
+		}
+
+		// Shift the larger key bytes up to open a slot
+		int index = node->mCount;
+
+		while (index > 0 && keys[index - 1] > byte) {
+			keys[index] = keys[index - 1];
+			children[index] = children[index - 1];
+			--index;
+		}
+
+		keys[index] = byte;
+		children[index] = child;
+		break;
+	}
+	case NODE48: {
+		Node48* node48 = static_cast<Node48*>(node);
+
+		// Take the first free slot
+		int slot = 0;
+
+		while (node48->mChildren[slot] != NULL) {
+			++slot;
+		}
+
+		node48->mChildren[slot] = child;
+		node48->mChildIndex[byte] = static_cast<unsigned char>(slot + 1);
+		break;
+	}
+	default:
+		static_cast<Node256*>(node)->mChildren[byte] = child;
+		break;
+	}
+
+	++node->mCount;
+}
+
+/**
+* Moves node's prefix, terminal leaf and children into a new node of the given kind
+* and frees node.
+*/
+template<typename Key, typename Value>
+typename AdaptiveRadixTree<Key, Value>::InnerNode* AdaptiveRadixTree<Key, Value>::resize(InnerNode* node, NodeType type)
+{
+	InnerNode* newNode = createInner(type);
+	newNode->mPrefixLength = node->mPrefixLength;
+	std::memcpy(newNode->mPrefix, node->mPrefix, sizeof(node->mPrefix));
+	newNode->mTerminal = node->mTerminal;
+
+	unsigned char bytes[256];
+	RadixNode* children[256];
+	int count = getChildren(node, bytes, children);
+
+	for (int i = 0; i < count; ++i) {
+		addChildInPlace(newNode, bytes[i], children[i]);
+	}
+
+	deleteNode(node);
+	return newNode;
+}
+
+/**
+* Stores the full length and the first MaxPrefix bytes of the prefix.
+*/
+template<typename Key, typename Value>
+void AdaptiveRadixTree<Key, Value>::setPrefix(InnerNode* node, const unsigned char* bytes, int length)
+{
+	node->mPrefixLength = length;
+	std::memcpy(node->mPrefix, bytes, (length < MaxPrefix) ? length : MaxPrefix);
+}
+
+/**
+* Every key below a node has the same bytes where the node's prefix is, so a byte
+* that is not stored can be read from any of their leaves.
+*/
+template<typename Key, typename Value>
+unsigned char AdaptiveRadixTree<Key, Value>::prefixByte(const InnerNode* node, const RadixLeaf* source, int depth, int i)
+{
+	if (i < MaxPrefix) {
+		return node->mPrefix[i];
+	}
+
+	return RadixKey<Key>(source->mItem.first).data()[depth + i];
+}
+
+/**
+* Checks the prefix optimistically: bytes past MaxPrefix are assumed to match.
+*/
+template<typename Key, typename Value>
+bool AdaptiveRadixTree<Key, Value>::prefixMatches(const InnerNode* node, const RadixKey<Key>& bytes, int depth)
+{
+	int prefixLength = node->mPrefixLength;
+
+	if (depth + prefixLength > bytes.size()) {
+		return false;
+	}
+
+	return std::memcmp(node->mPrefix, bytes.data() + depth, (prefixLength < MaxPrefix) ? prefixLength : MaxPrefix) == 0;
+}
+
+/**
+* Adds a child to the inner node held in ref. A full node is first replaced with
+* the next larger kind.
+*/
+template<typename Key, typename Value>
+void AdaptiveRadixTree<Key, Value>::addChild(RadixNode*& ref, unsigned char byte, RadixNode* child)
+{
+	InnerNode* node = static_cast<InnerNode*>(ref);
+
+	// Grow a full node
+	if (node->mType == NODE4 && node->mCount == 4) {
+		node = resize(node, NODE16);
+	}
+
+	else if (node->mType == NODE16 && node->mCount == 16) {
+		node = resize(node, NODE48);
+	}
+
+	else if (node->mType == NODE48 && node->mCount == 48) {
+		node = resize(node, NODE256);
+	}
+
+	addChildInPlace(node, byte, child);
+	ref = node;
+}
+
+/**
+* Removes the child for byte from the inner node held in ref. A node that is left
+* well under the capacity of the next smaller kind is replaced with that kind; the
+* gap keeps a node from flipping back and forth between two kinds.
+*/
+template<typename Key, typename Value>
+void AdaptiveRadixTree<Key, Value>::removeChild(RadixNode*& ref, unsigned char byte)
+{
+	InnerNode* node = static_cast<InnerNode*>(ref);
+
+	switch (node->mType) {
+	case NODE4:
+	case NODE16: {
+		unsigned char* keys;
+		RadixNode** children;
+
+		if (node->mType == NODE4) {
+			keys = static_cast<Node4*>(node)->mKeys;
+			children = static_cast<Node4*>(node)->mChildren;
+		}
+
+		else {
+			keys = static_cast<Node16*>(node)->mKeys;
+			children = static_cast<Node16*>(node)->mChildren;
+		}
+
+		int index = 0;
+
+		while (keys[index] != byte) {
+			++index;
+		}
+
+		// Close the gap
+		std::copy(keys + index + 1, keys + node->mCount, keys + index);
+		std::copy(children + index + 1, children + node->mCount, children + index);
+		break;
+	}
+	case NODE48: {
+		Node48* node48 = static_cast<Node48*>(node);
+
+		node48->mChildren[node48->mChildIndex[byte] - 1] = NULL;
+		node48->mChildIndex[byte] = 0;
+		break;
+	}
+	default:
+		static_cast<Node256*>(node)->mChildren[byte] = NULL;
+		break;
+	}
+
+	--node->mCount;
+
+	// Shrink a mostly empty node
+	if (node->mType == NODE16 && node->mCount < 3) {
+		ref = resize(node, NODE4);
+	}
+
+	else if (node->mType == NODE48 && node->mCount < 12) {
+		ref = resize(node, NODE16);
+	}
+
+	else if (node->mType == NODE256 && node->mCount < 40) {
+		ref = resize(node, NODE48);
+	}
+}
+
+/**
+* An inner node must branch: hold two or more items or children. With only a
+* terminal leaf left, the leaf takes the node's place. With only one child left,
+* the child takes its place and the node's prefix and the child's key byte are
+* moved to the front of the child's prefix.
+*/
+template<typename Key, typename Value>
+void AdaptiveRadixTree<Key, Value>::collapse(RadixNode*& ref)
+{
+	InnerNode* node = static_cast<InnerNode*>(ref);
+
+	// Only the terminal leaf is left
+	if (node->mCount == 0) {
+		ref = node->mTerminal;
+		deleteNode(node);
+	}
+
+	// Only one child is left
+	else if (node->mCount == 1 && node->mTerminal == NULL) {
+		unsigned char byte;
+		RadixNode* child;
+		getChildren(node, &byte, &child);
+
+		// The first MaxPrefix bytes of the joined prefix all come from stored bytes
+		if (child->mType != LEAF) {
+			InnerNode* innerChild = static_cast<InnerNode*>(child);
+			int length = node->mPrefixLength + 1 + innerChild->mPrefixLength;
+			unsigned char joined[MaxPrefix];
+
+			for (int i = 0; i < length && i < MaxPrefix; ++i) {
+				if (i < node->mPrefixLength) {
+					joined[i] = node->mPrefix[i];
+				}
+
+				else if (i == node->mPrefixLength) {
+					joined[i] = byte;
+				}
+
+				else {
+					joined[i] = innerChild->mPrefix[i - node->mPrefixLength - 1];
+				}
+			}
+
+			setPrefix(innerChild, joined, length);
+		}
+
+		ref = child;
+		deleteNode(node);
+	}
+}
+
+/**
+* Returns the smallest leaf in a subtree. An inner node's terminal leaf is smaller
+* than everything in its children.
+*/
+template<typename Key, typename Value>
+typename AdaptiveRadixTree<Key, Value>::RadixLeaf* AdaptiveRadixTree<Key, Value>::minimum(RadixNode* node)
+{
+	while (node->mType != LEAF) {
+		InnerNode* inner = static_cast<InnerNode*>(node);
+
+		if (inner->mTerminal != NULL) {
+			return inner->mTerminal;
+		}
+
+		node = firstChild(inner);
+	}
+
+	return static_cast<RadixLeaf*>(node);
+}
+
+/**
+* Finds the leaf holding key by following one key byte per level. The stored part
+* of inner node prefixes is checked on the way down, and the leaf's whole key at
+* the end.
+*/
+template<typename Key, typename Value>
+typename AdaptiveRadixTree<Key, Value>::RadixLeaf* AdaptiveRadixTree<Key, Value>::internalFind(const Key& key) const
+{
+	RadixKey<Key> bytes(key);
+	RadixNode* node = mRoot;
+	int depth = 0;
+
+	while (node != NULL) {
+		// Check the whole key at a leaf
+		if (node->mType == LEAF) {
+			RadixLeaf* leaf = static_cast<RadixLeaf*>(node);
+
+			return (compareBytes(RadixKey<Key>(leaf->mItem.first), bytes) == 0) ? leaf : NULL;
+		}
+
+		InnerNode* inner = static_cast<InnerNode*>(node);
+
+		// The key must continue with the node's prefix
+		if (!prefixMatches(inner, bytes, depth)) {
+			return NULL;
+		}
+
+		depth += inner->mPrefixLength;
+
+		// The key ends at this node. The terminal leaf's whole key is checked too,
+		// since prefix bytes past MaxPrefix were skipped.
+		if (depth == bytes.size()) {
+			RadixLeaf* terminal = inner->mTerminal;
+
+			return (terminal != NULL && compareBytes(RadixKey<Key>(terminal->mItem.first), bytes) == 0) ? terminal : NULL;
+		}
+
+		RadixNode** child = findChild(inner, bytes.data()[depth]);
+		node = (child == NULL) ? NULL : *child;
+		++depth;
+	}
+
+	return NULL;
+}
+
+/**
+* Walks down like find. Along the way it remembers the subtree just after the path
+* taken at the deepest level where one exists; once the key leaves the tree, the
+* answer is either the smallest leaf of the subtree where it left (if everything
+* there is larger) or the smallest leaf of that remembered subtree.
+*/
+template<typename Key, typename Value>
+typename AdaptiveRadixTree<Key, Value>::RadixLeaf* AdaptiveRadixTree<Key, Value>::internalCeiling(const RadixKey<Key>& bytes, bool inclusive) const
+{
+	RadixNode* node = mRoot;
+	RadixNode* nextSubtree = NULL;
+	int depth = 0;
+
+	while (node != NULL) {
+		if (node->mType == LEAF) {
+			RadixLeaf* leaf = static_cast<RadixLeaf*>(node);
+			int result = compareBytes(RadixKey<Key>(leaf->mItem.first), bytes);
+
+			// The leaf is after key
+			if (result > 0 || (result == 0 && inclusive)) {
+				return leaf;
+			}
+
+			break;
+		}
+
+		InnerNode* inner = static_cast<InnerNode*>(node);
+		int prefixLength = inner->mPrefixLength;
+
+		RadixLeaf* source = NULL;
+
+		for (int i = 0; i < prefixLength; ++i) {
+			// The key ends inside the prefix, so everything below is after it
+			if (depth + i == bytes.size()) {
+				return minimum(inner);
+			}
+
+			// The order depends on every prefix byte, so once the stored ones match
+			// the rest are read from the smallest leaf below
+			if (i == MaxPrefix) {
+				source = minimum(inner);
+			}
+
+			unsigned char nodeByte = prefixByte(inner, source, depth, i);
+
+			// The key leaves the tree inside the prefix
+			if (nodeByte != bytes.data()[depth + i]) {
+				if (nodeByte > bytes.data()[depth + i]) {
+					return minimum(inner);
+				}
+
+				return (nextSubtree == NULL) ? NULL : minimum(nextSubtree);
+			}
+		}
+
+		depth += prefixLength;
+
+		// The key ends at this node: only the terminal leaf can equal it
+		if (depth == bytes.size()) {
+			if (inner->mTerminal != NULL && inclusive) {
+				return inner->mTerminal;
+			}
+
+			RadixNode* first = firstChild(inner);
+
+			if (first != NULL) {
+				return minimum(first);
+			}
+
+			break;
+		}
+
+		unsigned char byte = bytes.data()[depth];
+
+		RadixNode* after = childAfter(inner, byte);
+
+		if (after != NULL) {
+			nextSubtree = after;
+		}
+
+		RadixNode** child = findChild(inner, byte);
+		node = (child == NULL) ? NULL : *child;
+		++depth;
+	}
+
+	return (nextSubtree == NULL) ? NULL : minimum(nextSubtree);
+}
+
+/**
+* Links a new leaf in front of the first leaf after it.
+*/
+template<typename Key, typename Value>
+void AdaptiveRadixTree<Key, Value>::linkLeaf(RadixLeaf* leaf)
+{
+	RadixLeaf* next = internalCeiling(RadixKey<Key>(leaf->mItem.first), false);
+	RadixLeaf* prev = (next == NULL) ? mLast : next->mPrev;
+
+	leaf->mNext = next;
+	leaf->mPrev = prev;
+
+	if (prev != NULL) {
+		prev->mNext = leaf;
+	}
+
+	else {
+		mFirst = leaf;
+	}
+
+	if (next != NULL) {
+		next->mPrev = leaf;
+	}
+
+	else {
+		mLast = leaf;
+	}
+}
+
+/**
+* Unlinks a leaf from the list of leaves.
+*/
+template<typename Key, typename Value>
+void AdaptiveRadixTree<Key, Value>::unlinkLeaf(RadixLeaf* leaf)
+{
+	if (leaf->mPrev != NULL) {
+		leaf->mPrev->mNext = leaf->mNext;
+	}
+
+	else {
+		mFirst = leaf->mNext;
+	}
+
+	if (leaf->mNext != NULL) {
+		leaf->mNext->mPrev = leaf->mPrev;
+	}
+
+	else {
+		mLast = leaf->mPrev;
+	}
+}
+
+/**
+* Inserts a key value pair. The walk down follows the key until it finds the item
+* (and updates its value) or reaches the point where the key leaves the tree: an
+* empty slot, a leaf with a different key, or an inner node whose prefix does not
+* match. In the last two cases a new Node4 branches between the old subtree and the
+* new leaf.
+*/
+template<typename Key, typename Value>
+void AdaptiveRadixTree<Key, Value>::insert(const std::pair<Key, Value>& keyValuePair)
+{
+	RadixKey<Key> bytes(keyValuePair.first);
+	RadixNode** ref = &mRoot;
+	int depth = 0;
+
+	RadixLeaf* newLeaf = NULL;
+
+	while (newLeaf == NULL) {
+		RadixNode* node = *ref;
+
+		// If the tree is empty the new leaf is the root
+		if (node == NULL) {
+			newLeaf = createLeaf(keyValuePair);
+			*ref = newLeaf;
+			break;
+		}
+
+		if (node->mType == LEAF) {
+			RadixLeaf* leaf = static_cast<RadixLeaf*>(node);
+			RadixKey<Key> leafBytes(leaf->mItem.first);
+
+			// If there is a duplicate entry update its value
+			if (compareBytes(leafBytes, bytes) == 0) {
+				leaf->mItem.second = keyValuePair.second;
+				return;
+			}
+
+			// Branch where the two keys first differ
+			int common = 0;
+
+			while (depth + common < bytes.size() && depth + common < leafBytes.size() &&
+				bytes.data()[depth + common] == leafBytes.data()[depth + common]) {
+				++common;
+			}
+
+			InnerNode* branch = createInner(NODE4);
+			setPrefix(branch, bytes.data() + depth, common);
+
+			newLeaf = createLeaf(keyValuePair);
+
+			int end = depth + common;
+
+			// Either key may end at the branch
+			if (leafBytes.size() == end) {
+				branch->mTerminal = leaf;
+			}
+
+			else {
+				addChildInPlace(branch, leafBytes.data()[end], leaf);
+			}
+
+			if (bytes.size() == end) {
+				branch->mTerminal = newLeaf;
+			}
+
+			else {
+				addChildInPlace(branch, bytes.data()[end], newLeaf);
+			}
+
+			*ref = branch;
+			break;
+		}
+
+		InnerNode* inner = static_cast<InnerNode*>(node);
+		int prefixLength = inner->mPrefixLength;
+
+		RadixLeaf* source = NULL;
+
+		// Count how much of the prefix the key matches
+		int matched = 0;
+
+		while (matched < prefixLength && depth + matched < bytes.size()) {
+			// Inserting needs every prefix byte, so once the stored ones match the
+			// rest are read from the smallest leaf below
+			if (matched == MaxPrefix) {
+				source = minimum(inner);
+			}
+
+			if (prefixByte(inner, source, depth, matched) != bytes.data()[depth + matched]) {
+				break;
+			}
+
+			++matched;
+		}
+
+		// The key leaves the tree inside the prefix, so split the prefix
+		if (matched < prefixLength) {
+			InnerNode* branch = createInner(NODE4);
+
+			// The bytes inner keeps may run past the stored ones
+			if (source == NULL && prefixLength > MaxPrefix) {
+				source = minimum(inner);
+			}
+
+			// The matched bytes are the same as the key's
+			setPrefix(branch, bytes.data() + depth, matched);
+
+			unsigned char innerByte = prefixByte(inner, source, depth, matched);
+
+			// inner keeps the bytes after the one it now hangs under
+			unsigned char rest[MaxPrefix];
+			int restLength = prefixLength - matched - 1;
+
+			for (int i = 0; i < restLength && i < MaxPrefix; ++i) {
+				rest[i] = prefixByte(inner, source, depth, matched + 1 + i);
+			}
+
+			setPrefix(inner, rest, restLength);
+			addChildInPlace(branch, innerByte, inner);
+
+			newLeaf = createLeaf(keyValuePair);
+
+			// The key may end where the prefixes part
+			if (depth + matched == bytes.size()) {
+				branch->mTerminal = newLeaf;
+			}
+
+			else {
+				addChildInPlace(branch, bytes.data()[depth + matched], newLeaf);
+			}
+
+			*ref = branch;
+			break;
+		}
+
+		depth += prefixLength;
+
+		// The key ends at this node
+		if (depth == bytes.size()) {
+			if (inner->mTerminal != NULL) {
+				inner->mTerminal->mItem.second = keyValuePair.second;
+				return;
+			}
+
+			newLeaf = createLeaf(keyValuePair);
+			inner->mTerminal = newLeaf;
+			break;
+		}
+
+		RadixNode** child = findChild(inner, bytes.data()[depth]);
+
+		// No child for the next byte yet
+		if (child == NULL) {
+			newLeaf = createLeaf(keyValuePair);
+			addChild(*ref, bytes.data()[depth], newLeaf);
+			break;
+		}
+
+		ref = child;
+		++depth;
+	}
+
+	linkLeaf(newLeaf);
+	++mSize;
+}
+
+/**
+* Removes the item with the given key. Does nothing if the key is not in the tree.
+* The leaf's parent loses a child, possibly shrinks, and is collapsed into its last
+* item or child if it no longer branches.
+*/
+template<typename Key, typename Value>
+void AdaptiveRadixTree<Key, Value>::remove(const Key& key)
+{
+	RadixKey<Key> bytes(key);
+	RadixNode** ref = &mRoot;
+	RadixNode** parentRef = NULL;
+	int depth = 0;
+
+	while (*ref != NULL) {
+		RadixNode* node = *ref;
+
+		if (node->mType == LEAF) {
+			RadixLeaf* leaf = static_cast<RadixLeaf*>(node);
+
+			// The key is not in the tree
+			if (compareBytes(RadixKey<Key>(leaf->mItem.first), bytes) != 0) {
+				return;
+			}
+
+			// The leaf is the root
+			if (parentRef == NULL) {
+				mRoot = NULL;
+			}
+
+			// The leaf is the child for the byte before depth
+			else {
+				removeChild(*parentRef, bytes.data()[depth - 1]);
+				collapse(*parentRef);
+			}
+
+			unlinkLeaf(leaf);
+			deleteNode(leaf);
+			--mSize;
+			return;
+		}
+
+		InnerNode* inner = static_cast<InnerNode*>(node);
+
+		// The key must continue with the node's prefix
+		if (!prefixMatches(inner, bytes, depth)) {
+			return;
+		}
+
+		depth += inner->mPrefixLength;
+
+		// The key ends at this node
+		if (depth == bytes.size()) {
+			RadixLeaf* leaf = inner->mTerminal;
+
+			// The key is not in the tree. Prefix bytes past MaxPrefix were skipped,
+			// so the whole key is checked.
+			if (leaf == NULL || compareBytes(RadixKey<Key>(leaf->mItem.first), bytes) != 0) {
+				return;
+			}
+
+			inner->mTerminal = NULL;
+			collapse(*ref);
+
+			unlinkLeaf(leaf);
+			deleteNode(leaf);
+			--mSize;
+			return;
+		}
+
+		RadixNode** child = findChild(inner, bytes.data()[depth]);
+
+		// The key is not in the tree
+		if (child == NULL) {
+			return;
+		}
+
+		parentRef = ref;
+		ref = child;
+		++depth;
+	}
+}
+
+/*
+------------------------------------------
+End implementations for the AdaptiveRadixTree class.
+------------------------------------------
+*/
+
+#endif
@@ -0,0 +1,444 @@
+#ifndef AUGMENTEDAVL_H
+#define AUGMENTEDAVL_H
+
+#include <type_traits>
+#include "avlbst.h"
+#include "../bst/augment.h"
+
+/**
+* An AVLNode that also stores the combined summary of every item in its subtree.
+*/
+template <typename Key, typename Value, typename Summary>
+class AugmentedAVLNode : public AVLNode<Key, Value>
+{
+public:
+	AugmentedAVLNode(const Key& key, const Value& value, AVLNode<Key, Value>* parent, const Summary& summary);
+	AugmentedAVLNode(std::pair<Key, Value> item, AVLNode<Key, Value>* parent, const Summary& summary);
+	virtual ~AugmentedAVLNode();
+
+	const Summary& getSummary() const;
+	void setSummary(const Summary& summary);
+
+	// Copies the summary as well as the data the base node copies
+	virtual AugmentedAVLNode<Key, Value, Summary>* clone(Node<Key, Value>* parent) const override;
+
+	// The same for compaction
+	virtual std::size_t getNodeBytes() const override;
+	virtual AugmentedAVLNode<Key, Value, Summary>* relocate(void* place) override;
+
+protected:
+	Summary mSummary;
+};
+
+/*
+--------------------------------------------
+Begin implementations for the AugmentedAVLNode class.
+--------------------------------------------
+*/
+
+/**
+* Constructor for an AugmentedAVLNode. A new node is a leaf, so its summary is the
+* summary of its own item.
+*/
+template<typename Key, typename Value, typename Summary>
+AugmentedAVLNode<Key, Value, Summary>::AugmentedAVLNode(const Key& key, const Value& value, AVLNode<Key, Value>* parent, const Summary& summary)
+	: AVLNode<Key, Value>(key, value, parent)
+	, mSummary(summary)
+{
+
+}
+
+/**
+* Constructor that moves the item into the node.
+*/
+template<typename Key, typename Value, typename Summary>
+AugmentedAVLNode<Key, Value, Summary>::AugmentedAVLNode(std::pair<Key, Value> item, AVLNode<Key, Value>* parent, const Summary& summary)
+	: AVLNode<Key, Value>(std::move(item), parent)
+	, mSummary(summary)
+{
+
+}
+
+/**
+* Destructor.
+*/
+template<typename Key, typename Value, typename Summary>
+AugmentedAVLNode<Key, Value, Summary>::~AugmentedAVLNode()
+{
+
+}
+
+/**
+* Getter function for the subtree summary.
+*/
+template<typename Key, typename Value, typename Summary>
+const Summary& AugmentedAVLNode<Key, Value, Summary>::getSummary() const
+{
+	return mSummary;
+}
+
+/**
+* Setter function for the subtree summary.
+*/
+template<typename Key, typename Value, typename Summary>
+void AugmentedAVLNode<Key, Value, Summary>::setSummary(const Summary& summary)
+{
+	mSummary = summary;
+}
+
+/**
+* Allocates a copy of this node with the given parent and no children.
+*/
+template<typename Key, typename Value, typename Summary>
+AugmentedAVLNode<Key, Value, Summary>* AugmentedAVLNode<Key, Value, Summary>::clone(Node<Key, Value>* parent) const
+{
+	AugmentedAVLNode<Key, Value, Summary>* copy = new AugmentedAVLNode<Key, Value, Summary>(this->getKey(), this->getValue(),
+		static_cast<AVLNode<Key, Value>*>(parent), mSummary);
+
+	copy->setHeight(this->getHeight());
+	copy->setSize(this->getSize());
+
+	return copy;
+}
+
+/**
+* Returns the number of bytes an AugmentedAVLNode takes.
+*/
+template<typename Key, typename Value, typename Summary>
+std::size_t AugmentedAVLNode<Key, Value, Summary>::getNodeBytes() const
+{
+	return sizeof(AugmentedAVLNode<Key, Value, Summary>);
+}
+
+/**
+* Moves this node, summary included, to place with no links. The summary is
+* copied after the item, so the item is only moved if copying the summary cannot
+* throw.
+*/
+template<typename Key, typename Value, typename Summary>
+AugmentedAVLNode<Key, Value, Summary>* AugmentedAVLNode<Key, Value, Summary>::relocate(void* place)
+{
+	AugmentedAVLNode<Key, Value, Summary>* copy;
+
+	if (std::is_nothrow_copy_constructible<Summary>::value) {
+		copy = new (place) AugmentedAVLNode<Key, Value, Summary>(std::move_if_noexcept(this->getItem()), NULL, mSummary);
+	}
+
+	else {
+		copy = new (place) AugmentedAVLNode<Key, Value, Summary>(this->getItem(), NULL, mSummary);
+	}
+
+	copy->setHeight(this->getHeight());
+	copy->setSize(this->getSize());
+
+	return copy;
+}
+
+/*
+------------------------------------------
+End implementations for the AugmentedAVLNode class.
+------------------------------------------
+*/
+
+/**
+* An AVL tree where every node stores the Monoid summary of its subtree, so that the
+* summary of any key range can be computed in O(log n). See augment.h for the Monoid
+* policy requirements. Summaries are kept up to date by the same hook that maintains
+* subtree sizes, so they are recomputed in every rotation and along the path of every
+* insert and remove.
+*
+* A value written behind the tree's back would leave the summaries above it stale,
+* so the tree only hands out const access to its items. The functions below hide
+* the ones from AVLTree that return iterators or references that can write, and
+* values are changed through insert or modify().
+*/
+template <class Key, class Value, class Monoid>
+class AugmentedAVLTree : public AVLTree<Key, Value>
+{
+public:
+	typedef typename Monoid::Summary Summary;
+	typedef typename AVLTree<Key, Value>::const_iterator const_iterator;
+	typedef typename AVLTree<Key, Value>::const_reverse_iterator const_reverse_iterator;
+	typedef typename AVLTree<Key, Value>::const_range_view const_range_view;
+
+	// Returns the combined summary of all items with lo <= key < hi
+	Summary aggregate(const Key& lo, const Key& hi) const;
+
+	// Returns the combined summary of every item in the tree
+	Summary total() const;
+
+	// Calls fn with the value stored under key and recomputes the summaries on the
+	// path to the root in O(log n). Returns false, without calling fn, if key is
+	// not in the tree.
+	template <typename Function>
+	bool modify(const Key& key, Function fn);
+
+	// The same as in AVLTree, but taking and returning const_iterators
+	virtual void insert(const std::pair<Key, Value>& keyValuePair) override;
+	const_iterator insert(const_iterator hint, const std::pair<Key, Value>& keyValuePair);
+	const_iterator erase(const_iterator pos);
+	int erase(const Key& lo, const Key& hi);
+
+	// Read only access to the items
+	const_iterator begin() const;
+	const_iterator end() const;
+	const_reverse_iterator rbegin() const;
+	const_reverse_iterator rend() const;
+	const_iterator find(const Key& key) const;
+	const_iterator lower_bound(const Key& key) const;
+	const_iterator upper_bound(const Key& key) const;
+	std::pair<const_iterator, const_iterator> equal_range(const Key& key) const;
+	const_iterator floor(const Key& key) const;
+	const_iterator ceiling(const Key& key) const;
+	const_iterator predecessor(const Key& key) const;
+	const_iterator successor(const Key& key) const;
+	const_range_view range(const Key& lo, const Key& hi) const;
+	const_iterator select(int k) const;
+	const std::pair<Key, Value>& front() const;
+	const std::pair<Key, Value>& back() const;
+
+protected:
+	typedef AugmentedAVLNode<Key, Value, Summary> NodeType;
+
+	virtual NodeType* createNode(const Key& key, const Value& value, Node<Key, Value>* parent) override;
+	virtual void updateNode(AVLNode<Key, Value>* node) override;
+};
+
+/*
+--------------------------------------------
+Begin implementations for the AugmentedAVLTree class.
+--------------------------------------------
+*/
+
+/**
+* Allocates a node that carries a summary.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedAVLTree<Key, Value, Monoid>::NodeType* AugmentedAVLTree<Key, Value, Monoid>::createNode(const Key& key, const Value& value, Node<Key, Value>* parent) {
+	return new NodeType(key, value, static_cast<AVLNode<Key, Value>*>(parent), Monoid::fromItem(key, value));
+}
+
+/**
+* Recomputes the subtree size and the summary of a node from its children.
+*/
+template<typename Key, typename Value, typename Monoid>
+void AugmentedAVLTree<Key, Value, Monoid>::updateNode(AVLNode<Key, Value>* node) {
+	AVLTree<Key, Value>::updateNode(node);
+
+	NodeType* augmentedNode = static_cast<NodeType*>(node);
+
+	Summary leftSummary = subtreeSummary<Monoid>(static_cast<NodeType*>(node->getLeft()));
+	Summary rightSummary = subtreeSummary<Monoid>(static_cast<NodeType*>(node->getRight()));
+
+	augmentedNode->setSummary(Monoid::combine(Monoid::combine(leftSummary,
+		Monoid::fromItem(node->getKey(), node->getValue())), rightSummary));
+}
+
+/**
+* Returns the combined summary of all items with lo <= key < hi in O(log n).
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedAVLTree<Key, Value, Monoid>::Summary AugmentedAVLTree<Key, Value, Monoid>::aggregate(const Key& lo, const Key& hi) const {
+	return aggregateRange<Monoid>(static_cast<NodeType*>(BinarySearchTree<Key, Value>::mRoot), lo, hi);
+}
+
+/**
+* Returns the combined summary of every item in the tree in O(1).
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedAVLTree<Key, Value, Monoid>::Summary AugmentedAVLTree<Key, Value, Monoid>::total() const {
+	return subtreeSummary<Monoid>(static_cast<NodeType*>(BinarySearchTree<Key, Value>::mRoot));
+}
+
+/**
+* Changes the value under key in place and brings the summaries back up to date.
+*/
+template<typename Key, typename Value, typename Monoid>
+template<typename Function>
+bool AugmentedAVLTree<Key, Value, Monoid>::modify(const Key& key, Function fn) {
+	Node<Key, Value>* node = BinarySearchTree<Key, Value>::internalFind(key);
+
+	// If key is not in the tree
+	if (node == NULL) {
+		return false;
+	}
+
+	fn(node->getValue());
+
+	this->updatePath(static_cast<AVLNode<Key, Value>*>(node));
+
+	return true;
+}
+
+/**
+* Inserts keyValuePair, or replaces the value of its key, as AVLTree does.
+*/
+template<typename Key, typename Value, typename Monoid>
+void AugmentedAVLTree<Key, Value, Monoid>::insert(const std::pair<Key, Value>& keyValuePair) {
+	AVLTree<Key, Value>::insert(keyValuePair);
+}
+
+/**
+* Inserts keyValuePair next to hint when it belongs there, as AVLTree does.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedAVLTree<Key, Value, Monoid>::const_iterator AugmentedAVLTree<Key, Value, Monoid>::insert(const_iterator hint, const std::pair<Key, Value>& keyValuePair) {
+	typename AVLTree<Key, Value>::iterator writableHint(BinarySearchTree<Key, Value>::getNode(hint), this);
+
+	return AVLTree<Key, Value>::insert(writableHint, keyValuePair);
+}
+
+/**
+* Removes the item at pos and returns an iterator to the next item.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedAVLTree<Key, Value, Monoid>::const_iterator AugmentedAVLTree<Key, Value, Monoid>::erase(const_iterator pos) {
+	typename AVLTree<Key, Value>::iterator writablePos(BinarySearchTree<Key, Value>::getNode(pos), this);
+
+	return AVLTree<Key, Value>::erase(writablePos);
+}
+
+/**
+* Removes every item with lo <= key < hi and returns how many were removed.
+*/
+template<typename Key, typename Value, typename Monoid>
+int AugmentedAVLTree<Key, Value, Monoid>::erase(const Key& lo, const Key& hi) {
+	return AVLTree<Key, Value>::erase(lo, hi);
+}
+
+/**
+* Returns a const_iterator to the smallest item.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedAVLTree<Key, Value, Monoid>::const_iterator AugmentedAVLTree<Key, Value, Monoid>::begin() const {
+	return AVLTree<Key, Value>::begin();
+}
+
+/**
+* Returns the end const_iterator.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedAVLTree<Key, Value, Monoid>::const_iterator AugmentedAVLTree<Key, Value, Monoid>::end() const {
+	return AVLTree<Key, Value>::end();
+}
+
+/**
+* Returns a reverse iterator to the largest item.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedAVLTree<Key, Value, Monoid>::const_reverse_iterator AugmentedAVLTree<Key, Value, Monoid>::rbegin() const {
+	return AVLTree<Key, Value>::rbegin();
+}
+
+/**
+* Returns the end reverse iterator.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedAVLTree<Key, Value, Monoid>::const_reverse_iterator AugmentedAVLTree<Key, Value, Monoid>::rend() const {
+	return AVLTree<Key, Value>::rend();
+}
+
+/**
+* Returns a const_iterator to the item with the given key, or end().
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedAVLTree<Key, Value, Monoid>::const_iterator AugmentedAVLTree<Key, Value, Monoid>::find(const Key& key) const {
+	return AVLTree<Key, Value>::find(key);
+}
+
+/**
+* Returns a const_iterator to the first item whose key is not less than key.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedAVLTree<Key, Value, Monoid>::const_iterator AugmentedAVLTree<Key, Value, Monoid>::lower_bound(const Key& key) const {
+	return AVLTree<Key, Value>::lower_bound(key);
+}
+
+/**
+* Returns a const_iterator to the first item whose key is greater than key.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedAVLTree<Key, Value, Monoid>::const_iterator AugmentedAVLTree<Key, Value, Monoid>::upper_bound(const Key& key) const {
+	return AVLTree<Key, Value>::upper_bound(key);
+}
+
+/**
+* Returns the items equal to key as [first, second).
+*/
+template<typename Key, typename Value, typename Monoid>
+std::pair<typename AugmentedAVLTree<Key, Value, Monoid>::const_iterator, typename AugmentedAVLTree<Key, Value, Monoid>::const_iterator>
+AugmentedAVLTree<Key, Value, Monoid>::equal_range(const Key& key) const {
+	return AVLTree<Key, Value>::equal_range(key);
+}
+
+/**
+* Returns a const_iterator to the last item whose key is not greater than key.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedAVLTree<Key, Value, Monoid>::const_iterator AugmentedAVLTree<Key, Value, Monoid>::floor(const Key& key) const {
+	return AVLTree<Key, Value>::floor(key);
+}
+
+/**
+* Returns a const_iterator to the first item whose key is not less than key.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedAVLTree<Key, Value, Monoid>::const_iterator AugmentedAVLTree<Key, Value, Monoid>::ceiling(const Key& key) const {
+	return AVLTree<Key, Value>::ceiling(key);
+}
+
+/**
+* Returns a const_iterator to the last item whose key is less than key.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedAVLTree<Key, Value, Monoid>::const_iterator AugmentedAVLTree<Key, Value, Monoid>::predecessor(const Key& key) const {
+	return AVLTree<Key, Value>::predecessor(key);
+}
+
+/**
+* Returns a const_iterator to the first item whose key is greater than key.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedAVLTree<Key, Value, Monoid>::const_iterator AugmentedAVLTree<Key, Value, Monoid>::successor(const Key& key) const {
+	return AVLTree<Key, Value>::successor(key);
+}
+
+/**
+* Returns a read only view over the items with lo <= key < hi.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedAVLTree<Key, Value, Monoid>::const_range_view AugmentedAVLTree<Key, Value, Monoid>::range(const Key& lo, const Key& hi) const {
+	return AVLTree<Key, Value>::range(lo, hi);
+}
+
+/**
+* Returns a const_iterator to the k-th smallest item (k starts at 0), or end().
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedAVLTree<Key, Value, Monoid>::const_iterator AugmentedAVLTree<Key, Value, Monoid>::select(int k) const {
+	return AVLTree<Key, Value>::select(k);
+}
+
+/**
+* Returns the smallest item. The tree must not be empty.
+*/
+template<typename Key, typename Value, typename Monoid>
+const std::pair<Key, Value>& AugmentedAVLTree<Key, Value, Monoid>::front() const {
+	return AVLTree<Key, Value>::front();
+}
+
+/**
+* Returns the largest item. The tree must not be empty.
+*/
+template<typename Key, typename Value, typename Monoid>
+const std::pair<Key, Value>& AugmentedAVLTree<Key, Value, Monoid>::back() const {
+	return AVLTree<Key, Value>::back();
+}
+
+/*
+------------------------------------------
+End implementations for the AugmentedAVLTree class.
+------------------------------------------
+*/
+
+#endif
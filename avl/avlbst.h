@@ -5,7 +5,14 @@
 #include <cstdlib>
 #include <string>
 #include <algorithm>
+#include <vector>
+#include <new>
+#include <cstddef>
+#include <functional>
+#include <cassert>
 #include "../bst/bst.h"
+#include "eytzinger.h"
+#include "learnedindex.h"
 
 /**
 * A special kind of node for an AVL tree, which adds the height as a data member, plus 
@@ -18,12 +25,17 @@ class AVLNode : public Node<Key, Value>
 public:
 	// Constructor/destructor.
 	AVLNode(const Key& key, const Value& value, AVLNode<Key, Value>* parent);
+	AVLNode(std::pair<Key, Value> item, AVLNode<Key, Value>* parent);
 	virtual ~AVLNode();
 
 	// Getter/setter for the node's height.
 	int getHeight() const;
 	void setHeight(int height);
 
+	// Getter/setter for the number of nodes in the subtree rooted at this node.
+	int getSize() const;
+	void setSize(int size);
+
 	// Getters for parent, left, and right. These need to be redefined since they 
 	// return pointers to AVLNodes - not plain Nodes. See the Node class in bst.h
 	// for more information.
@@ -31,8 +43,24 @@ public:
 	virtual AVLNode<Key, Value>* getLeft() const override;
 	virtual AVLNode<Key, Value>* getRight() const override;
 
+	// The next and previous nodes in key order, found by walking the tree like the
+	// base Node does. ThreadedAVLNode overrides these to follow stored threads.
+	virtual AVLNode<Key, Value>* getSuccessor() const override;
+	virtual AVLNode<Key, Value>* getPredecessor() const override;
+
+	// Copies the height and subtree size as well as the item
+	virtual AVLNode<Key, Value>* clone(Node<Key, Value>* parent) const override;
+
+	// Used by AVLTree::compact(). getNodeBytes is the size of the node's own type,
+	// and relocate constructs the node again in the memory at place (getNodeBytes()
+	// bytes) with no links at all. The item is moved there when moving cannot throw
+	// and copied otherwise, so a relocate that throws leaves this node unchanged.
+	virtual std::size_t getNodeBytes() const;
+	virtual AVLNode<Key, Value>* relocate(void* place);
+
 protected:
 	int mHeight;
+	int mSize;
 };
 
 /*
@@ -42,12 +70,26 @@ Begin implementations for the AVLNode class.
 */
 
 /**
-* Constructor for an AVLNode. Nodes are initialized with a height of 0.
+* Constructor for an AVLNode. Nodes are initialized with a height of 0 and a
+* subtree size of 1 (the node itself).
 */
 template<typename Key, typename Value>
 AVLNode<Key, Value>::AVLNode(const Key& key, const Value& value, AVLNode<Key, Value>* parent)
 	: Node<Key, Value>(key, value, parent)
 	, mHeight(0)
+	, mSize(1)
+{
+
+}
+
+/**
+* Constructor that moves the item into the node.
+*/
+template<typename Key, typename Value>
+AVLNode<Key, Value>::AVLNode(std::pair<Key, Value> item, AVLNode<Key, Value>* parent)
+	: Node<Key, Value>(std::move(item), parent)
+	, mHeight(0)
+	, mSize(1)
 {
 
 }
@@ -79,6 +121,24 @@ void AVLNode<Key, Value>::setHeight(int height)
 	mHeight = height;
 }
 
+/**
+* Getter function for the subtree size. 
+*/
+template<typename Key, typename Value>
+int AVLNode<Key, Value>::getSize() const
+{
+	return mSize;
+}
+
+/**
+* Setter function for the subtree size. 
+*/
+template<typename Key, typename Value>
+void AVLNode<Key, Value>::setSize(int size)
+{
+	mSize = size;
+}
+
 /**
 * Getter function for the parent. Used since the node inherits from a base node.
 */
@@ -106,6 +166,63 @@ AVLNode<Key, Value>* AVLNode<Key, Value>::getRight() const
 	return static_cast<AVLNode<Key,Value>*>(this->mRight);
 }
 
+/**
+* Getter function for the next node in key order. Used since the node inherits
+* from a base node.
+*/
+template<typename Key, typename Value>
+AVLNode<Key, Value>* AVLNode<Key, Value>::getSuccessor() const
+{
+	return static_cast<AVLNode<Key, Value>*>(Node<Key, Value>::getSuccessor());
+}
+
+/**
+* Getter function for the previous node in key order. Used since the node
+* inherits from a base node.
+*/
+template<typename Key, typename Value>
+AVLNode<Key, Value>* AVLNode<Key, Value>::getPredecessor() const
+{
+	return static_cast<AVLNode<Key, Value>*>(Node<Key, Value>::getPredecessor());
+}
+
+/**
+* Allocates a copy of this node with the given parent and no children.
+*/
+template<typename Key, typename Value>
+AVLNode<Key, Value>* AVLNode<Key, Value>::clone(Node<Key, Value>* parent) const
+{
+	AVLNode<Key, Value>* copy = new AVLNode<Key, Value>(this->getKey(), this->getValue(), static_cast<AVLNode<Key, Value>*>(parent));
+
+	copy->setHeight(mHeight);
+	copy->setSize(mSize);
+
+	return copy;
+}
+
+/**
+* Returns the number of bytes an AVLNode takes.
+*/
+template<typename Key, typename Value>
+std::size_t AVLNode<Key, Value>::getNodeBytes() const
+{
+	return sizeof(AVLNode<Key, Value>);
+}
+
+/**
+* Moves this node to place with no parent or children.
+*/
+template<typename Key, typename Value>
+AVLNode<Key, Value>* AVLNode<Key, Value>::relocate(void* place)
+{
+	AVLNode<Key, Value>* copy = new (place) AVLNode<Key, Value>(std::move_if_noexcept(this->getItem()), NULL);
+
+	copy->setHeight(mHeight);
+	copy->setSize(mSize);
+
+	return copy;
+}
+
 /*
 ------------------------------------------
 End implementations for the AVLNode class.
@@ -119,10 +236,153 @@ template <class Key, class Value>
 class AVLTree : public BinarySearchTree<Key, Value>
 {
 public:
+	AVLTree();
+
+	// Copies keep the shape, heights and subtree sizes of the original without any
+	// comparisons or rotations. Moves are O(1) and leave the source empty.
+	AVLTree(const AVLTree<Key, Value>& other);
+	AVLTree(AVLTree<Key, Value>&& other) noexcept;
+	AVLTree<Key, Value>& operator=(const AVLTree<Key, Value>& other);
+	AVLTree<Key, Value>& operator=(AVLTree<Key, Value>&& other) noexcept;
+
+	// Frees the nodes here rather than in BinarySearchTree, so that nodes placed
+	// by compact() go back through destroyNode()
+	~AVLTree();
+
 	// Methods for inserting/removing elements from the tree. You must implement
 	// both of these methods. 
 	virtual void insert(const std::pair<Key, Value>& keyValuePair) override;
 	void remove(const Key& key);
+	virtual void clear() override;
+
+	typedef typename BinarySearchTree<Key, Value>::iterator iterator;
+	typedef typename BinarySearchTree<Key, Value>::const_iterator const_iterator;
+
+	// Inserts keyValuePair using hint like std::map does. If the key belongs right
+	// before or right after hint (or after the largest item, for end()), it is linked
+	// in without searching from the root. Returns an iterator to the item with the key.
+	iterator insert(iterator hint, const std::pair<Key, Value>& keyValuePair);
+
+	// Appends an item whose key is larger than every key in the tree by linking it
+	// under the largest node, with one comparison and no search. insert takes the
+	// same path when it sees such a key. A key that is not the largest is inserted
+	// normally.
+	void push_back(const std::pair<Key, Value>& keyValuePair);
+
+	// When enabled, insert and find start at the last accessed node and only climb
+	// as far as needed, so nearly sorted streams skip the descent from the root.
+	// Disabled by default.
+	void setFingerSearch(bool enabled);
+
+	using BinarySearchTree<Key, Value>::find;
+	iterator find(const Key& key);
+
+	// Order statistics. These use the subtree sizes stored in every AVLNode
+	// and run in O(log n), except for size() which is O(1).
+	int size() const;
+	iterator select(int k);
+	const_iterator select(int k) const;
+	int rank(const Key& key) const;
+	int count_range(const Key& lo, const Key& hi) const;
+
+	// Copies every item into an immutable snapshot laid out as one array in
+	// breadth-first order, which is faster to search than the tree. O(n). Later
+	// changes to the tree do not affect the snapshot.
+	EytzingerSnapshot<Key, Value> freeze() const;
+
+	// Copies every item into an immutable sorted array searched with a learned
+	// index whose predictions are within epsilon positions. Integer keys only.
+	LearnedIndexSnapshot<Key, Value> freezeLearned(int epsilon = 32) const;
+
+	// Node layouts for compact()
+	enum CompactLayout {
+		// Key order, so a scan reads memory from front to back
+		IN_ORDER,
+
+		// The top half of the levels is stored first, followed by each subtree
+		// hanging below it, with the same split applied inside every part. A search
+		// from the root reads few blocks whatever the cache line or page size.
+		VAN_EMDE_BOAS
+	};
+
+	// Moves every node into one newly allocated block in the given layout, fixing
+	// up all the links, and frees the old nodes. O(n). Every iterator into the tree
+	// is invalidated. The tree keeps working as before: nodes inserted later are
+	// allocated one by one, and a block is freed once all of its nodes are removed.
+	void compact(CompactLayout layout = IN_ORDER);
+
+	// When churn > 0, insert and remove compact the tree on their own once the
+	// number of inserts and removes since the last compaction is more than churn
+	// times the size, which makes each of them invalidate iterators. Disabled by
+	// default.
+	void setAutoCompact(double churn, CompactLayout layout = IN_ORDER);
+
+	// Number of single rotations this tree has done (a double rotation counts as
+	// two), for comparing rebalancing cost between trees
+	long long rotations() const;
+
+	// Removes every item with lo <= key < hi in O(log n + k) and returns how many
+	// items were removed
+	int erase(const Key& lo, const Key& hi);
+
+	// erase(iterator) from BinarySearchTree, which rebalances through removeNode
+	using BinarySearchTree<Key, Value>::erase;
+
+	// Changes the key of the item at pos without moving its node, for keys that are
+	// replaced by ones that sort the same, like the smallest key of a range. key must
+	// still be larger than the previous key and smaller than the next one, which is
+	// asserted. O(log n), for recomputing the subtree data above the node.
+	void rekey(iterator pos, const Key& key);
+
+	// Moves every item of other into this tree in O(n + m) and leaves other empty.
+	// The nodes of both trees are reused rather than reallocated. For a key in both
+	// trees the value from other wins, as if its items had been inserted. other
+	// must be the same kind of tree as this one.
+	void merge(AVLTree<Key, Value>& other);
+
+	// The same, but for a key in both trees the value kept is
+	// combine(value in this tree, value in other)
+	template <typename Combine>
+	void merge(AVLTree<Key, Value>& other, Combine combine);
+
+protected:
+	// Allocates an AVLNode for insert. Augmented trees override this to allocate
+	// a node type that also stores their summary.
+	virtual AVLNode<Key, Value>* createNode(const Key& key, const Value& value, Node<Key, Value>* parent) override;
+
+	// Frees a node, either on its own or as part of a block made by compact()
+	virtual void destroyNode(Node<Key, Value>* node) override;
+
+	// Recomputes the subtree size of a node from its children. Augmented trees
+	// override this to recompute their summary as well.
+	virtual void updateNode(AVLNode<Key, Value>* node);
+
+	// Unlinks a node and rebalances the tree
+	virtual void removeNode(Node<Key, Value>* node) override;
+
+	// Recomputes every height and subtree size after rebalance()
+	virtual void rebuildNodeData() override;
+
+	// Recomputes the subtree data of a node and all of its ancestors. Trees that
+	// change a value in place call this so derived data stays correct.
+	void updatePath(AVLNode<Key, Value>* node);
+
+	// Hooks for in-order threads. AVLTree keeps none, so these do nothing, and
+	// ThreadedAVLTree overrides them. linkThreads splices a newly inserted leaf in
+	// next to its parent, unlinkThreads splices out the nodes from first to last in
+	// key order before they are removed, and rebuildThreads links every node to
+	// its neighbours after bulk changes.
+	virtual void linkThreads(AVLNode<Key, Value>* newNode);
+	virtual void unlinkThreads(AVLNode<Key, Value>* first, AVLNode<Key, Value>* last);
+	virtual void rebuildThreads();
+
+	// Returns the node holding key, or else the node key would be linked under, or
+	// NULL for an empty tree. Together with insertAt this inserts or updates with a
+	// single descent from the root.
+	AVLNode<Key, Value>* locate(const Key& key) const;
+
+	// Links keyValuePair under parent (or updates parent's value if it has the key)
+	AVLNode<Key, Value>* insertAt(AVLNode<Key, Value>* parent, const std::pair<Key, Value>& keyValuePair);
 
 private:
 	/* Helper functions are strongly encouraged to help separate the problem
@@ -132,11 +392,106 @@ private:
 	void LRRotation(AVLNode<Key, Value>* x, AVLNode<Key, Value>* y, AVLNode<Key, Value>* z);
 	void RLRotation(AVLNode<Key, Value>* x, AVLNode<Key, Value>* y, AVLNode<Key, Value>* z);
 
-	// This function will insert an AVLNode into the tree
-	void insertHelper(const std::pair<Key, Value>& keyValuePair);
+	// This function will insert an AVLNode into the tree and return it, or return
+	// NULL if the key was already present
+	AVLNode<Key, Value>* insertHelper(const std::pair<Key, Value>& keyValuePair);
 
 	// This function will remove an AVLNode and update all heights
-	AVLNode<Key, Value>* removeHelper(const Key& key);
+	AVLNode<Key, Value>* removeHelper(AVLNode<Key, Value>* nodeToDelete);
+
+	// Returns the subtree size of a node, or 0 for NULL
+	static int getSubtreeSize(AVLNode<Key, Value>* node);
+
+	// Finds the k-th smallest node for select
+	AVLNode<Key, Value>* selectNode(int k) const;
+
+	// Updates the heights and subtree data above a newly linked leaf and
+	// rebalances the tree
+	void rebalanceInsert(AVLNode<Key, Value>* insertedAVLNode);
+
+	// Helpers for hinted insert and finger search. Each returns the node holding
+	// key if there is one, or else the node the key would be linked under.
+
+	// Checks the slots next to near, returns NULL if key does not belong there
+	static AVLNode<Key, Value>* adjacentParent(AVLNode<Key, Value>* near, const Key& key);
+
+	// Ordinary search starting at the root of a subtree
+	static AVLNode<Key, Value>* descend(AVLNode<Key, Value>* from, const Key& key);
+
+	// Climbs from mFinger to the lowest ancestor whose subtree can hold key, then descends
+	AVLNode<Key, Value>* fingerLocate(const Key& key) const;
+
+	// Builds a perfectly balanced subtree from nodes[first, last), which are in key
+	// order, and returns its root
+	AVLNode<Key, Value>* buildBalanced(std::vector<AVLNode<Key, Value>*>& nodes, int first, int last);
+
+	// The default merge policy, which keeps the value from the other tree
+	static Value keepOther(const Value& mine, const Value& theirs);
+
+	// Helpers for split/join based bulk operations. These work on detached
+	// subtrees and return the root of the resulting subtree.
+
+	// Returns the height of a node, or 0 for NULL
+	static int getSubtreeHeight(AVLNode<Key, Value>* node);
+
+	// Makes left and right the children of node and recomputes node's height and subtree data
+	void attach(AVLNode<Key, Value>* node, AVLNode<Key, Value>* left, AVLNode<Key, Value>* right);
+
+	// Single rotations of a detached subtree
+	AVLNode<Key, Value>* rotateLeftAt(AVLNode<Key, Value>* node);
+	AVLNode<Key, Value>* rotateRightAt(AVLNode<Key, Value>* node);
+
+	// Joins left, mid and right where every key in left < mid < every key in right
+	AVLNode<Key, Value>* join(AVLNode<Key, Value>* left, AVLNode<Key, Value>* mid, AVLNode<Key, Value>* right);
+	AVLNode<Key, Value>* joinRight(AVLNode<Key, Value>* left, AVLNode<Key, Value>* mid, AVLNode<Key, Value>* right);
+	AVLNode<Key, Value>* joinLeft(AVLNode<Key, Value>* left, AVLNode<Key, Value>* mid, AVLNode<Key, Value>* right);
+
+	// Joins left and right where every key in left < every key in right
+	AVLNode<Key, Value>* join2(AVLNode<Key, Value>* left, AVLNode<Key, Value>* right);
+
+	// Detaches the largest node of a subtree, returning the rest of the subtree
+	AVLNode<Key, Value>* splitLast(AVLNode<Key, Value>* root, AVLNode<Key, Value>*& last);
+
+	// Splits a subtree into keys < key and keys >= key
+	void split(AVLNode<Key, Value>* root, const Key& key, AVLNode<Key, Value>*& less, AVLNode<Key, Value>*& notLess);
+
+	// Helpers for compact(). gatherVanEmdeBoas appends the top height levels of
+	// a subtree in van Emde Boas order, gatherAtDepth appends the nodes depth levels
+	// below root from left to right.
+	static void gatherVanEmdeBoas(AVLNode<Key, Value>* root, int height, std::vector<AVLNode<Key, Value>*>& order);
+	static void gatherAtDepth(AVLNode<Key, Value>* root, int depth, std::vector<AVLNode<Key, Value>*>& nodes);
+
+	// Returns the copy of a node that compact() has numbered, or NULL for NULL
+	static AVLNode<Key, Value>* relocated(const std::vector<AVLNode<Key, Value>*>& copies, AVLNode<Key, Value>* node);
+
+	// Counts an insert or remove and compacts the tree if automatic compaction is due
+	void autoCompact();
+
+	// A block of nodes allocated by compact() and how many of them are still in use
+	struct NodeArena
+	{
+		char* mBlock;
+		std::size_t mBytes;
+		int mLive;
+	};
+
+	// Orders blocks by address
+	static bool arenaBefore(const NodeArena& lhs, const NodeArena& rhs);
+
+	// Whether finger search is enabled, and the last node inserted or found (or NULL)
+	bool mFingerSearch;
+	AVLNode<Key, Value>* mFinger;
+
+	// Rotations done by this tree
+	long long mRotations;
+
+	// Blocks made by compact() that still hold nodes of this tree, sorted by address
+	std::vector<NodeArena> mArenas;
+
+	// Automatic compaction settings and the inserts and removes since the last one
+	double mAutoCompactChurn;
+	CompactLayout mAutoCompactLayout;
+	int mChangesSinceCompact;
 };
 
 /*
@@ -145,11 +500,127 @@ Begin implementations for the AVLTree class.
 --------------------------------------------
 */
 
+/**
+* Default constructor for an AVLTree. Finger search starts disabled.
+*/
+template<typename Key, typename Value>
+AVLTree<Key, Value>::AVLTree()
+	: mFingerSearch(false)
+	, mFinger(NULL)
+	, mRotations(0)
+	, mAutoCompactChurn(0)
+	, mAutoCompactLayout(IN_ORDER)
+	, mChangesSinceCompact(0)
+{
+
+}
+
+/**
+* Copy constructor. The nodes are cloned by BinarySearchTree. The finger and the
+* rotation count are not copied, and the copied nodes are allocated one by one
+* even if other has been compacted.
+*/
+template<typename Key, typename Value>
+AVLTree<Key, Value>::AVLTree(const AVLTree<Key, Value>& other)
+	: BinarySearchTree<Key, Value>(other)
+	, mFingerSearch(other.mFingerSearch)
+	, mFinger(NULL)
+	, mRotations(0)
+	, mAutoCompactChurn(other.mAutoCompactChurn)
+	, mAutoCompactLayout(other.mAutoCompactLayout)
+	, mChangesSinceCompact(0)
+{
+
+}
+
+/**
+* Move constructor. The finger and the blocks made by compact() move
+* along with the nodes.
+*/
+template<typename Key, typename Value>
+AVLTree<Key, Value>::AVLTree(AVLTree<Key, Value>&& other) noexcept
+	: BinarySearchTree<Key, Value>(std::move(other))
+	, mFingerSearch(other.mFingerSearch)
+	, mFinger(other.mFinger)
+	, mRotations(other.mRotations)
+	, mArenas(std::move(other.mArenas))
+	, mAutoCompactChurn(other.mAutoCompactChurn)
+	, mAutoCompactLayout(other.mAutoCompactLayout)
+	, mChangesSinceCompact(other.mChangesSinceCompact)
+{
+	other.mFinger = NULL;
+	other.mArenas.clear();
+}
+
+/**
+* Destructor.
+*/
+template<typename Key, typename Value>
+AVLTree<Key, Value>::~AVLTree()
+{
+	clear();
+}
+
+/**
+* Copy assignment.
+*/
+template<typename Key, typename Value>
+AVLTree<Key, Value>& AVLTree<Key, Value>::operator=(const AVLTree<Key, Value>& other)
+{
+	// Self assignment
+	if (this == &other) {
+		return *this;
+	}
+
+	BinarySearchTree<Key, Value>::operator=(other);
+
+	mFingerSearch = other.mFingerSearch;
+	mFinger = NULL;
+	mAutoCompactChurn = other.mAutoCompactChurn;
+	mAutoCompactLayout = other.mAutoCompactLayout;
+	mChangesSinceCompact = 0;
+
+	rebuildThreads();
+
+	return *this;
+}
+
+/**
+* Move assignment.
+*/
+template<typename Key, typename Value>
+AVLTree<Key, Value>& AVLTree<Key, Value>::operator=(AVLTree<Key, Value>&& other) noexcept
+{
+	// Self assignment
+	if (this == &other) {
+		return *this;
+	}
+
+	BinarySearchTree<Key, Value>::operator=(std::move(other));
+
+	mFingerSearch = other.mFingerSearch;
+	mFinger = other.mFinger;
+	mRotations = other.mRotations;
+	mAutoCompactChurn = other.mAutoCompactChurn;
+	mAutoCompactLayout = other.mAutoCompactLayout;
+	mChangesSinceCompact = other.mChangesSinceCompact;
+
+	// Clearing this tree has given back all of its own blocks
+	mArenas = std::move(other.mArenas);
+
+	other.mFinger = NULL;
+	other.mArenas.clear();
+
+	return *this;
+}
+
 /**
 * This helper function performs left zig-zig rotation on nodes x,y and z
 */
 template<typename Key, typename Value>
 void AVLTree<Key, Value>::LLRotation(AVLNode<Key, Value>* x, AVLNode<Key, Value>* y, AVLNode<Key, Value>* z) {
+	++mRotations;
+
 	// if Z has no parent
 	if (z->getParent() == NULL) {
 		// Save y's right child if it exists 
@@ -281,6 +752,11 @@ void AVLTree<Key, Value>::LLRotation(AVLNode<Key, Value>* x, AVLNode<Key, Value>
 			y->getParent()->setHeight(y->getHeight() + 1);
 		}
 	}
+
+	// Recompute subtree sizes bottom-up. The size of the rotated subtree as a
+	// whole does not change, so ancestors do not need to be updated
+	updateNode(z);
+	updateNode(y);
 }
 
 /**
@@ -288,6 +764,8 @@ void AVLTree<Key, Value>::LLRotation(AVLNode<Key, Value>* x, AVLNode<Key, Value>
 */
 template<typename Key, typename Value>
 void AVLTree<Key, Value>::RRRotation(AVLNode<Key, Value>* x, AVLNode<Key, Value>* y, AVLNode<Key, Value>* z) {
+	++mRotations;
+
 	// if Z has no parent
 	if (z->getParent() == NULL) {
 		// Save y's left child if it exists 
@@ -418,6 +896,11 @@ void AVLTree<Key, Value>::RRRotation(AVLNode<Key, Value>* x, AVLNode<Key, Value>
 			y->getParent()->setHeight(y->getHeight() + 1);
 		}
 	}
+
+	// Recompute subtree sizes bottom-up. The size of the rotated subtree as a
+	// whole does not change, so ancestors do not need to be updated
+	updateNode(z);
+	updateNode(y);
 }
 
 /**
@@ -425,6 +908,8 @@ void AVLTree<Key, Value>::RRRotation(AVLNode<Key, Value>* x, AVLNode<Key, Value>
 */
 template<typename Key, typename Value>
 void AVLTree<Key, Value>::LRRotation(AVLNode<Key, Value>* x, AVLNode<Key, Value>* y, AVLNode<Key, Value>* z) {
+	mRotations += 2;
+
 	// If z does not have a parent
 	if (z->getParent() == NULL) {
 		if (x->getLeft() != NULL) {
@@ -638,6 +1123,12 @@ void AVLTree<Key, Value>::LRRotation(AVLNode<Key, Value>* x, AVLNode<Key, Value>
 			x->getParent()->setHeight(x->getHeight() + 1);
 		}
 	}
+
+	// Recompute subtree sizes bottom-up. The size of the rotated subtree as a
+	// whole does not change, so ancestors do not need to be updated
+	updateNode(y);
+	updateNode(z);
+	updateNode(x);
 }
 
 /**
@@ -645,6 +1136,8 @@ void AVLTree<Key, Value>::LRRotation(AVLNode<Key, Value>* x, AVLNode<Key, Value>
 */
 template<typename Key, typename Value>
 void AVLTree<Key, Value>::RLRotation(AVLNode<Key, Value>* x, AVLNode<Key, Value>* y, AVLNode<Key, Value>* z) {
+	mRotations += 2;
+
 	// If z does not have a parent
 	if (z->getParent() == NULL) {
 		if (x->getLeft() != NULL) {
@@ -858,21 +1351,30 @@ void AVLTree<Key, Value>::RLRotation(AVLNode<Key, Value>* x, AVLNode<Key, Value>
 			x->getParent()->setHeight(x->getHeight() + 1);
 		}
 	}
+
+	// Recompute subtree sizes bottom-up. The size of the rotated subtree as a
+	// whole does not change, so ancestors do not need to be updated
+	updateNode(y);
+	updateNode(z);
+	updateNode(x);
 }
 
 /**
-* This function will do BST insert on an AVLNode rather than Node
+* This function will do BST insert on an AVLNode rather than Node. Returns the
+* newly inserted node, or NULL if the key already existed and only its value was updated.
 */
 template<typename Key, typename Value>
-void AVLTree<Key, Value>::insertHelper(const std::pair<Key, Value>& keyValuePair) {
+AVLNode<Key, Value>* AVLTree<Key, Value>::insertHelper(const std::pair<Key, Value>& keyValuePair) {
 	// If the BST is empty
 	if (BinarySearchTree<Key, Value>::mRoot == NULL) {
 		// Create new node with keyValuePair's information
 		// Set Parent to null
-		Node<Key, Value>* newNode = new AVLNode<Key, Value>(keyValuePair.first, keyValuePair.second, NULL);
+		AVLNode<Key, Value>* newNode = createNode(keyValuePair.first, keyValuePair.second, NULL);
 
 		// Add new node to BST as root
 		BinarySearchTree<Key, Value>::mRoot = newNode;
+
+		return newNode;
 	}
 
 	// If BST has only one node
@@ -881,13 +1383,16 @@ void AVLTree<Key, Value>::insertHelper(const std::pair<Key, Value>& keyValuePair
 		if (keyValuePair.first == BinarySearchTree<Key, Value>::mRoot->getKey()) {
 			// Update root's value
 			BinarySearchTree<Key, Value>::mRoot->setValue(keyValuePair.second);
-			return;
+
+			// The value changed, so any data derived from it must be recomputed
+			updateNode(static_cast<AVLNode<Key, Value>*>(BinarySearchTree<Key, Value>::mRoot));
+			return NULL;
 		}
 
 		// Create new node with keyValuePair's information
 		// Set Parent to mRoot
-		Node<Key, Value>* newNode = new AVLNode<Key, Value>(keyValuePair.first, 
-			keyValuePair.second, static_cast<AVLNode<Key, Value>*>(BinarySearchTree<Key, Value>::mRoot));
+		AVLNode<Key, Value>* newNode = createNode(keyValuePair.first, 
+			keyValuePair.second, BinarySearchTree<Key, Value>::mRoot);
 
 		// If new node is lesser than root
 		if (newNode->getKey() < BinarySearchTree<Key, Value>::mRoot->getKey()) {
@@ -900,6 +1405,8 @@ void AVLTree<Key, Value>::insertHelper(const std::pair<Key, Value>& keyValuePair
 			// Set newNode as root's right child
 			BinarySearchTree<Key, Value>::mRoot->setRight(newNode);
 		}
+
+		return newNode;
 	}
 
 	// If BST has more than one node
@@ -912,7 +1419,7 @@ void AVLTree<Key, Value>::insertHelper(const std::pair<Key, Value>& keyValuePair
 		// Create new node with keyValuePair's information
 		// Set Parent to NULL (Will be changed after we find where to
 		// insert in tree)
-		Node<Key, Value>* newNode = new AVLNode<Key, Value>(keyValuePair.first, keyValuePair.second, NULL);
+		AVLNode<Key, Value>* newNode = createNode(keyValuePair.first, keyValuePair.second, NULL);
 
 		// While loop to find location to add newNode
 		while(currNode != NULL) {
@@ -920,7 +1427,13 @@ void AVLTree<Key, Value>::insertHelper(const std::pair<Key, Value>& keyValuePair
 			if (newNode->getKey() == currNode->getKey()) {
 				// Update currNode's value
 				currNode->setValue(newNode->getValue());
-				return;
+
+				// The value changed, so any data derived from it must be recomputed
+				updatePath(static_cast<AVLNode<Key, Value>*>(currNode));
+
+				// newNode was never linked into the tree
+				this->destroyNode(newNode);
+				return NULL;
 			}
 
 			// If new node is lesser than currNode
@@ -952,6 +1465,8 @@ void AVLTree<Key, Value>::insertHelper(const std::pair<Key, Value>& keyValuePair
 		else {
 			prevNode->setRight(newNode);
 		}
+
+		return newNode;
 	}
 }
 
@@ -961,8 +1476,50 @@ void AVLTree<Key, Value>::insertHelper(const std::pair<Key, Value>& keyValuePair
 template<typename Key, typename Value>
 void AVLTree<Key, Value>::insert(const std::pair<Key, Value>& keyValuePair)
 {
+	autoCompact();
+
+	AVLNode<Key, Value>* largest = static_cast<AVLNode<Key, Value>*>(BinarySearchTree<Key, Value>::getLargestNode());
+
+	// Increasing keys are appended under the largest node without a search
+	if (largest != NULL && largest->getKey() < keyValuePair.first) {
+		insertAt(largest, keyValuePair);
+
+		return;
+	}
+
+	// Start from the last accessed node instead of the root
+	if (mFingerSearch && mFinger != NULL) {
+		insertAt(fingerLocate(keyValuePair.first), keyValuePair);
+
+		return;
+	}
+
 	// Insert using BST insert
-	insertHelper(keyValuePair);
+	AVLNode<Key, Value>* insertedAVLNode = insertHelper(keyValuePair);
+
+	// If the key already existed only its value changed, so the tree is still balanced
+	if (insertedAVLNode == NULL) {
+		return;
+	}
+
+	mFinger = insertedAVLNode;
+
+	rebalanceInsert(insertedAVLNode);
+}
+
+/**
+* Updates the threads, heights and subtree data after a new leaf has been linked
+* into the tree, and then balances the tree.
+*/
+template<typename Key, typename Value>
+void AVLTree<Key, Value>::rebalanceInsert(AVLNode<Key, Value>* insertedAVLNode)
+{
+	// Splice the new node into the in-order threads
+	linkThreads(insertedAVLNode);
+	BinarySearchTree<Key, Value>::cacheInsertedNode(insertedAVLNode);
+
+	// Every ancestor of the new node gained one node in its subtree
+	updatePath(insertedAVLNode);
 
 	// If BST only has one node
 	if (BinarySearchTree<Key, Value>::mRoot->getLeft() == NULL && BinarySearchTree<Key, Value>::mRoot->getRight() == NULL) {
@@ -972,12 +1529,6 @@ void AVLTree<Key, Value>::insert(const std::pair<Key, Value>& keyValuePair)
 		return;
 	}
 
-	// Find the newly inserted node
-	Node<Key, Value>* insertedNode = BinarySearchTree<Key, Value>::internalFind(keyValuePair.first);
-
-	// Cast it to AVL node type
-	AVLNode<Key, Value>* insertedAVLNode = static_cast<AVLNode<Key, Value>*>(insertedNode);
-
 	// Set height of new AVLNode
 	insertedAVLNode->setHeight(1);
 
@@ -1012,7 +1563,14 @@ void AVLTree<Key, Value>::insert(const std::pair<Key, Value>& keyValuePair)
 
 			// If parent is balanced
 			if (balanceFactor <= 1) {
-				parentNode->setHeight(std::max(rightHeight, currNode->getHeight()) + 1);
+				int newHeight = std::max(rightHeight, currNode->getHeight()) + 1;
+
+				// If parent's height did not change no ancestor's height changed either
+				if (newHeight == parentNode->getHeight()) {
+					break;
+				}
+
+				parentNode->setHeight(newHeight);
 
 				currNode = parentNode;
 			}
@@ -1159,8 +1717,15 @@ void AVLTree<Key, Value>::insert(const std::pair<Key, Value>& keyValuePair)
 
 			// If parent is balanced
 			if (balanceFactor <= 1) {
+				int newHeight = std::max(leftHeight, currNode->getHeight()) + 1;
+
+				// If parent's height did not change no ancestor's height changed either
+				if (newHeight == parentNode->getHeight()) {
+					break;
+				}
+
 				// Update height of parent
-				parentNode->setHeight(std::max(leftHeight, currNode->getHeight()) + 1);
+				parentNode->setHeight(newHeight);
 
 				currNode = parentNode;
 			}
@@ -1441,20 +2006,7 @@ void AVLTree<Key, Value>::insert(const std::pair<Key, Value>& keyValuePair)
 * at for balancing
 */
 template<typename Key, typename Value>
-AVLNode<Key, Value>* AVLTree<Key, Value>::removeHelper(const Key& key) {
-	// Do nothing if tree is empty
-	if (BinarySearchTree<Key, Value>::mRoot == NULL) {
-		return NULL;
-	}
-
-	// Find node to delete
-	AVLNode<Key, Value>* nodeToDelete = 
-	static_cast<AVLNode<Key, Value>*>(BinarySearchTree<Key, Value>::internalFind(key));
-
-	// If node to delete does not exist do nothing
-	if (nodeToDelete == NULL) {
-		return NULL;
-	}
+AVLNode<Key, Value>* AVLTree<Key, Value>::removeHelper(AVLNode<Key, Value>* nodeToDelete) {
 
 	// Check if node to delete is the root
 	if (nodeToDelete == BinarySearchTree<Key, Value>::mRoot) {
@@ -1464,7 +2016,7 @@ AVLNode<Key, Value>* AVLTree<Key, Value>::removeHelper(const Key& key) {
 			BinarySearchTree<Key, Value>::mRoot = NULL;
 
 			// Free allocated memory
-			delete nodeToDelete;
+			this->destroyNode(nodeToDelete);
 
 			return NULL;
 		}
@@ -1501,7 +2053,7 @@ AVLNode<Key, Value>* AVLTree<Key, Value>::removeHelper(const Key& key) {
 				}
 
 				// Free allocated memory
-				delete nodeToDelete;
+				this->destroyNode(nodeToDelete);
 
 				return successor;
 			}
@@ -1542,7 +2094,7 @@ AVLNode<Key, Value>* AVLTree<Key, Value>::removeHelper(const Key& key) {
 				BinarySearchTree<Key, Value>::mRoot = successor;
 
 				// Free allocated memory
-				delete nodeToDelete;
+				this->destroyNode(nodeToDelete);
 
 				return nodeToCheck;
 			}
@@ -1577,7 +2129,7 @@ AVLNode<Key, Value>* AVLTree<Key, Value>::removeHelper(const Key& key) {
 				BinarySearchTree<Key, Value>::mRoot = successor;
 
 				// Free allocated memory
-				delete nodeToDelete;
+				this->destroyNode(nodeToDelete);
 
 				return nodeToCheck;
 			}
@@ -1596,7 +2148,7 @@ AVLNode<Key, Value>* AVLTree<Key, Value>::removeHelper(const Key& key) {
 				BinarySearchTree<Key, Value>::mRoot = nodeToDelete->getLeft();
 
 				// Free allocated memory
-				delete nodeToDelete;
+				this->destroyNode(nodeToDelete);
 
 				return nodeToCheck;
 			}
@@ -1612,7 +2164,7 @@ AVLNode<Key, Value>* AVLTree<Key, Value>::removeHelper(const Key& key) {
 				BinarySearchTree<Key, Value>::mRoot = nodeToDelete->getRight();
 
 				// Free allocated memory
-				delete nodeToDelete;
+				this->destroyNode(nodeToDelete);
 
 				return nodeToCheck;
 			}
@@ -1638,7 +2190,7 @@ AVLNode<Key, Value>* AVLTree<Key, Value>::removeHelper(const Key& key) {
 					nodeToCheck->setHeight(1);
 				}
 
-				delete nodeToDelete;
+				this->destroyNode(nodeToDelete);
 
 				return nodeToCheck;
 			}
@@ -1657,7 +2209,7 @@ AVLNode<Key, Value>* AVLTree<Key, Value>::removeHelper(const Key& key) {
 					nodeToCheck->setHeight(1);
 				}
 
-				delete nodeToDelete;
+				this->destroyNode(nodeToDelete);
 
 				return nodeToCheck;
 			}
@@ -1702,7 +2254,7 @@ AVLNode<Key, Value>* AVLTree<Key, Value>::removeHelper(const Key& key) {
 					successor->setHeight(successor->getLeft()->getHeight() + 1);
 				}
 
-				delete nodeToDelete;
+				this->destroyNode(nodeToDelete);
 
 				return nodeToCheck;
 			}
@@ -1749,7 +2301,7 @@ AVLNode<Key, Value>* AVLTree<Key, Value>::removeHelper(const Key& key) {
 					nodeToDelete->getParent()->setRight(successor);
 				}
 
-				delete nodeToDelete;
+				this->destroyNode(nodeToDelete);
 
 				return nodeToCheck;
 			}
@@ -1790,7 +2342,7 @@ AVLNode<Key, Value>* AVLTree<Key, Value>::removeHelper(const Key& key) {
 					nodeToDelete->getParent()->setRight(successor);
 				}
 
-				delete nodeToDelete;
+				this->destroyNode(nodeToDelete);
 
 				return nodeToCheck;
 			}
@@ -1830,7 +2382,7 @@ AVLNode<Key, Value>* AVLTree<Key, Value>::removeHelper(const Key& key) {
 					}
 				}
 
-				delete nodeToDelete;
+				this->destroyNode(nodeToDelete);
 
 				return nodeToCheck;
 			}
@@ -1867,7 +2419,7 @@ AVLNode<Key, Value>* AVLTree<Key, Value>::removeHelper(const Key& key) {
 					}
 				}
 
-				delete nodeToDelete;
+				this->destroyNode(nodeToDelete);
 
 				return nodeToCheck;
 			}
@@ -1881,6 +2433,8 @@ AVLNode<Key, Value>* AVLTree<Key, Value>::removeHelper(const Key& key) {
 template<typename Key, typename Value>
 void AVLTree<Key, Value>::remove(const Key& key)
 {
+	autoCompact();
+
 	// Find the node to delete
 	AVLNode<Key, Value>* nodeToDelete = 
 	static_cast<AVLNode<Key, Value>*>(BinarySearchTree<Key, Value>::internalFind(key));
@@ -1890,9 +2444,50 @@ void AVLTree<Key, Value>::remove(const Key& key)
 		return;
 	}
 
+	removeNode(nodeToDelete);
+}
+
+/**
+* Recomputes the height and subtree data of every node in post-order, so children
+* are always done before their parent. The in-order threads and the cached bounds
+* do not change when the tree is reshaped.
+*/
+template<typename Key, typename Value>
+void AVLTree<Key, Value>::rebuildNodeData() {
+	Node<Key, Value>* currNode = BinarySearchTree<Key, Value>::getPostOrderFirst(BinarySearchTree<Key, Value>::mRoot);
+
+	while (currNode != NULL) {
+		AVLNode<Key, Value>* currAVLNode = static_cast<AVLNode<Key, Value>*>(currNode);
+
+		currAVLNode->setHeight(std::max(getSubtreeHeight(currAVLNode->getLeft()), getSubtreeHeight(currAVLNode->getRight())) + 1);
+		updateNode(currAVLNode);
+
+		currNode = BinarySearchTree<Key, Value>::getPostOrderNext(currNode);
+	}
+}
+
+/**
+* Unlinks a node that is known to be in the tree and rebalances on the way back
+* up to the root. Used by remove once the node has been found and by erase,
+* which already holds the node.
+*/
+template<typename Key, typename Value>
+void AVLTree<Key, Value>::removeNode(Node<Key, Value>* node)
+{
+	AVLNode<Key, Value>* nodeToDelete = static_cast<AVLNode<Key, Value>*>(node);
+
+	// The finger must not point at a freed node
+	if (nodeToDelete == mFinger) {
+		mFinger = NULL;
+	}
+
+	// Its neighbours in key order become neighbours of each other
+	BinarySearchTree<Key, Value>::uncacheRemovedNode(nodeToDelete);
+	unlinkThreads(nodeToDelete, nodeToDelete);
+
 	// Call BST Remove
 	// To store the node where our function needs to start checking from
-	AVLNode<Key, Value>* nodeToCheck = removeHelper(key);
+	AVLNode<Key, Value>* nodeToCheck = removeHelper(nodeToDelete);
 
 	// Do nothing if tree is already balanced
 	if (nodeToCheck == NULL) {
@@ -1904,6 +2499,10 @@ void AVLTree<Key, Value>::remove(const Key& key)
 		return;
 	}
 
+	// Every ancestor of the removed position lost one node in its subtree.
+	// This has to be done before any rotation recomputes sizes from children
+	updatePath(nodeToCheck);
+
 	// Start checking if the tree is unbalanced or not
 	while (nodeToCheck != NULL) {
 		// If nodeToCheck is a leaf node
@@ -2344,6 +2943,1154 @@ void AVLTree<Key, Value>::remove(const Key& key)
 	}
 }
 
+/**
+* Returns the subtree size of a node, treating NULL as an empty subtree.
+*/
+template<typename Key, typename Value>
+int AVLTree<Key, Value>::getSubtreeSize(AVLNode<Key, Value>* node) {
+	if (node == NULL) {
+		return 0;
+	}
+
+	return node->getSize();
+}
+
+/**
+* Allocates a new AVLNode for insert.
+*/
+template<typename Key, typename Value>
+AVLNode<Key, Value>* AVLTree<Key, Value>::createNode(const Key& key, const Value& value, Node<Key, Value>* parent) {
+	return new AVLNode<Key, Value>(key, value, static_cast<AVLNode<Key, Value>*>(parent));
+}
+
+/**
+* Recomputes the subtree size of a node assuming its children are up to date.
+*/
+template<typename Key, typename Value>
+void AVLTree<Key, Value>::updateNode(AVLNode<Key, Value>* node) {
+	node->setSize(getSubtreeSize(node->getLeft()) + getSubtreeSize(node->getRight()) + 1);
+}
+
+/**
+* Recomputes the subtree data on the path from a node up to the root.
+*/
+template<typename Key, typename Value>
+void AVLTree<Key, Value>::updatePath(AVLNode<Key, Value>* node) {
+	while (node != NULL) {
+		updateNode(node);
+
+		node = node->getParent();
+	}
+}
+
+/**
+* AVLTree nodes have no threads to link.
+*/
+template<typename Key, typename Value>
+void AVLTree<Key, Value>::linkThreads(AVLNode<Key, Value>* newNode) {
+
+}
+
+/**
+* AVLTree nodes have no threads to unlink.
+*/
+template<typename Key, typename Value>
+void AVLTree<Key, Value>::unlinkThreads(AVLNode<Key, Value>* first, AVLNode<Key, Value>* last) {
+
+}
+
+/**
+* AVLTree nodes have no threads to rebuild.
+*/
+template<typename Key, typename Value>
+void AVLTree<Key, Value>::rebuildThreads() {
+
+}
+
+/**
+* Returns the number of items in the tree in O(1).
+*/
+template<typename Key, typename Value>
+int AVLTree<Key, Value>::size() const {
+	return getSubtreeSize(static_cast<AVLNode<Key, Value>*>(BinarySearchTree<Key, Value>::mRoot));
+}
+
+/**
+* Returns an iterator to the k-th smallest item in the tree (k starts at 0),
+* or the end iterator if k is out of range.
+*/
+template<typename Key, typename Value>
+typename AVLTree<Key, Value>::iterator AVLTree<Key, Value>::select(int k) {
+	return iterator(selectNode(k), this);
+}
+
+/**
+* Returns a read-only iterator to the k-th smallest item in the tree (k starts
+* at 0), or the end iterator if k is out of range.
+*/
+template<typename Key, typename Value>
+typename AVLTree<Key, Value>::const_iterator AVLTree<Key, Value>::select(int k) const {
+	return const_iterator(selectNode(k), this);
+}
+
+/**
+* Finds the k-th smallest node in the tree (k starts at 0), or NULL if k is out
+* of range.
+*/
+template<typename Key, typename Value>
+AVLNode<Key, Value>* AVLTree<Key, Value>::selectNode(int k) const {
+	AVLNode<Key, Value>* currNode = static_cast<AVLNode<Key, Value>*>(BinarySearchTree<Key, Value>::mRoot);
+
+	// If k is out of range
+	if (k < 0 || k >= getSubtreeSize(currNode)) {
+		return NULL;
+	}
+
+	while (currNode != NULL) {
+		int leftSize = getSubtreeSize(currNode->getLeft());
+
+		// If the k-th item is in the left subtree
+		if (k < leftSize) {
+			currNode = currNode->getLeft();
+		}
+
+		// If currNode is the k-th item
+		else if (k == leftSize) {
+			break;
+		}
+
+		// If the k-th item is in the right subtree, skip the left
+		// subtree and currNode
+		else {
+			k -= leftSize + 1;
+			currNode = currNode->getRight();
+		}
+	}
+
+	return currNode;
+}
+
+/**
+* Returns the number of keys in the tree that are strictly less than key. The key
+* itself does not need to be in the tree.
+*/
+template<typename Key, typename Value>
+int AVLTree<Key, Value>::rank(const Key& key) const {
+	AVLNode<Key, Value>* currNode = static_cast<AVLNode<Key, Value>*>(BinarySearchTree<Key, Value>::mRoot);
+
+	int lessCount = 0;
+
+	while (currNode != NULL) {
+		// If we have found the key, everything in the left subtree is smaller
+		if (currNode->getKey() == key) {
+			return lessCount + getSubtreeSize(currNode->getLeft());
+		}
+
+		// If key is less than currNode go to left child
+		else if (key < currNode->getKey()) {
+			currNode = currNode->getLeft();
+		}
+
+		// If key is greater than currNode, currNode and its left subtree
+		// are smaller than key
+		else {
+			lessCount += getSubtreeSize(currNode->getLeft()) + 1;
+			currNode = currNode->getRight();
+		}
+	}
+
+	return lessCount;
+}
+
+/**
+* Returns the number of keys k in the tree with lo <= k < hi.
+*/
+template<typename Key, typename Value>
+int AVLTree<Key, Value>::count_range(const Key& lo, const Key& hi) const {
+	// Empty range
+	if (!(lo < hi)) {
+		return 0;
+	}
+
+	return rank(hi) - rank(lo);
+}
+
+/**
+* Copies the items into a snapshot in key order.
+*/
+template<typename Key, typename Value>
+EytzingerSnapshot<Key, Value> AVLTree<Key, Value>::freeze() const {
+	return EytzingerSnapshot<Key, Value>(this->begin(), size());
+}
+
+/**
+* Copies the items into a learned index snapshot in key order.
+*/
+template<typename Key, typename Value>
+LearnedIndexSnapshot<Key, Value> AVLTree<Key, Value>::freezeLearned(int epsilon) const {
+	return LearnedIndexSnapshot<Key, Value>(this->begin(), size(), epsilon);
+}
+
+/**
+* Stores the nodes in one block in the order of the layout. Every node is moved
+* into its slot first. The old nodes are then numbered by their place in the
+* order, through their subtree size fields since they are about to be freed, and
+* each copy is linked to the copies at the numbers of the old node's links. The
+* tree, the cached bounds and the finger keep their shape. The old nodes are freed
+* last, which also gives back any earlier blocks.
+*/
+template<typename Key, typename Value>
+void AVLTree<Key, Value>::compact(CompactLayout layout) {
+	AVLNode<Key, Value>* root = static_cast<AVLNode<Key, Value>*>(BinarySearchTree<Key, Value>::mRoot);
+
+	mChangesSinceCompact = 0;
+
+	// Nothing to move
+	if (root == NULL) {
+		return;
+	}
+
+	// Put the nodes in the order they will have in memory
+	std::vector<AVLNode<Key, Value>*> order;
+	order.reserve(BinarySearchTree<Key, Value>::mNodeCount);
+
+	if (layout == IN_ORDER) {
+		for (AVLNode<Key, Value>* currNode = static_cast<AVLNode<Key, Value>*>(BinarySearchTree<Key, Value>::getSmallestNode());
+			currNode != NULL; currNode = currNode->getSuccessor()) {
+			order.push_back(currNode);
+		}
+	}
+
+	else {
+		gatherVanEmdeBoas(root, getSubtreeHeight(root), order);
+	}
+
+	// Every slot fits the largest node type and keeps the alignment new gives
+	std::size_t stride = 0;
+
+	for (unsigned int i = 0; i < order.size(); ++i) {
+		stride = std::max(stride, order[i]->getNodeBytes());
+	}
+
+	stride = (stride + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+	// Everything that can fail to allocate is done before the tree changes
+	std::vector<AVLNode<Key, Value>*> copies;
+	copies.reserve(order.size());
+	mArenas.reserve(mArenas.size() + 1);
+
+	NodeArena arena;
+	arena.mBytes = stride * order.size();
+	arena.mBlock = static_cast<char*>(::operator new(arena.mBytes));
+	arena.mLive = static_cast<int>(order.size());
+
+	// Move every node into its slot. Nodes only give up their items when that
+	// cannot throw, so if a relocate throws every old node is still whole and only
+	// the copies made so far and the block need to be freed.
+	try {
+		for (unsigned int i = 0; i < order.size(); ++i) {
+			copies.push_back(order[i]->relocate(arena.mBlock + i * stride));
+		}
+	}
+
+	catch (...) {
+		for (unsigned int i = 0; i < copies.size(); ++i) {
+			copies[i]->~AVLNode();
+		}
+
+		::operator delete(arena.mBlock);
+		throw;
+	}
+
+	// Number the old nodes, whose subtree sizes are no longer needed
+	for (unsigned int i = 0; i < order.size(); ++i) {
+		order[i]->setSize(static_cast<int>(i));
+	}
+
+	// Link the copies to each other the way the old nodes are linked
+	for (unsigned int i = 0; i < order.size(); ++i) {
+		copies[i]->setParent(relocated(copies, order[i]->getParent()));
+		copies[i]->setLeft(relocated(copies, order[i]->getLeft()));
+		copies[i]->setRight(relocated(copies, order[i]->getRight()));
+	}
+
+	BinarySearchTree<Key, Value>::mRoot = relocated(copies, root);
+	BinarySearchTree<Key, Value>::mMin = relocated(copies, static_cast<AVLNode<Key, Value>*>(BinarySearchTree<Key, Value>::mMin));
+	BinarySearchTree<Key, Value>::mMax = relocated(copies, static_cast<AVLNode<Key, Value>*>(BinarySearchTree<Key, Value>::mMax));
+	mFinger = relocated(copies, mFinger);
+
+	rebuildThreads();
+
+	// The old nodes are no longer part of the tree
+	for (unsigned int i = 0; i < order.size(); ++i) {
+		this->destroyNode(order[i]);
+	}
+
+	// Keep the blocks sorted by address for destroyNode()
+	mArenas.insert(std::upper_bound(mArenas.begin(), mArenas.end(), arena, arenaBefore), arena);
+}
+
+/**
+* Returns the copy of a node numbered by compact(), or NULL for NULL.
+*/
+template<typename Key, typename Value>
+AVLNode<Key, Value>* AVLTree<Key, Value>::relocated(const std::vector<AVLNode<Key, Value>*>& copies, AVLNode<Key, Value>* node) {
+	return (node == NULL) ? NULL : copies[node->getSize()];
+}
+
+/**
+* Orders blocks by their address.
+*/
+template<typename Key, typename Value>
+bool AVLTree<Key, Value>::arenaBefore(const NodeArena& lhs, const NodeArena& rhs) {
+	return std::less<const char*>()(lhs.mBlock, rhs.mBlock);
+}
+
+/**
+* Appends the top height levels of the subtree at root in van Emde Boas order:
+* the top half of the levels first, then every subtree hanging below them from
+* left to right, each laid out the same way.
+*/
+template<typename Key, typename Value>
+void AVLTree<Key, Value>::gatherVanEmdeBoas(AVLNode<Key, Value>* root, int height, std::vector<AVLNode<Key, Value>*>& order) {
+	// Empty subtree
+	if (root == NULL || height <= 0) {
+		return;
+	}
+
+	// A single level is just the root
+	if (height == 1) {
+		order.push_back(root);
+		return;
+	}
+
+	int topHeight = height / 2;
+
+	gatherVanEmdeBoas(root, topHeight, order);
+
+	std::vector<AVLNode<Key, Value>*> bottoms;
+	gatherAtDepth(root, topHeight, bottoms);
+
+	for (unsigned int i = 0; i < bottoms.size(); ++i) {
+		gatherVanEmdeBoas(bottoms[i], height - topHeight, order);
+	}
+}
+
+/**
+* Appends the nodes exactly depth levels below root, from left to right.
+*/
+template<typename Key, typename Value>
+void AVLTree<Key, Value>::gatherAtDepth(AVLNode<Key, Value>* root, int depth, std::vector<AVLNode<Key, Value>*>& nodes) {
+	// Empty subtree
+	if (root == NULL) {
+		return;
+	}
+
+	// Reached the level
+	if (depth == 0) {
+		nodes.push_back(root);
+		return;
+	}
+
+	gatherAtDepth(root->getLeft(), depth - 1, nodes);
+	gatherAtDepth(root->getRight(), depth - 1, nodes);
+}
+
+/**
+* Sets how much churn triggers an automatic compact(). 0 turns it off.
+*/
+template<typename Key, typename Value>
+void AVLTree<Key, Value>::setAutoCompact(double churn, CompactLayout layout) {
+	mAutoCompactChurn = churn;
+	mAutoCompactLayout = layout;
+	mChangesSinceCompact = 0;
+}
+
+/**
+* Counts one insert or remove. Once the count passes churn times the size, the
+* tree is compacted, so the cost of compacting is spread over the changes that
+* scattered the nodes.
+*/
+template<typename Key, typename Value>
+void AVLTree<Key, Value>::autoCompact() {
+	// Automatic compaction is off
+	if (mAutoCompactChurn <= 0) {
+		return;
+	}
+
+	++mChangesSinceCompact;
+
+	if (mChangesSinceCompact > mAutoCompactChurn * size()) {
+		compact(mAutoCompactLayout);
+	}
+}
+
+/**
+* Frees a node. The blocks made by compact() are sorted by address, so the only
+* one that can hold the node is the last one starting at or before it, found by
+* binary search. A node inside a block is only destroyed, and the block itself is
+* freed with its last node. Any other node was allocated with new.
+*/
+template<typename Key, typename Value>
+void AVLTree<Key, Value>::destroyNode(Node<Key, Value>* node) {
+	NodeArena probe;
+	probe.mBlock = reinterpret_cast<char*>(node);
+
+	typename std::vector<NodeArena>::iterator arena = std::upper_bound(mArenas.begin(), mArenas.end(), probe, arenaBefore);
+
+	// The node is in the block before the first one starting after it
+	if (arena != mArenas.begin() && std::less<const char*>()(probe.mBlock, (arena - 1)->mBlock + (arena - 1)->mBytes)) {
+		--arena;
+
+		node->~Node();
+
+		// Its last node is gone
+		if (--arena->mLive == 0) {
+			::operator delete(arena->mBlock);
+			mArenas.erase(arena);
+		}
+
+		return;
+	}
+
+	delete node;
+}
+
+/**
+* Returns the number of single rotations this tree has done. A double rotation
+* counts as two.
+*/
+template<typename Key, typename Value>
+long long AVLTree<Key, Value>::rotations() const {
+	return mRotations;
+}
+
+/**
+* Returns the height of a node, treating NULL as height 0.
+*/
+template<typename Key, typename Value>
+int AVLTree<Key, Value>::getSubtreeHeight(AVLNode<Key, Value>* node) {
+	if (node == NULL) {
+		return 0;
+	}
+
+	return node->getHeight();
+}
+
+/**
+* Links left and right under node and recomputes node's height and subtree data.
+* node's own parent pointer is left for the caller to set.
+*/
+template<typename Key, typename Value>
+void AVLTree<Key, Value>::attach(AVLNode<Key, Value>* node, AVLNode<Key, Value>* left, AVLNode<Key, Value>* right) {
+	node->setLeft(left);
+	node->setRight(right);
+
+	if (left != NULL) {
+		left->setParent(node);
+	}
+
+	if (right != NULL) {
+		right->setParent(node);
+	}
+
+	node->setHeight(std::max(getSubtreeHeight(left), getSubtreeHeight(right)) + 1);
+
+	updateNode(node);
+}
+
+/**
+* Rotates a detached subtree to the left and returns its new root.
+*/
+template<typename Key, typename Value>
+AVLNode<Key, Value>* AVLTree<Key, Value>::rotateLeftAt(AVLNode<Key, Value>* node) {
+	++mRotations;
+
+	AVLNode<Key, Value>* newRoot = node->getRight();
+
+	attach(node, node->getLeft(), newRoot->getLeft());
+	attach(newRoot, node, newRoot->getRight());
+
+	return newRoot;
+}
+
+/**
+* Rotates a detached subtree to the right and returns its new root.
+*/
+template<typename Key, typename Value>
+AVLNode<Key, Value>* AVLTree<Key, Value>::rotateRightAt(AVLNode<Key, Value>* node) {
+	++mRotations;
+
+	AVLNode<Key, Value>* newRoot = node->getLeft();
+
+	attach(node, newRoot->getRight(), node->getRight());
+	attach(newRoot, newRoot->getLeft(), node);
+
+	return newRoot;
+}
+
+/**
+* Joins left, mid and right into one AVL tree in O(|height(left) - height(right)|).
+* Every key in left must be less than mid's key, which must be less than every key in right.
+*/
+template<typename Key, typename Value>
+AVLNode<Key, Value>* AVLTree<Key, Value>::join(AVLNode<Key, Value>* left, AVLNode<Key, Value>* mid, AVLNode<Key, Value>* right) {
+	AVLNode<Key, Value>* joined;
+
+	// If left is too tall, hang mid and right off left's right spine
+	if (getSubtreeHeight(left) > getSubtreeHeight(right) + 1) {
+		joined = joinRight(left, mid, right);
+	}
+
+	// If right is too tall, hang left and mid off right's left spine
+	else if (getSubtreeHeight(right) > getSubtreeHeight(left) + 1) {
+		joined = joinLeft(left, mid, right);
+	}
+
+	// If heights are close enough mid can be the root
+	else {
+		attach(mid, left, right);
+		joined = mid;
+	}
+
+	joined->setParent(NULL);
+
+	return joined;
+}
+
+/**
+* Join for when left is more than one level taller than right.
+*/
+template<typename Key, typename Value>
+AVLNode<Key, Value>* AVLTree<Key, Value>::joinRight(AVLNode<Key, Value>* left, AVLNode<Key, Value>* mid, AVLNode<Key, Value>* right) {
+	AVLNode<Key, Value>* leftLeft = left->getLeft();
+	AVLNode<Key, Value>* leftRight = left->getRight();
+
+	// If we have walked down far enough, mid can join leftRight and right
+	if (getSubtreeHeight(leftRight) <= getSubtreeHeight(right) + 1) {
+		attach(mid, leftRight, right);
+
+		// If left is still balanced
+		if (getSubtreeHeight(mid) <= getSubtreeHeight(leftLeft) + 1) {
+			attach(left, leftLeft, mid);
+
+			return left;
+		}
+
+		// Otherwise this is the RL case
+		attach(left, leftLeft, rotateRightAt(mid));
+
+		return rotateLeftAt(left);
+	}
+
+	// Keep walking down the right spine
+	AVLNode<Key, Value>* joined = joinRight(leftRight, mid, right);
+
+	attach(left, leftLeft, joined);
+
+	// If left became unbalanced this is the RR case
+	if (getSubtreeHeight(joined) > getSubtreeHeight(leftLeft) + 1) {
+		return rotateLeftAt(left);
+	}
+
+	return left;
+}
+
+/**
+* Join for when right is more than one level taller than left.
+*/
+template<typename Key, typename Value>
+AVLNode<Key, Value>* AVLTree<Key, Value>::joinLeft(AVLNode<Key, Value>* left, AVLNode<Key, Value>* mid, AVLNode<Key, Value>* right) {
+	AVLNode<Key, Value>* rightLeft = right->getLeft();
+	AVLNode<Key, Value>* rightRight = right->getRight();
+
+	// If we have walked down far enough, mid can join left and rightLeft
+	if (getSubtreeHeight(rightLeft) <= getSubtreeHeight(left) + 1) {
+		attach(mid, left, rightLeft);
+
+		// If right is still balanced
+		if (getSubtreeHeight(mid) <= getSubtreeHeight(rightRight) + 1) {
+			attach(right, mid, rightRight);
+
+			return right;
+		}
+
+		// Otherwise this is the LR case
+		attach(right, rotateLeftAt(mid), rightRight);
+
+		return rotateRightAt(right);
+	}
+
+	// Keep walking down the left spine
+	AVLNode<Key, Value>* joined = joinLeft(left, mid, rightLeft);
+
+	attach(right, joined, rightRight);
+
+	// If right became unbalanced this is the LL case
+	if (getSubtreeHeight(joined) > getSubtreeHeight(rightRight) + 1) {
+		return rotateRightAt(right);
+	}
+
+	return right;
+}
+
+/**
+* Joins two trees where every key in left is less than every key in right.
+*/
+template<typename Key, typename Value>
+AVLNode<Key, Value>* AVLTree<Key, Value>::join2(AVLNode<Key, Value>* left, AVLNode<Key, Value>* right) {
+	// If either side is empty there is nothing to join
+	if (left == NULL) {
+		if (right != NULL) {
+			right->setParent(NULL);
+		}
+
+		return right;
+	}
+
+	if (right == NULL) {
+		left->setParent(NULL);
+
+		return left;
+	}
+
+	// Use the largest node of left as the middle node
+	AVLNode<Key, Value>* last;
+	AVLNode<Key, Value>* rest = splitLast(left, last);
+
+	return join(rest, last, right);
+}
+
+/**
+* Detaches the largest node of a subtree into last and returns the rebalanced rest.
+*/
+template<typename Key, typename Value>
+AVLNode<Key, Value>* AVLTree<Key, Value>::splitLast(AVLNode<Key, Value>* root, AVLNode<Key, Value>*& last) {
+	// If root is the largest node, its left subtree is the rest
+	if (root->getRight() == NULL) {
+		last = root;
+
+		return root->getLeft();
+	}
+
+	AVLNode<Key, Value>* rest = splitLast(root->getRight(), last);
+
+	return join(root->getLeft(), root, rest);
+}
+
+/**
+* Splits a subtree into the keys less than key and the keys not less than key.
+* Each of the O(log n) joins on the way back up is proportional to the height
+* difference of its inputs, so the whole split is O(log n).
+*/
+template<typename Key, typename Value>
+void AVLTree<Key, Value>::split(AVLNode<Key, Value>* root, const Key& key, AVLNode<Key, Value>*& less, AVLNode<Key, Value>*& notLess) {
+	// Empty subtree splits into two empty subtrees
+	if (root == NULL) {
+		less = NULL;
+		notLess = NULL;
+
+		return;
+	}
+
+	AVLNode<Key, Value>* left = root->getLeft();
+	AVLNode<Key, Value>* right = root->getRight();
+
+	// If root belongs on the left, split the right subtree
+	if (root->getKey() < key) {
+		AVLNode<Key, Value>* rightLess;
+
+		split(right, key, rightLess, notLess);
+
+		less = join(left, root, rightLess);
+	}
+
+	// If root belongs on the right, split the left subtree
+	else {
+		AVLNode<Key, Value>* leftNotLess;
+
+		split(left, key, less, leftNotLess);
+
+		notLess = join(leftNotLess, root, right);
+	}
+}
+
+/**
+* Removes every item with lo <= key < hi. The tree is split around the range, the
+* middle part is freed in one pass and the outer parts are joined back together,
+* so this costs O(log n + k) instead of k separate removes.
+*/
+template<typename Key, typename Value>
+int AVLTree<Key, Value>::erase(const Key& lo, const Key& hi) {
+	// Empty range
+	if (!(lo < hi)) {
+		return 0;
+	}
+
+	int oldSize = size();
+
+	AVLNode<Key, Value>* below;
+	AVLNode<Key, Value>* rest;
+	AVLNode<Key, Value>* inRange;
+	AVLNode<Key, Value>* above;
+
+	split(static_cast<AVLNode<Key, Value>*>(BinarySearchTree<Key, Value>::mRoot), lo, below, rest);
+	split(rest, hi, inRange, above);
+
+	// Free the whole range at once
+	if (inRange != NULL) {
+		// Splice the range out of the threads, if the tree keeps any
+		AVLNode<Key, Value>* first = inRange;
+		AVLNode<Key, Value>* last = inRange;
+
+		while (first->getLeft() != NULL) {
+			first = first->getLeft();
+		}
+
+		while (last->getRight() != NULL) {
+			last = last->getRight();
+		}
+
+		unlinkThreads(first, last);
+
+		BinarySearchTree<Key, Value>::deleteSubtree(inRange);
+	}
+
+	BinarySearchTree<Key, Value>::mRoot = join2(below, above);
+	BinarySearchTree<Key, Value>::mNodeCount = size();
+
+	// Either end of the tree may have been in the range
+	BinarySearchTree<Key, Value>::recacheBounds();
+
+	// The finger may have been freed
+	mFinger = NULL;
+
+	return oldSize - size();
+}
+
+/**
+* Writes the new key into the node and recomputes the subtree data above it, which
+* augmented trees may derive from keys.
+*/
+template<typename Key, typename Value>
+void AVLTree<Key, Value>::rekey(iterator pos, const Key& key) {
+	AVLNode<Key, Value>* node = static_cast<AVLNode<Key, Value>*>(BinarySearchTree<Key, Value>::getNode(pos));
+
+	// The key must keep the node between its neighbours
+	assert(node != NULL);
+	assert(node->getPredecessor() == NULL || node->getPredecessor()->getKey() < key);
+	assert(node->getSuccessor() == NULL || key < node->getSuccessor()->getKey());
+
+	node->getKey() = key;
+
+	updatePath(node);
+}
+
+/**
+* Frees every node in the tree.
+*/
+template<typename Key, typename Value>
+void AVLTree<Key, Value>::clear() {
+	mFinger = NULL;
+
+	BinarySearchTree<Key, Value>::clear();
+}
+
+/**
+* Turns finger search on or off.
+*/
+template<typename Key, typename Value>
+void AVLTree<Key, Value>::setFingerSearch(bool enabled) {
+	mFingerSearch = enabled;
+}
+
+/**
+* Returns the node holding key or the node key would be linked under, if key
+* belongs in one of the slots right next to near in key order. Returns NULL
+* otherwise. O(1) with in-order threads, and O(log n) at worst without them for
+* finding near's neighbours.
+*/
+template<typename Key, typename Value>
+AVLNode<Key, Value>* AVLTree<Key, Value>::adjacentParent(AVLNode<Key, Value>* near, const Key& key) {
+	// If near holds key
+	if (key == near->getKey()) {
+		return near;
+	}
+
+	// If key belongs between near's predecessor and near
+	if (key < near->getKey()) {
+		AVLNode<Key, Value>* prev = near->getPredecessor();
+
+		if (prev != NULL && !(prev->getKey() < key)) {
+			return NULL;
+		}
+
+		// If near has a left subtree, prev is its largest node and has no right child
+		if (near->getLeft() == NULL) {
+			return near;
+		}
+
+		return prev;
+	}
+
+	// If key belongs between near and near's successor
+	AVLNode<Key, Value>* next = near->getSuccessor();
+
+	if (next != NULL && !(key < next->getKey())) {
+		return NULL;
+	}
+
+	// If near has a right subtree, next is its smallest node and has no left child
+	if (near->getRight() == NULL) {
+		return near;
+	}
+
+	return next;
+}
+
+/**
+* Searches down from a subtree root and returns the node holding key, or the last
+* node on the search path, which is where key would be linked.
+*/
+template<typename Key, typename Value>
+AVLNode<Key, Value>* AVLTree<Key, Value>::descend(AVLNode<Key, Value>* from, const Key& key) {
+	AVLNode<Key, Value>* currNode = from;
+
+	while (true) {
+		// If currNode holds key
+		if (key == currNode->getKey()) {
+			return currNode;
+		}
+
+		// If key is less than currNode go to left child
+		else if (key < currNode->getKey()) {
+			if (currNode->getLeft() == NULL) {
+				return currNode;
+			}
+
+			currNode = currNode->getLeft();
+		}
+
+		// If key is greater than currNode go to right child
+		else {
+			if (currNode->getRight() == NULL) {
+				return currNode;
+			}
+
+			currNode = currNode->getRight();
+		}
+	}
+}
+
+/**
+* Searches from the root for where key is or belongs.
+*/
+template<typename Key, typename Value>
+AVLNode<Key, Value>* AVLTree<Key, Value>::locate(const Key& key) const {
+	AVLNode<Key, Value>* root = static_cast<AVLNode<Key, Value>*>(BinarySearchTree<Key, Value>::mRoot);
+
+	// Empty tree
+	if (root == NULL) {
+		return NULL;
+	}
+
+	return descend(root, key);
+}
+
+/**
+* Finds where key is (or belongs) starting from mFinger. Keys next to the finger
+* are found with two comparisons. Otherwise the search climbs to the lowest ancestor whose
+* subtree must contain key's position and descends from there, which costs
+* O(log d) for a key d positions away instead of O(log n).
+*/
+template<typename Key, typename Value>
+AVLNode<Key, Value>* AVLTree<Key, Value>::fingerLocate(const Key& key) const {
+	AVLNode<Key, Value>* currNode = adjacentParent(mFinger, key);
+
+	// If key is next to the finger
+	if (currNode != NULL) {
+		return currNode;
+	}
+
+	currNode = mFinger;
+
+	// If key is to the right of the finger, every key in currNode's subtree is
+	// bounded below by key's position already. Climb until a parent bounds it above
+	if (mFinger->getKey() < key) {
+		while (currNode->getParent() != NULL &&
+			(currNode == currNode->getParent()->getRight() || !(key < currNode->getParent()->getKey()))) {
+			currNode = currNode->getParent();
+		}
+	}
+
+	// If key is to the left of the finger, climb until a parent bounds it below
+	else {
+		while (currNode->getParent() != NULL &&
+			(currNode == currNode->getParent()->getLeft() || !(currNode->getParent()->getKey() < key))) {
+			currNode = currNode->getParent();
+		}
+	}
+
+	return descend(currNode, key);
+}
+
+/**
+* Links a new node for keyValuePair under parent and rebalances, or updates
+* parent's value if it already holds the key. parent is NULL only if the tree
+* is empty. Returns the node holding the key and makes it the finger.
+*/
+template<typename Key, typename Value>
+AVLNode<Key, Value>* AVLTree<Key, Value>::insertAt(AVLNode<Key, Value>* parent, const std::pair<Key, Value>& keyValuePair) {
+	// If there is a duplicate entry
+	if (parent != NULL && keyValuePair.first == parent->getKey()) {
+		// Update parent's value
+		parent->setValue(keyValuePair.second);
+
+		// The value changed, so any data derived from it must be recomputed
+		updatePath(parent);
+
+		mFinger = parent;
+
+		return parent;
+	}
+
+	AVLNode<Key, Value>* newNode = createNode(keyValuePair.first, keyValuePair.second, parent);
+
+	// If the tree is empty newNode becomes the root
+	if (parent == NULL) {
+		BinarySearchTree<Key, Value>::mRoot = newNode;
+	}
+
+	// If newNode needs to be added as left child of parent
+	else if (keyValuePair.first < parent->getKey()) {
+		parent->setLeft(newNode);
+	}
+
+	// If newNode needs to be added as right child of parent
+	else {
+		parent->setRight(newNode);
+	}
+
+	mFinger = newNode;
+
+	// Rotations relink nodes without copying items, so newNode stays valid
+	rebalanceInsert(newNode);
+
+	return newNode;
+}
+
+/**
+* Inserts keyValuePair with a position hint. When the key belongs right before
+* or right after hint this is O(1) comparisons plus the rebalancing, otherwise
+* it falls back to a search from the root.
+*/
+template<typename Key, typename Value>
+typename AVLTree<Key, Value>::iterator AVLTree<Key, Value>::insert(iterator hint, const std::pair<Key, Value>& keyValuePair) {
+	AVLNode<Key, Value>* root = static_cast<AVLNode<Key, Value>*>(BinarySearchTree<Key, Value>::mRoot);
+
+	// If the tree is empty the hint does not matter
+	if (root == NULL) {
+		return iterator(insertAt(NULL, keyValuePair), this);
+	}
+
+	AVLNode<Key, Value>* hintNode = static_cast<AVLNode<Key, Value>*>(BinarySearchTree<Key, Value>::getNode(hint));
+
+	// The end hint means after the largest item
+	if (hintNode == NULL) {
+		hintNode = static_cast<AVLNode<Key, Value>*>(BinarySearchTree<Key, Value>::getLargestNode());
+	}
+
+	AVLNode<Key, Value>* parent = adjacentParent(hintNode, keyValuePair.first);
+
+	// If the hint was wrong search from the root
+	if (parent == NULL) {
+		parent = descend(root, keyValuePair.first);
+	}
+
+	return iterator(insertAt(parent, keyValuePair), this);
+}
+
+/**
+* Appends an item after the largest item. The largest node has no right child, so
+* the new node is linked there directly. Rebalancing stops as soon as a height does
+* not change, which makes the rotations amortized O(1) for a run of appends; only the
+* subtree sizes are updated all the way up.
+*/
+template<typename Key, typename Value>
+void AVLTree<Key, Value>::push_back(const std::pair<Key, Value>& keyValuePair) {
+	AVLNode<Key, Value>* largest = static_cast<AVLNode<Key, Value>*>(BinarySearchTree<Key, Value>::getLargestNode());
+
+	// Not an append, so let insert find the place
+	if (largest != NULL && !(largest->getKey() < keyValuePair.first)) {
+		insert(keyValuePair);
+
+		return;
+	}
+
+	autoCompact();
+
+	// The largest node may have moved if the tree was compacted
+	insertAt(static_cast<AVLNode<Key, Value>*>(BinarySearchTree<Key, Value>::getLargestNode()), keyValuePair);
+}
+
+/**
+* Returns an iterator to the item with the given key, or the end iterator. With
+* finger search enabled the search starts at the last accessed node, and a found
+* node becomes the new finger.
+*/
+template<typename Key, typename Value>
+typename AVLTree<Key, Value>::iterator AVLTree<Key, Value>::find(const Key& key) {
+	AVLNode<Key, Value>* foundNode;
+
+	// Start from the last accessed node instead of the root
+	if (mFingerSearch && mFinger != NULL) {
+		foundNode = fingerLocate(key);
+
+		// fingerLocate returns where key would go if it is missing
+		if (!(foundNode->getKey() == key)) {
+			foundNode = NULL;
+		}
+	}
+
+	else {
+		foundNode = static_cast<AVLNode<Key, Value>*>(BinarySearchTree<Key, Value>::internalFind(key));
+	}
+
+	if (foundNode != NULL) {
+		mFinger = foundNode;
+	}
+
+	return iterator(foundNode, this);
+}
+
+/**
+* Merges other into this tree, keeping other's value for keys in both trees.
+*/
+template<typename Key, typename Value>
+void AVLTree<Key, Value>::merge(AVLTree<Key, Value>& other) {
+	merge(other, keepOther);
+}
+
+/**
+* Merges other into this tree. Both trees are walked in key order, giving one
+* sorted list of nodes, and a balanced tree is then built from
+* that list. Nothing is allocated and only one comparison is made per step, so the
+* whole merge is O(n + m) rather than O(m log(n + m)) for inserting each item.
+*/
+template<typename Key, typename Value>
+template<typename Combine>
+void AVLTree<Key, Value>::merge(AVLTree<Key, Value>& other, Combine combine) {
+	// Merging a tree into itself changes nothing
+	if (this == &other) {
+		return;
+	}
+
+	// Blocks of other's nodes now hold nodes of this tree, kept sorted by address
+	std::size_t ownArenas = mArenas.size();
+
+	mArenas.insert(mArenas.end(), other.mArenas.begin(), other.mArenas.end());
+	std::inplace_merge(mArenas.begin(), mArenas.begin() + ownArenas, mArenas.end(), arenaBefore);
+	other.mArenas.clear();
+
+	std::vector<AVLNode<Key, Value>*> nodes;
+	nodes.reserve(size() + other.size());
+
+	// Other's nodes for keys in both trees. They are freed after the walk, since
+	// finding a successor may climb through them.
+	std::vector<AVLNode<Key, Value>*> duplicates;
+
+	AVLNode<Key, Value>* mine = static_cast<AVLNode<Key, Value>*>(BinarySearchTree<Key, Value>::getSmallestNode());
+	AVLNode<Key, Value>* theirs = static_cast<AVLNode<Key, Value>*>(other.getSmallestNode());
+
+	while (mine != NULL && theirs != NULL) {
+		// If the next key is only in this tree
+		if (mine->getKey() < theirs->getKey()) {
+			nodes.push_back(mine);
+			mine = mine->getSuccessor();
+		}
+
+		// If the next key is only in other
+		else if (theirs->getKey() < mine->getKey()) {
+			nodes.push_back(theirs);
+			theirs = theirs->getSuccessor();
+		}
+
+		// If the key is in both trees keep this tree's node and free other's
+		else {
+			mine->setValue(combine(mine->getValue(), theirs->getValue()));
+			nodes.push_back(mine);
+			mine = mine->getSuccessor();
+
+			duplicates.push_back(theirs);
+			theirs = theirs->getSuccessor();
+		}
+	}
+
+	// At most one of the trees has nodes left
+	while (mine != NULL) {
+		nodes.push_back(mine);
+		mine = mine->getSuccessor();
+	}
+
+	while (theirs != NULL) {
+		nodes.push_back(theirs);
+		theirs = theirs->getSuccessor();
+	}
+
+	for (unsigned int i = 0; i < duplicates.size(); ++i) {
+		this->destroyNode(duplicates[i]);
+	}
+
+	// Both trees have given up their nodes
+	other.mRoot = NULL;
+	other.mMin = NULL;
+	other.mMax = NULL;
+	other.mNodeCount = 0;
+	other.mFinger = NULL;
+
+	BinarySearchTree<Key, Value>::mRoot = buildBalanced(nodes, 0, static_cast<int>(nodes.size()));
+	BinarySearchTree<Key, Value>::mNodeCount = static_cast<int>(nodes.size());
+	mFinger = NULL;
+
+	BinarySearchTree<Key, Value>::mMin = nodes.empty() ? NULL : nodes.front();
+	BinarySearchTree<Key, Value>::mMax = nodes.empty() ? NULL : nodes.back();
+
+	// Link the threads in the merged order
+	rebuildThreads();
+}
+
+/**
+* Builds a balanced subtree from the middle of nodes outwards. The two halves
+* differ in size by at most one, so every node is balanced. Recursion depth is
+* O(log n).
+*/
+template<typename Key, typename Value>
+AVLNode<Key, Value>* AVLTree<Key, Value>::buildBalanced(std::vector<AVLNode<Key, Value>*>& nodes, int first, int last) {
+	// Empty range
+	if (first >= last) {
+		return NULL;
+	}
+
+	int middle = first + (last - first) / 2;
+
+	AVLNode<Key, Value>* root = nodes[middle];
+
+	root->setParent(NULL);
+
+	// attach recomputes the height and subtree data once both children are built
+	attach(root, buildBalanced(nodes, first, middle), buildBalanced(nodes, middle + 1, last));
+
+	return root;
+}
+
+/**
+* The default merge policy: the value from the tree being merged in wins.
+*/
+template<typename Key, typename Value>
+Value AVLTree<Key, Value>::keepOther(const Value& mine, const Value& theirs) {
+	return theirs;
+}
+
 /*
 ------------------------------------------
 End implementations for the AVLTree class.
@@ -0,0 +1,873 @@
+#ifndef AVLBUCKET_H
+#define AVLBUCKET_H
+
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include "avlbst.h"
+#include "../bplus/nodesearch.h"
+
+/**
+* A templated ordered map that keeps its items in small sorted arrays (buckets) of
+* up to BucketSize items, with an AVLTree over the buckets instead of over the items.
+* The AVL tree maps the smallest key of every bucket to the bucket, so only one AVL
+* node with its links, height and size is paid for per bucket, and searching a bucket
+* and scanning it read consecutive memory. Buckets are linked in key order, so
+* iteration never touches the AVL tree.
+*
+* A bucket that overflows is split in half. A bucket that drops below a quarter full
+* is merged with a neighbour if the two fit in one bucket, and otherwise takes items
+* from it. Key and Value must be default constructible. Iterators dereference to a
+* std::pair of references to the key and value.
+*/
+template <class Key, class Value, int BucketSize = 32>
+class BucketedAVLTree
+{
+	static_assert(BucketSize >= 4, "BucketedAVLTree buckets must hold at least 4 items");
+
+private:
+	struct Bucket;
+
+public:
+	BucketedAVLTree();
+	~BucketedAVLTree();
+
+	// Copies insert every item of other. Moves take over the buckets in O(1) and
+	// leave the source empty.
+	BucketedAVLTree(const BucketedAVLTree<Key, Value, BucketSize>& other);
+	BucketedAVLTree(BucketedAVLTree<Key, Value, BucketSize>&& other) noexcept;
+	BucketedAVLTree<Key, Value, BucketSize>& operator=(const BucketedAVLTree<Key, Value, BucketSize>& other);
+	BucketedAVLTree<Key, Value, BucketSize>& operator=(BucketedAVLTree<Key, Value, BucketSize>&& other) noexcept;
+
+	// Methods for inserting/removing elements from the tree. A duplicate key updates
+	// the value, and removing a missing key does nothing.
+	void insert(const std::pair<Key, Value>& keyValuePair);
+	void remove(const Key& key);
+	void clear();
+
+	// Returns the number of items in O(1)
+	int size() const;
+	bool empty() const;
+
+	// Returns the number of buckets, and the bytes used by the buckets and the AVL
+	// nodes over them (not counting heap allocator overhead)
+	int buckets() const;
+	long long memoryUsage() const;
+
+	/**
+	* An iterator over the items in key order. ValueType is Value for iterator and
+	* const Value for const_iterator. It walks the linked buckets, so ++ and -- are
+	* O(1). An iterator converts to a const_iterator.
+	*/
+	template <typename ValueType>
+	class basic_iterator
+	{
+	public:
+		typedef std::bidirectional_iterator_tag iterator_category;
+		typedef std::pair<Key, Value> value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef std::pair<const Key&, ValueType&> reference;
+
+		// Holds the pair of references so that -> has something to point at
+		class pointer
+		{
+		public:
+			pointer(const reference& item);
+			const reference* operator->() const;
+
+		private:
+			reference mItem;
+		};
+
+		basic_iterator();
+		basic_iterator(Bucket* bucket, int index, const BucketedAVLTree<Key, Value, BucketSize>* tree);
+		basic_iterator(const basic_iterator<Value>& other);
+
+		reference operator*() const;
+		pointer operator->() const;
+
+		bool operator==(const basic_iterator& rhs) const;
+		bool operator!=(const basic_iterator& rhs) const;
+
+		basic_iterator& operator++();
+		basic_iterator operator++(int);
+		basic_iterator& operator--();
+		basic_iterator operator--(int);
+
+	protected:
+		// The bucket and slot of the item, or NULL for end()
+		Bucket* mBucket;
+		int mIndex;
+		const BucketedAVLTree<Key, Value, BucketSize>* mTree;
+
+		template <typename OtherValueType> friend class basic_iterator;
+	};
+
+	typedef basic_iterator<Value> iterator;
+	typedef basic_iterator<const Value> const_iterator;
+
+	iterator begin();
+	iterator end();
+	const_iterator begin() const;
+	const_iterator end() const;
+
+	iterator find(const Key& key);
+	const_iterator find(const Key& key) const;
+
+	// First item with key >= key, or end() if there is none
+	iterator lower_bound(const Key& key);
+	const_iterator lower_bound(const Key& key) const;
+
+private:
+	// Sorted items, with one spare slot so an item can be added to a full bucket
+	// before it is split
+	struct Bucket
+	{
+		int mCount;
+		Key mKeys[BucketSize + 1];
+		Value mValues[BucketSize + 1];
+		Bucket* mNext;
+		Bucket* mPrev;
+	};
+
+	typedef AVLTree<Key, Bucket*> IndexTree;
+
+	// Returns the index entry of the bucket whose key range holds key: the last
+	// bucket starting at or before key, or the first bucket if key is smaller than
+	// every key. Returns end() for an empty tree.
+	typename IndexTree::iterator findEntry(const Key& key);
+
+	// Moves the upper half of an overfull bucket into a new bucket after it
+	void split(Bucket* bucket);
+
+	// Refills a bucket that is under a quarter full from a neighbour
+	void refill(typename IndexTree::iterator entry);
+
+	// Moves count items from the front of next to the back of bucket, or from the
+	// back of prev to the front of bucket
+	static void takeFromNext(Bucket* bucket, Bucket* next, int count);
+	static void takeFromPrev(Bucket* bucket, Bucket* prev, int count);
+
+	void unlinkBucket(Bucket* bucket);
+
+	// Maps the smallest key of every bucket to the bucket. The keys are changed in
+	// place through iterators when a bucket's smallest key changes; the new key
+	// always stays between the neighbouring buckets' keys, so the order holds.
+	IndexTree mIndex;
+
+	Bucket* mFirst;
+	Bucket* mLast;
+	int mSize;
+};
+
+/*
+	----------------------------------------------------------------------
+	Begin implementations for the BucketedAVLTree::basic_iterator class.
+	----------------------------------------------------------------------
+*/
+
+/**
+* Stores the pair of references returned by operator*.
+*/
+template<typename Key, typename Value, int BucketSize>
+template<typename ValueType>
+BucketedAVLTree<Key, Value, BucketSize>::basic_iterator<ValueType>::pointer::pointer(const reference& item)
+	: mItem(item)
+{
+
+}
+
+/**
+* Provides access to the stored pair.
+*/
+template<typename Key, typename Value, int BucketSize>
+template<typename ValueType>
+const typename BucketedAVLTree<Key, Value, BucketSize>::template basic_iterator<ValueType>::reference*
+BucketedAVLTree<Key, Value, BucketSize>::basic_iterator<ValueType>::pointer::operator->() const
+{
+	return &mItem;
+}
+
+/**
+* A default constructor that initializes the iterator to end().
+*/
+template<typename Key, typename Value, int BucketSize>
+template<typename ValueType>
+BucketedAVLTree<Key, Value, BucketSize>::basic_iterator<ValueType>::basic_iterator()
+	: mBucket(NULL)
+	, mIndex(0)
+	, mTree(NULL)
+{
+
+}
+
+/**
+* Constructor that points the iterator at slot index of a bucket in tree.
+*/
+template<typename Key, typename Value, int BucketSize>
+template<typename ValueType>
+BucketedAVLTree<Key, Value, BucketSize>::basic_iterator<ValueType>::basic_iterator(Bucket* bucket, int index, const BucketedAVLTree<Key, Value, BucketSize>* tree)
+	: mBucket(bucket)
+	, mIndex(index)
+	, mTree(tree)
+{
+
+}
+
+/**
+* Converts an iterator to a const_iterator, and copies an iterator.
+*/
+template<typename Key, typename Value, int BucketSize>
+template<typename ValueType>
+BucketedAVLTree<Key, Value, BucketSize>::basic_iterator<ValueType>::basic_iterator(const basic_iterator<Value>& other)
+	: mBucket(other.mBucket)
+	, mIndex(other.mIndex)
+	, mTree(other.mTree)
+{
+
+}
+
+/**
+* Provides access to the key and value.
+*/
+template<typename Key, typename Value, int BucketSize>
+template<typename ValueType>
+typename BucketedAVLTree<Key, Value, BucketSize>::template basic_iterator<ValueType>::reference
+BucketedAVLTree<Key, Value, BucketSize>::basic_iterator<ValueType>::operator*() const
+{
+	return reference(mBucket->mKeys[mIndex], mBucket->mValues[mIndex]);
+}
+
+/**
+* Provides access to the key and value through ->first and ->second.
+*/
+template<typename Key, typename Value, int BucketSize>
+template<typename ValueType>
+typename BucketedAVLTree<Key, Value, BucketSize>::template basic_iterator<ValueType>::pointer
+BucketedAVLTree<Key, Value, BucketSize>::basic_iterator<ValueType>::operator->() const
+{
+	return pointer(**this);
+}
+
+/**
+* Checks if 'this' iterator points at the same item as 'rhs'.
+*/
+template<typename Key, typename Value, int BucketSize>
+template<typename ValueType>
+bool BucketedAVLTree<Key, Value, BucketSize>::basic_iterator<ValueType>::operator==(const basic_iterator& rhs) const
+{
+	return mBucket == rhs.mBucket && mIndex == rhs.mIndex;
+}
+
+/**
+* Checks if 'this' iterator points at a different item than 'rhs'.
+*/
+template<typename Key, typename Value, int BucketSize>
+template<typename ValueType>
+bool BucketedAVLTree<Key, Value, BucketSize>::basic_iterator<ValueType>::operator!=(const basic_iterator& rhs) const
+{
+	return !(*this == rhs);
+}
+
+/**
+* Advances the iterator to the next item, moving to the next bucket after the last
+* slot of a bucket.
+*/
+template<typename Key, typename Value, int BucketSize>
+template<typename ValueType>
+typename BucketedAVLTree<Key, Value, BucketSize>::template basic_iterator<ValueType>&
+BucketedAVLTree<Key, Value, BucketSize>::basic_iterator<ValueType>::operator++()
+{
+	++mIndex;
+
+	// Past the last slot of this bucket
+	if (mIndex == mBucket->mCount) {
+		mBucket = mBucket->mNext;
+		mIndex = 0;
+	}
+
+	return *this;
+}
+
+/**
+* Post-increment.
+*/
+template<typename Key, typename Value, int BucketSize>
+template<typename ValueType>
+typename BucketedAVLTree<Key, Value, BucketSize>::template basic_iterator<ValueType>
+BucketedAVLTree<Key, Value, BucketSize>::basic_iterator<ValueType>::operator++(int)
+{
+	basic_iterator copy(*this);
+	++(*this);
+	return copy;
+}
+
+/**
+* Moves the iterator to the previous item. Decrementing end() moves to the last item.
+*/
+template<typename Key, typename Value, int BucketSize>
+template<typename ValueType>
+typename BucketedAVLTree<Key, Value, BucketSize>::template basic_iterator<ValueType>&
+BucketedAVLTree<Key, Value, BucketSize>::basic_iterator<ValueType>::operator--()
+{
+	// end() goes to the last slot of the last bucket
+	if (mBucket == NULL) {
+		mBucket = mTree->mLast;
+		mIndex = mBucket->mCount - 1;
+	}
+
+	// Before the first slot of this bucket
+	else if (mIndex == 0) {
+		mBucket = mBucket->mPrev;
+		mIndex = mBucket->mCount - 1;
+	}
+
+	else {
+		--mIndex;
+	}
+
+	return *this;
+}
+
+/**
+* Post-decrement.
+*/
+template<typename Key, typename Value, int BucketSize>
+template<typename ValueType>
+typename BucketedAVLTree<Key, Value, BucketSize>::template basic_iterator<ValueType>
+BucketedAVLTree<Key, Value, BucketSize>::basic_iterator<ValueType>::operator--(int)
+{
+	basic_iterator copy(*this);
+	--(*this);
+	return copy;
+}
+
+/*
+	--------------------------------------------------------------------
+	End implementations for the BucketedAVLTree::basic_iterator class.
+	--------------------------------------------------------------------
+*/
+
+/*
+--------------------------------------------
+Begin implementations for the BucketedAVLTree class.
+--------------------------------------------
+*/
+
+/**
+* Default constructor for an empty BucketedAVLTree.
+*/
+template<typename Key, typename Value, int BucketSize>
+BucketedAVLTree<Key, Value, BucketSize>::BucketedAVLTree()
+	: mFirst(NULL)
+	, mLast(NULL)
+	, mSize(0)
+{
+
+}
+
+template<typename Key, typename Value, int BucketSize>
+BucketedAVLTree<Key, Value, BucketSize>::~BucketedAVLTree()
+{
+	clear();
+}
+
+/**
+* Copy constructor. Inserts every item of other in order.
+*/
+template<typename Key, typename Value, int BucketSize>
+BucketedAVLTree<Key, Value, BucketSize>::BucketedAVLTree(const BucketedAVLTree<Key, Value, BucketSize>& other)
+	: mFirst(NULL)
+	, mLast(NULL)
+	, mSize(0)
+{
+	*this = other;
+}
+
+/**
+* Move constructor. Takes over other's buckets and leaves other empty.
+*/
+template<typename Key, typename Value, int BucketSize>
+BucketedAVLTree<Key, Value, BucketSize>::BucketedAVLTree(BucketedAVLTree<Key, Value, BucketSize>&& other) noexcept
+	: mIndex(std::move(other.mIndex))
+	, mFirst(other.mFirst)
+	, mLast(other.mLast)
+	, mSize(other.mSize)
+{
+	other.mFirst = NULL;
+	other.mLast = NULL;
+	other.mSize = 0;
+}
+
+/**
+* Copy assignment. Frees this tree's buckets and inserts every item of other.
+*/
+template<typename Key, typename Value, int BucketSize>
+BucketedAVLTree<Key, Value, BucketSize>& BucketedAVLTree<Key, Value, BucketSize>::operator=(const BucketedAVLTree<Key, Value, BucketSize>& other)
+{
+	// Self assignment
+	if (this == &other) {
+		return *this;
+	}
+
+	clear();
+
+	for (const_iterator it = other.begin(); it != other.end(); ++it) {
+		insert(std::make_pair(it->first, it->second));
+	}
+
+	return *this;
+}
+
+/**
+* Move assignment. Frees this tree's buckets, takes over other's and leaves other empty.
+*/
+template<typename Key, typename Value, int BucketSize>
+BucketedAVLTree<Key, Value, BucketSize>& BucketedAVLTree<Key, Value, BucketSize>::operator=(BucketedAVLTree<Key, Value, BucketSize>&& other) noexcept
+{
+	// Self assignment
+	if (this == &other) {
+		return *this;
+	}
+
+	clear();
+
+	mIndex = std::move(other.mIndex);
+	mFirst = other.mFirst;
+	mLast = other.mLast;
+	mSize = other.mSize;
+
+	other.mFirst = NULL;
+	other.mLast = NULL;
+	other.mSize = 0;
+
+	return *this;
+}
+
+/**
+* Returns the number of items in O(1).
+*/
+template<typename Key, typename Value, int BucketSize>
+int BucketedAVLTree<Key, Value, BucketSize>::size() const
+{
+	return mSize;
+}
+
+/**
+* Returns true if the tree holds no items.
+*/
+template<typename Key, typename Value, int BucketSize>
+bool BucketedAVLTree<Key, Value, BucketSize>::empty() const
+{
+	return mSize == 0;
+}
+
+/**
+* Returns the number of buckets in O(1).
+*/
+template<typename Key, typename Value, int BucketSize>
+int BucketedAVLTree<Key, Value, BucketSize>::buckets() const
+{
+	return mIndex.size();
+}
+
+/**
+* Returns the bytes held by the buckets and by the AVL nodes that index them.
+*/
+template<typename Key, typename Value, int BucketSize>
+long long BucketedAVLTree<Key, Value, BucketSize>::memoryUsage() const
+{
+	return static_cast<long long>(buckets()) * (sizeof(Bucket) + sizeof(AVLNode<Key, Bucket*>));
+}
+
+/**
+* Deletes all buckets, resetting the tree to the empty tree.
+*/
+template<typename Key, typename Value, int BucketSize>
+void BucketedAVLTree<Key, Value, BucketSize>::clear()
+{
+	Bucket* bucket = mFirst;
+
+	while (bucket != NULL) {
+		Bucket* next = bucket->mNext;
+		delete bucket;
+		bucket = next;
+	}
+
+	mIndex.clear();
+	mFirst = NULL;
+	mLast = NULL;
+	mSize = 0;
+}
+
+/**
+* Returns an iterator to the smallest item.
+*/
+template<typename Key, typename Value, int BucketSize>
+typename BucketedAVLTree<Key, Value, BucketSize>::iterator BucketedAVLTree<Key, Value, BucketSize>::begin()
+{
+	return iterator(mFirst, 0, this);
+}
+
+/**
+* Returns an iterator past the largest item.
+*/
+template<typename Key, typename Value, int BucketSize>
+typename BucketedAVLTree<Key, Value, BucketSize>::iterator BucketedAVLTree<Key, Value, BucketSize>::end()
+{
+	return iterator(NULL, 0, this);
+}
+
+/**
+* Returns a const_iterator to the smallest item.
+*/
+template<typename Key, typename Value, int BucketSize>
+typename BucketedAVLTree<Key, Value, BucketSize>::const_iterator BucketedAVLTree<Key, Value, BucketSize>::begin() const
+{
+	return const_iterator(mFirst, 0, this);
+}
+
+/**
+* Returns a const_iterator past the largest item.
+*/
+template<typename Key, typename Value, int BucketSize>
+typename BucketedAVLTree<Key, Value, BucketSize>::const_iterator BucketedAVLTree<Key, Value, BucketSize>::end() const
+{
+	return const_iterator(NULL, 0, this);
+}
+
+/**
+* Returns the index entry of the last bucket starting at or before key, or of the
+* first bucket if there is none.
+*/
+template<typename Key, typename Value, int BucketSize>
+typename BucketedAVLTree<Key, Value, BucketSize>::IndexTree::iterator BucketedAVLTree<Key, Value, BucketSize>::findEntry(const Key& key)
+{
+	typename IndexTree::iterator entry = mIndex.floor(key);
+
+	// Smaller than every key
+	if (entry == mIndex.end()) {
+		return mIndex.begin();
+	}
+
+	return entry;
+}
+
+/**
+* Returns an iterator to the item with the given key, or end() if it is not in
+* the tree.
+*/
+template<typename Key, typename Value, int BucketSize>
+typename BucketedAVLTree<Key, Value, BucketSize>::iterator BucketedAVLTree<Key, Value, BucketSize>::find(const Key& key)
+{
+	typename IndexTree::iterator entry = findEntry(key);
+
+	// Empty tree
+	if (entry == mIndex.end()) {
+		return end();
+	}
+
+	Bucket* bucket = entry->second;
+	int index = nodeLowerBound(bucket->mKeys, bucket->mCount, key);
+
+	// The first key >= key is key itself
+	if (index < bucket->mCount && !(key < bucket->mKeys[index])) {
+		return iterator(bucket, index, this);
+	}
+
+	return end();
+}
+
+/**
+* Const version of find.
+*/
+template<typename Key, typename Value, int BucketSize>
+typename BucketedAVLTree<Key, Value, BucketSize>::const_iterator BucketedAVLTree<Key, Value, BucketSize>::find(const Key& key) const
+{
+	return const_cast<BucketedAVLTree<Key, Value, BucketSize>*>(this)->find(key);
+}
+
+/**
+* Returns an iterator to the first item with a key >= key, which is either in the
+* bucket whose range holds key or the first item of the next bucket.
+*/
+template<typename Key, typename Value, int BucketSize>
+typename BucketedAVLTree<Key, Value, BucketSize>::iterator BucketedAVLTree<Key, Value, BucketSize>::lower_bound(const Key& key)
+{
+	typename IndexTree::iterator entry = findEntry(key);
+
+	// Empty tree
+	if (entry == mIndex.end()) {
+		return end();
+	}
+
+	Bucket* bucket = entry->second;
+	int index = nodeLowerBound(bucket->mKeys, bucket->mCount, key);
+
+	// Every key in this bucket is smaller
+	if (index == bucket->mCount) {
+		return iterator(bucket->mNext, 0, this);
+	}
+
+	return iterator(bucket, index, this);
+}
+
+/**
+* Const version of lower_bound.
+*/
+template<typename Key, typename Value, int BucketSize>
+typename BucketedAVLTree<Key, Value, BucketSize>::const_iterator BucketedAVLTree<Key, Value, BucketSize>::lower_bound(const Key& key) const
+{
+	return const_cast<BucketedAVLTree<Key, Value, BucketSize>*>(this)->lower_bound(key);
+}
+
+/**
+* Inserts a key value pair into the bucket whose range holds the key, splitting
+* the bucket if it overflows. Only inserting or splitting a bucket touches the AVL
+* tree.
+*/
+template<typename Key, typename Value, int BucketSize>
+void BucketedAVLTree<Key, Value, BucketSize>::insert(const std::pair<Key, Value>& keyValuePair)
+{
+	// If the tree is empty the item goes in a new bucket
+	if (mFirst == NULL) {
+		Bucket* bucket = new Bucket();
+		bucket->mCount = 1;
+		bucket->mKeys[0] = keyValuePair.first;
+		bucket->mValues[0] = keyValuePair.second;
+		bucket->mNext = NULL;
+		bucket->mPrev = NULL;
+
+		mIndex.insert(std::make_pair(keyValuePair.first, bucket));
+		mFirst = bucket;
+		mLast = bucket;
+		mSize = 1;
+		return;
+	}
+
+	typename IndexTree::iterator entry = findEntry(keyValuePair.first);
+	Bucket* bucket = entry->second;
+
+	int index = nodeLowerBound(bucket->mKeys, bucket->mCount, keyValuePair.first);
+
+	// If there is a duplicate entry update its value
+	if (index < bucket->mCount && !(keyValuePair.first < bucket->mKeys[index])) {
+		bucket->mValues[index] = keyValuePair.second;
+		return;
+	}
+
+	// Open a slot at index
+	std::move_backward(bucket->mKeys + index, bucket->mKeys + bucket->mCount, bucket->mKeys + bucket->mCount + 1);
+	std::move_backward(bucket->mValues + index, bucket->mValues + bucket->mCount, bucket->mValues + bucket->mCount + 1);
+
+	bucket->mKeys[index] = keyValuePair.first;
+	bucket->mValues[index] = keyValuePair.second;
+	++bucket->mCount;
+	++mSize;
+
+	// A new smallest key, which only happens in the first bucket
+	if (index == 0) {
+		mIndex.rekey(entry, keyValuePair.first);
+	}
+
+	// Bucket overflowed
+	if (bucket->mCount > BucketSize) {
+		split(bucket);
+	}
+}
+
+/**
+* Moves the upper half of a bucket into a new bucket linked after it, and indexes
+* the new bucket by its smallest key.
+*/
+template<typename Key, typename Value, int BucketSize>
+void BucketedAVLTree<Key, Value, BucketSize>::split(Bucket* bucket)
+{
+	int half = bucket->mCount / 2;
+
+	Bucket* right = new Bucket();
+	right->mCount = bucket->mCount - half;
+
+	std::move(bucket->mKeys + half, bucket->mKeys + bucket->mCount, right->mKeys);
+	std::move(bucket->mValues + half, bucket->mValues + bucket->mCount, right->mValues);
+	bucket->mCount = half;
+
+	// Link the new bucket after bucket
+	right->mPrev = bucket;
+	right->mNext = bucket->mNext;
+
+	if (bucket->mNext != NULL) {
+		bucket->mNext->mPrev = right;
+	}
+
+	else {
+		mLast = right;
+	}
+
+	bucket->mNext = right;
+
+	mIndex.insert(std::make_pair(right->mKeys[0], right));
+}
+
+/**
+* Removes the item with the given key. Does nothing if the key is not in the tree.
+* An empty bucket is deleted, and one under a quarter full is refilled.
+*/
+template<typename Key, typename Value, int BucketSize>
+void BucketedAVLTree<Key, Value, BucketSize>::remove(const Key& key)
+{
+	typename IndexTree::iterator entry = findEntry(key);
+
+	// Empty tree
+	if (entry == mIndex.end()) {
+		return;
+	}
+
+	Bucket* bucket = entry->second;
+	int index = nodeLowerBound(bucket->mKeys, bucket->mCount, key);
+
+	// Key is not in the tree
+	if (index == bucket->mCount || key < bucket->mKeys[index]) {
+		return;
+	}
+
+	// Close the slot at index
+	std::move(bucket->mKeys + index + 1, bucket->mKeys + bucket->mCount, bucket->mKeys + index);
+	std::move(bucket->mValues + index + 1, bucket->mValues + bucket->mCount, bucket->mValues + index);
+
+	--bucket->mCount;
+	--mSize;
+
+	// The bucket is empty
+	if (bucket->mCount == 0) {
+		mIndex.erase(entry);
+		unlinkBucket(bucket);
+		delete bucket;
+		return;
+	}
+
+	// The smallest key was removed
+	if (index == 0) {
+		mIndex.rekey(entry, bucket->mKeys[0]);
+	}
+
+	// Bucket underflowed
+	if (bucket->mCount < BucketSize / 4) {
+		refill(entry);
+	}
+}
+
+/**
+* Merges the bucket with its next (or else previous) neighbour if their items fit
+* in one bucket. Otherwise it takes items from that neighbour until the two hold
+* the same number.
+*/
+template<typename Key, typename Value, int BucketSize>
+void BucketedAVLTree<Key, Value, BucketSize>::refill(typename IndexTree::iterator entry)
+{
+	Bucket* bucket = entry->second;
+
+	if (bucket->mNext != NULL) {
+		Bucket* next = bucket->mNext;
+
+		// Merge next into bucket
+		if (bucket->mCount + next->mCount <= BucketSize) {
+			mIndex.erase(mIndex.find(next->mKeys[0]));
+
+			takeFromNext(bucket, next, next->mCount);
+			unlinkBucket(next);
+			delete next;
+		}
+
+		// Even out the two, which raises next's smallest key
+		else {
+			typename IndexTree::iterator nextEntry = mIndex.find(next->mKeys[0]);
+
+			takeFromNext(bucket, next, (next->mCount - bucket->mCount) / 2);
+			mIndex.rekey(nextEntry, next->mKeys[0]);
+		}
+	}
+
+	else if (bucket->mPrev != NULL) {
+		Bucket* prev = bucket->mPrev;
+
+		// Merge bucket into prev
+		if (bucket->mCount + prev->mCount <= BucketSize) {
+			mIndex.erase(entry);
+
+			takeFromNext(prev, bucket, bucket->mCount);
+			unlinkBucket(bucket);
+			delete bucket;
+		}
+
+		// Even out the two, which lowers bucket's smallest key
+		else {
+			takeFromPrev(bucket, prev, (prev->mCount - bucket->mCount) / 2);
+			mIndex.rekey(entry, bucket->mKeys[0]);
+		}
+	}
+}
+
+/**
+* Appends the first count items of next to bucket.
+*/
+template<typename Key, typename Value, int BucketSize>
+void BucketedAVLTree<Key, Value, BucketSize>::takeFromNext(Bucket* bucket, Bucket* next, int count)
+{
+	std::move(next->mKeys, next->mKeys + count, bucket->mKeys + bucket->mCount);
+	std::move(next->mValues, next->mValues + count, bucket->mValues + bucket->mCount);
+	bucket->mCount += count;
+
+	std::move(next->mKeys + count, next->mKeys + next->mCount, next->mKeys);
+	std::move(next->mValues + count, next->mValues + next->mCount, next->mValues);
+	next->mCount -= count;
+}
+
+/**
+* Prepends the last count items of prev to bucket.
+*/
+template<typename Key, typename Value, int BucketSize>
+void BucketedAVLTree<Key, Value, BucketSize>::takeFromPrev(Bucket* bucket, Bucket* prev, int count)
+{
+	std::move_backward(bucket->mKeys, bucket->mKeys + bucket->mCount, bucket->mKeys + bucket->mCount + count);
+	std::move_backward(bucket->mValues, bucket->mValues + bucket->mCount, bucket->mValues + bucket->mCount + count);
+	bucket->mCount += count;
+
+	std::move(prev->mKeys + prev->mCount - count, prev->mKeys + prev->mCount, bucket->mKeys);
+	std::move(prev->mValues + prev->mCount - count, prev->mValues + prev->mCount, bucket->mValues);
+	prev->mCount -= count;
+}
+
+/**
+* Unlinks a bucket from the list of buckets.
+*/
+template<typename Key, typename Value, int BucketSize>
+void BucketedAVLTree<Key, Value, BucketSize>::unlinkBucket(Bucket* bucket)
+{
+	if (bucket->mPrev != NULL) {
+		bucket->mPrev->mNext = bucket->mNext;
+	}
+
+	else {
+		mFirst = bucket->mNext;
+	}
+
+	if (bucket->mNext != NULL) {
+		bucket->mNext->mPrev = bucket->mPrev;
+	}
+
+	else {
+		mLast = bucket->mPrev;
+	}
+}
+
+/*
+------------------------------------------
+End implementations for the BucketedAVLTree class.
+------------------------------------------
+*/
+
+#endif
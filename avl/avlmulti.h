@@ -0,0 +1,375 @@
+#ifndef AVLMULTI_H
+#define AVLMULTI_H
+
+#include <vector>
+#include "augmentedavl.h"
+
+/**
+* Counts the values stored in a range of an AVLMultiMap, where every node holds the
+* list of values for its key.
+*/
+template <typename Key, typename Value>
+struct ValueCountMonoid
+{
+	typedef int Summary;
+
+	static Summary identity();
+	static Summary fromItem(const Key& key, const std::vector<Value>& values);
+	static Summary combine(const Summary& left, const Summary& right);
+};
+
+/*
+	------------------------------------------
+	Begin implementations for the ValueCountMonoid policy.
+	------------------------------------------
+*/
+
+template<typename Key, typename Value>
+typename ValueCountMonoid<Key, Value>::Summary ValueCountMonoid<Key, Value>::identity()
+{
+	return 0;
+}
+
+template<typename Key, typename Value>
+typename ValueCountMonoid<Key, Value>::Summary ValueCountMonoid<Key, Value>::fromItem(const Key& key, const std::vector<Value>& values)
+{
+	return static_cast<int>(values.size());
+}
+
+template<typename Key, typename Value>
+typename ValueCountMonoid<Key, Value>::Summary ValueCountMonoid<Key, Value>::combine(const Summary& left, const Summary& right)
+{
+	return left + right;
+}
+
+/*
+	----------------------------------------
+	End implementations for the ValueCountMonoid policy.
+	----------------------------------------
+*/
+
+/**
+* An AVL tree that allows repeated keys. Every key has a single node holding the list
+* of its values in insertion order, so repeats never make the tree taller. Each node
+* also stores the number of values in its subtree, which makes count, count_range and
+* size O(log n) or better no matter how many times a key repeats. Iterating visits
+* each distinct key once, paired with its list of values.
+*/
+template <class Key, class Value>
+class AVLMultiMap : public AugmentedAVLTree<Key, std::vector<Value>, ValueCountMonoid<Key, Value> >
+{
+public:
+	typedef AugmentedAVLTree<Key, std::vector<Value>, ValueCountMonoid<Key, Value> > Base;
+
+	// Adds a value under its key, after any values the key already has
+	void insert(const std::pair<Key, Value>& keyValuePair);
+
+	// Removes one value (the most recently inserted) for key, and the key once it
+	// has none left. Returns false if key is not in the tree.
+	bool erase_one(const Key& key);
+
+	// Removes key and every value stored under it
+	using Base::remove;
+
+	// Returns the number of values stored under key in O(log n)
+	int count(const Key& key) const;
+
+	// Returns the number of values with lo <= key < hi in O(log n)
+	int count_range(const Key& lo, const Key& hi) const;
+
+	// Returns the total number of values in O(1)
+	int size() const;
+
+	// Returns the number of distinct keys in O(1)
+	int distinct() const;
+
+	// Moves every value of other into this tree in O(n + m) and leaves other empty.
+	// For a key in both trees, other's values are appended after this tree's.
+	void merge(AVLMultiMap<Key, Value>& other);
+
+private:
+	// These would replace the list of values for a key, so they are hidden.
+	// insert(hint, item) is already hidden by insert above.
+	using Base::push_back;
+	using Base::modify;
+
+	// The merge policy, which appends theirs to mine
+	static std::vector<Value> appendValues(const std::vector<Value>& mine, const std::vector<Value>& theirs);
+};
+
+/*
+--------------------------------------------
+Begin implementations for the AVLMultiMap class.
+--------------------------------------------
+*/
+
+/**
+* Appends the value to the node for its key, or inserts a node for the key if it is
+* new, after a single search from the root. Appending changes the counts on the
+* path to the root, which are recomputed without any rotations.
+*/
+template<typename Key, typename Value>
+void AVLMultiMap<Key, Value>::insert(const std::pair<Key, Value>& keyValuePair) {
+	AVLNode<Key, std::vector<Value> >* node = this->locate(keyValuePair.first);
+
+	// New key, so it gets a node with a one value list linked under node
+	if (node == NULL || !(keyValuePair.first == node->getKey())) {
+		this->insertAt(node, std::make_pair(keyValuePair.first, std::vector<Value>(1, keyValuePair.second)));
+		return;
+	}
+
+	node->getValue().push_back(keyValuePair.second);
+
+	this->updatePath(node);
+}
+
+/**
+* Merges the nodes of both trees with the append policy.
+*/
+template<typename Key, typename Value>
+void AVLMultiMap<Key, Value>::merge(AVLMultiMap<Key, Value>& other) {
+	Base::merge(other, appendValues);
+}
+
+/**
+* Returns the values of mine followed by the values of theirs.
+*/
+template<typename Key, typename Value>
+std::vector<Value> AVLMultiMap<Key, Value>::appendValues(const std::vector<Value>& mine, const std::vector<Value>& theirs) {
+	std::vector<Value> values(mine);
+
+	values.insert(values.end(), theirs.begin(), theirs.end());
+
+	return values;
+}
+
+/**
+* Removes the last value stored under key. The node is removed with the last value.
+*/
+template<typename Key, typename Value>
+bool AVLMultiMap<Key, Value>::erase_one(const Key& key) {
+	Node<Key, std::vector<Value> >* node = BinarySearchTree<Key, std::vector<Value> >::internalFind(key);
+
+	// If key is not in the tree
+	if (node == NULL) {
+		return false;
+	}
+
+	// If this is the only value the whole node goes
+	if (node->getValue().size() == 1) {
+		this->removeNode(node);
+		return true;
+	}
+
+	node->getValue().pop_back();
+
+	this->updatePath(static_cast<AVLNode<Key, std::vector<Value> >*>(node));
+
+	return true;
+}
+
+/**
+* Returns the number of values stored under key, or 0 if key is not in the tree.
+*/
+template<typename Key, typename Value>
+int AVLMultiMap<Key, Value>::count(const Key& key) const {
+	Node<Key, std::vector<Value> >* node = BinarySearchTree<Key, std::vector<Value> >::internalFind(key);
+
+	// If key is not in the tree
+	if (node == NULL) {
+		return 0;
+	}
+
+	return static_cast<int>(node->getValue().size());
+}
+
+/**
+* Returns the number of values with lo <= key < hi, counting every repeat.
+*/
+template<typename Key, typename Value>
+int AVLMultiMap<Key, Value>::count_range(const Key& lo, const Key& hi) const {
+	return Base::aggregate(lo, hi);
+}
+
+/**
+* Returns the total number of values, counting every repeat.
+*/
+template<typename Key, typename Value>
+int AVLMultiMap<Key, Value>::size() const {
+	return Base::total();
+}
+
+/**
+* Returns the number of distinct keys, which is the number of nodes.
+*/
+template<typename Key, typename Value>
+int AVLMultiMap<Key, Value>::distinct() const {
+	return Base::size();
+}
+
+/*
+------------------------------------------
+End implementations for the AVLMultiMap class.
+------------------------------------------
+*/
+
+/**
+* An AVL tree that counts repeated keys instead of storing them. Every key has a single
+* node whose value is the number of times it was inserted, and each node stores the sum
+* of the counts in its subtree, so count, count_range and size do not depend on how
+* often a key repeats. Iterating visits each distinct key once, paired with its count.
+*/
+template <class Key>
+class AVLMultiSet : public AugmentedAVLTree<Key, int, SumMonoid<Key, int> >
+{
+public:
+	typedef AugmentedAVLTree<Key, int, SumMonoid<Key, int> > Base;
+
+	// Adds one copy of key
+	void insert(const Key& key);
+
+	// Removes one copy of key, and the key once its count reaches 0. Returns false
+	// if key is not in the tree.
+	bool erase_one(const Key& key);
+
+	// Removes key and every copy of it
+	using Base::remove;
+
+	// Returns the number of copies of key in O(log n)
+	int count(const Key& key) const;
+
+	// Returns the number of copies of keys with lo <= key < hi in O(log n)
+	int count_range(const Key& lo, const Key& hi) const;
+
+	// Returns the total number of copies in O(1)
+	int size() const;
+
+	// Returns the number of distinct keys in O(1)
+	int distinct() const;
+
+	// Moves every key of other into this tree in O(n + m) and leaves other empty.
+	// For a key in both trees, the counts are added.
+	void merge(AVLMultiSet<Key>& other);
+
+private:
+	// These would replace the count for a key, so they are hidden. insert(hint,
+	// item) is already hidden by insert above.
+	using Base::push_back;
+	using Base::modify;
+
+	// The merge policy, which adds the counts
+	static int addCounts(const int& mine, const int& theirs);
+};
+
+/*
+--------------------------------------------
+Begin implementations for the AVLMultiSet class.
+--------------------------------------------
+*/
+
+/**
+* Increments the count of key, or inserts key with a count of 1 if it is new,
+* after a single search from the root.
+*/
+template<typename Key>
+void AVLMultiSet<Key>::insert(const Key& key) {
+	AVLNode<Key, int>* node = this->locate(key);
+
+	// New key, so it gets a node with a count of 1 linked under node
+	if (node == NULL || !(key == node->getKey())) {
+		this->insertAt(node, std::make_pair(key, 1));
+		return;
+	}
+
+	++node->getValue();
+
+	this->updatePath(node);
+}
+
+/**
+* Merges the nodes of both trees with the counts added.
+*/
+template<typename Key>
+void AVLMultiSet<Key>::merge(AVLMultiSet<Key>& other) {
+	Base::merge(other, addCounts);
+}
+
+/**
+* Returns the sum of the two counts.
+*/
+template<typename Key>
+int AVLMultiSet<Key>::addCounts(const int& mine, const int& theirs) {
+	return mine + theirs;
+}
+
+/**
+* Decrements the count of key. The node is removed when the count reaches 0.
+*/
+template<typename Key>
+bool AVLMultiSet<Key>::erase_one(const Key& key) {
+	Node<Key, int>* node = BinarySearchTree<Key, int>::internalFind(key);
+
+	// If key is not in the tree
+	if (node == NULL) {
+		return false;
+	}
+
+	// If this is the last copy the whole node goes
+	if (node->getValue() == 1) {
+		this->removeNode(node);
+		return true;
+	}
+
+	--node->getValue();
+
+	this->updatePath(static_cast<AVLNode<Key, int>*>(node));
+
+	return true;
+}
+
+/**
+* Returns the number of copies of key, or 0 if key is not in the tree.
+*/
+template<typename Key>
+int AVLMultiSet<Key>::count(const Key& key) const {
+	Node<Key, int>* node = BinarySearchTree<Key, int>::internalFind(key);
+
+	// If key is not in the tree
+	if (node == NULL) {
+		return 0;
+	}
+
+	return node->getValue();
+}
+
+/**
+* Returns the number of copies of keys with lo <= key < hi.
+*/
+template<typename Key>
+int AVLMultiSet<Key>::count_range(const Key& lo, const Key& hi) const {
+	return Base::aggregate(lo, hi);
+}
+
+/**
+* Returns the total number of copies of all keys.
+*/
+template<typename Key>
+int AVLMultiSet<Key>::size() const {
+	return Base::total();
+}
+
+/**
+* Returns the number of distinct keys, which is the number of nodes.
+*/
+template<typename Key>
+int AVLMultiSet<Key>::distinct() const {
+	return Base::size();
+}
+
+/*
+------------------------------------------
+End implementations for the AVLMultiSet class.
+------------------------------------------
+*/
+
+#endif
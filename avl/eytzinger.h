@@ -0,0 +1,475 @@
+#ifndef EYTZINGER_H
+#define EYTZINGER_H
+
+#include <cstdlib>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+/**
+* An immutable sorted map stored as one array in Eytzinger (breadth-first) order:
+* the root is at index 1 and the children of index k are at 2k and 2k + 1, so a
+* search reads the array top to bottom and no pointers are stored. The first few
+* levels of the implicit tree share cache lines and stay cached across lookups.
+* Each step of a search picks the next index with arithmetic instead of a branch,
+* and prefetches the cache line holding the node's descendants as many levels down
+* as fit in one line (four levels for 4-byte keys), so the memory accesses of
+* upcoming levels overlap instead of waiting on each other.
+*
+* Keys and values are kept in separate arrays so that searches only touch keys.
+* Iterators visit the items in key order and dereference to a std::pair of const
+* references to the key and value. Made by AVLTree::freeze().
+*/
+template <class Key, class Value>
+class EytzingerSnapshot
+{
+public:
+	EytzingerSnapshot();
+
+	// Builds the snapshot from count items in increasing key order
+	template <typename Iterator>
+	EytzingerSnapshot(Iterator first, int count);
+
+	/**
+	* A read only iterator over the items in key order. It moves between array
+	* indices with the in-order successor and predecessor of the implicit tree, in
+	* amortized O(1).
+	*/
+	class const_iterator
+	{
+	public:
+		typedef std::bidirectional_iterator_tag iterator_category;
+		typedef std::pair<Key, Value> value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef std::pair<const Key&, const Value&> reference;
+
+		// Holds the pair of references so that -> has something to point at
+		class pointer
+		{
+		public:
+			pointer(const reference& item);
+			const reference* operator->() const;
+
+		private:
+			reference mItem;
+		};
+
+		const_iterator();
+		const_iterator(std::size_t index, const EytzingerSnapshot<Key, Value>* snapshot);
+
+		reference operator*() const;
+		pointer operator->() const;
+
+		bool operator==(const const_iterator& rhs) const;
+		bool operator!=(const const_iterator& rhs) const;
+
+		const_iterator& operator++();
+		const_iterator operator++(int);
+		const_iterator& operator--();
+		const_iterator operator--(int);
+
+	protected:
+		// Array index of the item, or 0 for end()
+		std::size_t mIndex;
+		const EytzingerSnapshot<Key, Value>* mSnapshot;
+	};
+
+	// Nothing can be changed through either kind of iterator
+	typedef const_iterator iterator;
+
+	const_iterator begin() const;
+	const_iterator end() const;
+
+	const_iterator find(const Key& key) const;
+
+	// First item with key >= key, or end() if there is none
+	const_iterator lower_bound(const Key& key) const;
+
+	// Returns the number of items in O(1)
+	int size() const;
+	bool empty() const;
+
+private:
+	// Returns the array index of the first key >= key, or 0 if there is none
+	std::size_t search(const Key& key) const;
+
+	// In-order neighbours of an index in the implicit tree, 0 if there are none
+	std::size_t next(std::size_t index) const;
+	std::size_t prev(std::size_t index) const;
+
+	// Index of the smallest and largest keys, 0 for an empty snapshot
+	std::size_t first() const;
+	std::size_t last() const;
+
+	// Descendants prefetched per search step: the largest power of two whose keys
+	// fit in a 64-byte cache line, at least 1
+	static const std::size_t Lookahead = (64 / sizeof(Key) >= 64) ? 64 : (64 / sizeof(Key) >= 32) ? 32
+		: (64 / sizeof(Key) >= 16) ? 16 : (64 / sizeof(Key) >= 8) ? 8 : (64 / sizeof(Key) >= 4) ? 4
+		: (64 / sizeof(Key) >= 2) ? 2 : 1;
+
+	// Index 0 is unused so that the children of k are at 2k and 2k + 1
+	std::vector<Key> mKeys;
+	std::vector<Value> mValues;
+	std::size_t mCount;
+};
+
+/*
+	------------------------------------------------------------------------
+	Begin implementations for the EytzingerSnapshot::const_iterator class.
+	------------------------------------------------------------------------
+*/
+
+/**
+* Stores the pair of references returned by operator*.
+*/
+template<typename Key, typename Value>
+EytzingerSnapshot<Key, Value>::const_iterator::pointer::pointer(const reference& item)
+	: mItem(item)
+{
+
+}
+
+/**
+* Provides access to the stored pair.
+*/
+template<typename Key, typename Value>
+const typename EytzingerSnapshot<Key, Value>::const_iterator::reference*
+EytzingerSnapshot<Key, Value>::const_iterator::pointer::operator->() const
+{
+	return &mItem;
+}
+
+/**
+* A default constructor that initializes the iterator to end().
+*/
+template<typename Key, typename Value>
+EytzingerSnapshot<Key, Value>::const_iterator::const_iterator()
+	: mIndex(0)
+	, mSnapshot(NULL)
+{
+
+}
+
+/**
+* Constructor that points the iterator at an array index of a snapshot.
+*/
+template<typename Key, typename Value>
+EytzingerSnapshot<Key, Value>::const_iterator::const_iterator(std::size_t index, const EytzingerSnapshot<Key, Value>* snapshot)
+	: mIndex(index)
+	, mSnapshot(snapshot)
+{
+
+}
+
+/**
+* Provides read access to the key and value.
+*/
+template<typename Key, typename Value>
+typename EytzingerSnapshot<Key, Value>::const_iterator::reference EytzingerSnapshot<Key, Value>::const_iterator::operator*() const
+{
+	return reference(mSnapshot->mKeys[mIndex], mSnapshot->mValues[mIndex]);
+}
+
+/**
+* Provides read access to the key and value through ->first and ->second.
+*/
+template<typename Key, typename Value>
+typename EytzingerSnapshot<Key, Value>::const_iterator::pointer EytzingerSnapshot<Key, Value>::const_iterator::operator->() const
+{
+	return pointer(**this);
+}
+
+/**
+* Checks if 'this' iterator points at the same item as 'rhs'.
+*/
+template<typename Key, typename Value>
+bool EytzingerSnapshot<Key, Value>::const_iterator::operator==(const const_iterator& rhs) const
+{
+	return mIndex == rhs.mIndex;
+}
+
+/**
+* Checks if 'this' iterator points at a different item than 'rhs'.
+*/
+template<typename Key, typename Value>
+bool EytzingerSnapshot<Key, Value>::const_iterator::operator!=(const const_iterator& rhs) const
+{
+	return mIndex != rhs.mIndex;
+}
+
+/**
+* Advances the iterator to the next item.
+*/
+template<typename Key, typename Value>
+typename EytzingerSnapshot<Key, Value>::const_iterator& EytzingerSnapshot<Key, Value>::const_iterator::operator++()
+{
+	mIndex = mSnapshot->next(mIndex);
+	return *this;
+}
+
+/**
+* Post-increment.
+*/
+template<typename Key, typename Value>
+typename EytzingerSnapshot<Key, Value>::const_iterator EytzingerSnapshot<Key, Value>::const_iterator::operator++(int)
+{
+	const_iterator copy(*this);
+	++(*this);
+	return copy;
+}
+
+/**
+* Moves the iterator to the previous item. Decrementing end() moves to the last item.
+*/
+template<typename Key, typename Value>
+typename EytzingerSnapshot<Key, Value>::const_iterator& EytzingerSnapshot<Key, Value>::const_iterator::operator--()
+{
+	mIndex = (mIndex == 0) ? mSnapshot->last() : mSnapshot->prev(mIndex);
+	return *this;
+}
+
+/**
+* Post-decrement.
+*/
+template<typename Key, typename Value>
+typename EytzingerSnapshot<Key, Value>::const_iterator EytzingerSnapshot<Key, Value>::const_iterator::operator--(int)
+{
+	const_iterator copy(*this);
+	--(*this);
+	return copy;
+}
+
+/*
+	----------------------------------------------------------------------
+	End implementations for the EytzingerSnapshot::const_iterator class.
+	----------------------------------------------------------------------
+*/
+
+/*
+--------------------------------------------
+Begin implementations for the EytzingerSnapshot class.
+--------------------------------------------
+*/
+
+/**
+* Default constructor for an empty snapshot.
+*/
+template<typename Key, typename Value>
+EytzingerSnapshot<Key, Value>::EytzingerSnapshot()
+	: mKeys(1)
+	, mValues(1)
+	, mCount(0)
+{
+
+}
+
+/**
+* Fills the array indices in in-order order, which is the order the sorted items
+* arrive in, so each item lands at its place in the implicit tree.
+*/
+template<typename Key, typename Value>
+template<typename Iterator>
+EytzingerSnapshot<Key, Value>::EytzingerSnapshot(Iterator first, int count)
+	: mKeys(count + 1)
+	, mValues(count + 1)
+	, mCount(count)
+{
+	for (std::size_t index = this->first(); index != 0; index = next(index)) {
+		mKeys[index] = first->first;
+		mValues[index] = first->second;
+		++first;
+	}
+}
+
+/**
+* Returns the number of items in O(1).
+*/
+template<typename Key, typename Value>
+int EytzingerSnapshot<Key, Value>::size() const
+{
+	return static_cast<int>(mCount);
+}
+
+/**
+* Returns true if the snapshot holds no items.
+*/
+template<typename Key, typename Value>
+bool EytzingerSnapshot<Key, Value>::empty() const
+{
+	return mCount == 0;
+}
+
+/**
+* Returns the index of the smallest key: the leftmost path from the root.
+*/
+template<typename Key, typename Value>
+std::size_t EytzingerSnapshot<Key, Value>::first() const
+{
+	// Empty snapshot
+	if (mCount == 0) {
+		return 0;
+	}
+
+	std::size_t index = 1;
+
+	while (2 * index <= mCount) {
+		index = 2 * index;
+	}
+
+	return index;
+}
+
+/**
+* Returns the index of the largest key: the rightmost path from the root.
+*/
+template<typename Key, typename Value>
+std::size_t EytzingerSnapshot<Key, Value>::last() const
+{
+	// Empty snapshot
+	if (mCount == 0) {
+		return 0;
+	}
+
+	std::size_t index = 1;
+
+	while (2 * index + 1 <= mCount) {
+		index = 2 * index + 1;
+	}
+
+	return index;
+}
+
+/**
+* Returns the in-order successor of index. With a right child, it is the leftmost
+* index below the right child. Otherwise it is the first ancestor reached from a
+* left child: drop the trailing 1 bits (right turns) and then one more bit.
+*/
+template<typename Key, typename Value>
+std::size_t EytzingerSnapshot<Key, Value>::next(std::size_t index) const
+{
+	// Has a right child
+	if (2 * index + 1 <= mCount) {
+		index = 2 * index + 1;
+
+		while (2 * index <= mCount) {
+			index = 2 * index;
+		}
+
+		return index;
+	}
+
+	// Climb past the right turns and the left turn above them
+	while (index & 1) {
+		index >>= 1;
+	}
+
+	return index >> 1;
+}
+
+/**
+* Returns the in-order predecessor of index, mirroring next().
+*/
+template<typename Key, typename Value>
+std::size_t EytzingerSnapshot<Key, Value>::prev(std::size_t index) const
+{
+	// Has a left child
+	if (2 * index <= mCount) {
+		index = 2 * index;
+
+		while (2 * index + 1 <= mCount) {
+			index = 2 * index + 1;
+		}
+
+		return index;
+	}
+
+	// Climb past the left turns and the right turn above them
+	while (index != 0 && !(index & 1)) {
+		index >>= 1;
+	}
+
+	return index >> 1;
+}
+
+/**
+* Searches for the first key >= key. Each step goes to child 2k + (keys[k] < key)
+* with no branch on the comparison, prefetching the Lookahead descendants that
+* share a cache line a few levels down first. After falling off the bottom, the last left turn is undone by
+* dropping the trailing 1 bits (right turns) and the 0 bit before them, which
+* leaves the index of the answer, or 0 if every key was smaller.
+*/
+template<typename Key, typename Value>
+std::size_t EytzingerSnapshot<Key, Value>::search(const Key& key) const
+{
+	const Key* keys = mKeys.data();
+	std::size_t index = 1;
+
+	while (index <= mCount) {
+		// The Lookahead descendants log2(Lookahead) levels down are next to each other
+		if (Lookahead * index <= mCount) {
+			__builtin_prefetch(keys + Lookahead * index);
+		}
+
+		index = 2 * index + (keys[index] < key);
+	}
+
+	// Drop the right turns at the bottom, then the left turn above them
+	while (index & 1) {
+		index >>= 1;
+	}
+
+	return index >> 1;
+}
+
+/**
+* Returns an iterator to the smallest item.
+*/
+template<typename Key, typename Value>
+typename EytzingerSnapshot<Key, Value>::const_iterator EytzingerSnapshot<Key, Value>::begin() const
+{
+	return const_iterator(first(), this);
+}
+
+/**
+* Returns an iterator past the largest item.
+*/
+template<typename Key, typename Value>
+typename EytzingerSnapshot<Key, Value>::const_iterator EytzingerSnapshot<Key, Value>::end() const
+{
+	return const_iterator(0, this);
+}
+
+/**
+* Returns an iterator to the item with the given key, or end() if it is not in
+* the snapshot.
+*/
+template<typename Key, typename Value>
+typename EytzingerSnapshot<Key, Value>::const_iterator EytzingerSnapshot<Key, Value>::find(const Key& key) const
+{
+	std::size_t index = search(key);
+
+	// The first key >= key is key itself
+	if (index != 0 && !(key < mKeys[index])) {
+		return const_iterator(index, this);
+	}
+
+	return end();
+}
+
+/**
+* Returns an iterator to the first item with a key >= key.
+*/
+template<typename Key, typename Value>
+typename EytzingerSnapshot<Key, Value>::const_iterator EytzingerSnapshot<Key, Value>::lower_bound(const Key& key) const
+{
+	return const_iterator(search(key), this);
+}
+
+/*
+------------------------------------------
+End implementations for the EytzingerSnapshot class.
+------------------------------------------
+*/
+
+#endif
@@ -0,0 +1,476 @@
+#ifndef LEARNEDINDEX_H
+#define LEARNEDINDEX_H
+
+#include <cstdlib>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+/**
+* An immutable sorted map for integer keys whose lookups are guided by a learned
+* index, in the style of the PGM index. The items are kept in one sorted array, and
+* the keys are split into segments that each fit a straight line: for every key in
+* a segment, firstIndex + slope * (key - firstKey) is within epsilon of the key's
+* position in the array. A lookup binary searches the (few) segment start keys,
+* predicts a position with the segment's line and finishes with a binary search of
+* the 2 * epsilon + 3 positions around the prediction. Dense key spaces need very
+* few segments, so most of the work is the last tiny search.
+*
+* A smaller epsilon means more segments, which take longer to build and search but
+* leave a smaller window at the end. Iterators visit the items in key order and
+* dereference to a std::pair of const references to the key and value. Made by
+* AVLTree::freezeLearned().
+*/
+template <class Key, class Value>
+class LearnedIndexSnapshot
+{
+	static_assert(std::is_integral<Key>::value, "LearnedIndexSnapshot keys must be integers");
+
+public:
+	LearnedIndexSnapshot();
+
+	// Builds the snapshot from count items in increasing key order. Positions are
+	// predicted to within epsilon, which must be at least 1.
+	template <typename Iterator>
+	LearnedIndexSnapshot(Iterator first, int count, int epsilon);
+
+	/**
+	* A read only iterator over the items in key order.
+	*/
+	class const_iterator
+	{
+	public:
+		typedef std::bidirectional_iterator_tag iterator_category;
+		typedef std::pair<Key, Value> value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef std::pair<const Key&, const Value&> reference;
+
+		// Holds the pair of references so that -> has something to point at
+		class pointer
+		{
+		public:
+			pointer(const reference& item);
+			const reference* operator->() const;
+
+		private:
+			reference mItem;
+		};
+
+		const_iterator();
+		const_iterator(std::size_t index, const LearnedIndexSnapshot<Key, Value>* snapshot);
+
+		reference operator*() const;
+		pointer operator->() const;
+
+		bool operator==(const const_iterator& rhs) const;
+		bool operator!=(const const_iterator& rhs) const;
+
+		const_iterator& operator++();
+		const_iterator operator++(int);
+		const_iterator& operator--();
+		const_iterator operator--(int);
+
+	protected:
+		// Position of the item in the sorted array, or the item count for end()
+		std::size_t mIndex;
+		const LearnedIndexSnapshot<Key, Value>* mSnapshot;
+	};
+
+	// Nothing can be changed through either kind of iterator
+	typedef const_iterator iterator;
+
+	const_iterator begin() const;
+	const_iterator end() const;
+
+	const_iterator find(const Key& key) const;
+
+	// First item with key >= key, or end() if there is none
+	const_iterator lower_bound(const Key& key) const;
+
+	// Returns the number of items in O(1)
+	int size() const;
+	bool empty() const;
+
+	// Returns the number of line segments the keys were split into
+	int segments() const;
+
+private:
+	typedef typename std::make_unsigned<Key>::type UnsignedKey;
+
+	// A line through the positions of the keys from mSegmentKeys[i] up to the next
+	// segment's first key
+	struct Segment
+	{
+		std::size_t mFirstIndex;
+		double mSlope;
+	};
+
+	// Splits the keys into as few segments as the greedy shrinking cone allows
+	void buildSegments();
+
+	// Returns the position of the first key >= key
+	std::size_t search(const Key& key) const;
+
+	// Distance from first to key as a double, without overflowing signed keys
+	static double keyDistance(const Key& first, const Key& key);
+
+	std::vector<Key> mKeys;
+	std::vector<Value> mValues;
+
+	// First key of every segment, kept apart from the lines for a compact search
+	std::vector<Key> mSegmentKeys;
+	std::vector<Segment> mSegments;
+
+	int mEpsilon;
+};
+
+/*
+	---------------------------------------------------------------------------
+	Begin implementations for the LearnedIndexSnapshot::const_iterator class.
+	---------------------------------------------------------------------------
+*/
+
+/**
+* Stores the pair of references returned by operator*.
+*/
+template<typename Key, typename Value>
+LearnedIndexSnapshot<Key, Value>::const_iterator::pointer::pointer(const reference& item)
+	: mItem(item)
+{
+
+}
+
+/**
+* Provides access to the stored pair.
+*/
+template<typename Key, typename Value>
+const typename LearnedIndexSnapshot<Key, Value>::const_iterator::reference*
+LearnedIndexSnapshot<Key, Value>::const_iterator::pointer::operator->() const
+{
+	return &mItem;
+}
+
+/**
+* A default constructor that initializes the iterator to NULL.
+*/
+template<typename Key, typename Value>
+LearnedIndexSnapshot<Key, Value>::const_iterator::const_iterator()
+	: mIndex(0)
+	, mSnapshot(NULL)
+{
+
+}
+
+/**
+* Constructor that points the iterator at a position of a snapshot.
+*/
+template<typename Key, typename Value>
+LearnedIndexSnapshot<Key, Value>::const_iterator::const_iterator(std::size_t index, const LearnedIndexSnapshot<Key, Value>* snapshot)
+	: mIndex(index)
+	, mSnapshot(snapshot)
+{
+
+}
+
+/**
+* Provides read access to the key and value.
+*/
+template<typename Key, typename Value>
+typename LearnedIndexSnapshot<Key, Value>::const_iterator::reference LearnedIndexSnapshot<Key, Value>::const_iterator::operator*() const
+{
+	return reference(mSnapshot->mKeys[mIndex], mSnapshot->mValues[mIndex]);
+}
+
+/**
+* Provides read access to the key and value through ->first and ->second.
+*/
+template<typename Key, typename Value>
+typename LearnedIndexSnapshot<Key, Value>::const_iterator::pointer LearnedIndexSnapshot<Key, Value>::const_iterator::operator->() const
+{
+	return pointer(**this);
+}
+
+/**
+* Checks if 'this' iterator points at the same item as 'rhs'.
+*/
+template<typename Key, typename Value>
+bool LearnedIndexSnapshot<Key, Value>::const_iterator::operator==(const const_iterator& rhs) const
+{
+	return mIndex == rhs.mIndex;
+}
+
+/**
+* Checks if 'this' iterator points at a different item than 'rhs'.
+*/
+template<typename Key, typename Value>
+bool LearnedIndexSnapshot<Key, Value>::const_iterator::operator!=(const const_iterator& rhs) const
+{
+	return mIndex != rhs.mIndex;
+}
+
+/**
+* Advances the iterator to the next item.
+*/
+template<typename Key, typename Value>
+typename LearnedIndexSnapshot<Key, Value>::const_iterator& LearnedIndexSnapshot<Key, Value>::const_iterator::operator++()
+{
+	++mIndex;
+	return *this;
+}
+
+/**
+* Post-increment.
+*/
+template<typename Key, typename Value>
+typename LearnedIndexSnapshot<Key, Value>::const_iterator LearnedIndexSnapshot<Key, Value>::const_iterator::operator++(int)
+{
+	const_iterator copy(*this);
+	++mIndex;
+	return copy;
+}
+
+/**
+* Moves the iterator to the previous item.
+*/
+template<typename Key, typename Value>
+typename LearnedIndexSnapshot<Key, Value>::const_iterator& LearnedIndexSnapshot<Key, Value>::const_iterator::operator--()
+{
+	--mIndex;
+	return *this;
+}
+
+/**
+* Post-decrement.
+*/
+template<typename Key, typename Value>
+typename LearnedIndexSnapshot<Key, Value>::const_iterator LearnedIndexSnapshot<Key, Value>::const_iterator::operator--(int)
+{
+	const_iterator copy(*this);
+	--mIndex;
+	return copy;
+}
+
+/*
+	-------------------------------------------------------------------------
+	End implementations for the LearnedIndexSnapshot::const_iterator class.
+	-------------------------------------------------------------------------
+*/
+
+/*
+--------------------------------------------
+Begin implementations for the LearnedIndexSnapshot class.
+--------------------------------------------
+*/
+
+/**
+* Default constructor for an empty snapshot.
+*/
+template<typename Key, typename Value>
+LearnedIndexSnapshot<Key, Value>::LearnedIndexSnapshot()
+	: mEpsilon(1)
+{
+
+}
+
+/**
+* Copies the items and fits the segments to their keys.
+*/
+template<typename Key, typename Value>
+template<typename Iterator>
+LearnedIndexSnapshot<Key, Value>::LearnedIndexSnapshot(Iterator first, int count, int epsilon)
+	: mEpsilon(std::max(epsilon, 1))
+{
+	mKeys.reserve(count);
+	mValues.reserve(count);
+
+	for (int i = 0; i < count; ++i) {
+		mKeys.push_back(first->first);
+		mValues.push_back(first->second);
+		++first;
+	}
+
+	buildSegments();
+}
+
+/**
+* Returns the number of items in O(1).
+*/
+template<typename Key, typename Value>
+int LearnedIndexSnapshot<Key, Value>::size() const
+{
+	return static_cast<int>(mKeys.size());
+}
+
+/**
+* Returns true if the snapshot holds no items.
+*/
+template<typename Key, typename Value>
+bool LearnedIndexSnapshot<Key, Value>::empty() const
+{
+	return mKeys.empty();
+}
+
+/**
+* Returns the number of line segments.
+*/
+template<typename Key, typename Value>
+int LearnedIndexSnapshot<Key, Value>::segments() const
+{
+	return static_cast<int>(mSegments.size());
+}
+
+/**
+* Returns key - first as a double. The subtraction is done unsigned, which is exact
+* for key >= first even when the signed difference would overflow.
+*/
+template<typename Key, typename Value>
+double LearnedIndexSnapshot<Key, Value>::keyDistance(const Key& first, const Key& key)
+{
+	return static_cast<double>(static_cast<UnsignedKey>(static_cast<UnsignedKey>(key) - static_cast<UnsignedKey>(first)));
+}
+
+/**
+* Fits segments in one pass with the shrinking cone method. A segment starts at a
+* key and its position, and keeps the range of slopes that put every key seen so
+* far within epsilon of its position. Each new key narrows the range; a key that
+* would leave it empty starts the next segment. The slope used is the middle of
+* the range, and never negative so predictions grow with the key.
+*/
+template<typename Key, typename Value>
+void LearnedIndexSnapshot<Key, Value>::buildSegments()
+{
+	std::size_t count = mKeys.size();
+	std::size_t start = 0;
+
+	while (start < count) {
+		double lowSlope = 0;
+		double highSlope = 0;
+
+		std::size_t end = start + 1;
+
+		// Grow the segment while some slope still fits every key in it
+		for (; end < count; ++end) {
+			double distance = keyDistance(mKeys[start], mKeys[end]);
+			double offset = static_cast<double>(end - start);
+
+			double low = (offset - mEpsilon) / distance;
+			double high = (offset + mEpsilon) / distance;
+
+			// The first key after the start sets the range
+			if (end == start + 1) {
+				lowSlope = low;
+				highSlope = high;
+				continue;
+			}
+
+			// No slope fits this key as well
+			if (low > highSlope || high < lowSlope) {
+				break;
+			}
+
+			lowSlope = std::max(lowSlope, low);
+			highSlope = std::min(highSlope, high);
+		}
+
+		Segment segment;
+		segment.mFirstIndex = start;
+		segment.mSlope = std::max((lowSlope + highSlope) / 2, 0.0);
+
+		mSegmentKeys.push_back(mKeys[start]);
+		mSegments.push_back(segment);
+
+		start = end;
+	}
+}
+
+/**
+* Finds the last segment starting at or before key, predicts a position with its
+* line and searches the window of positions the prediction can be off by. The
+* prediction is kept inside the segment. Rounding could in principle push the
+* answer just outside the window, so that case falls back to searching the whole
+* array.
+*/
+template<typename Key, typename Value>
+std::size_t LearnedIndexSnapshot<Key, Value>::search(const Key& key) const
+{
+	// Before every key, or empty
+	if (mKeys.empty() || key < mKeys[0]) {
+		return 0;
+	}
+
+	std::size_t segmentIndex = std::upper_bound(mSegmentKeys.begin(), mSegmentKeys.end(), key) - mSegmentKeys.begin() - 1;
+	const Segment& segment = mSegments[segmentIndex];
+
+	// Positions the segment covers, plus the one after it for keys past its end
+	std::size_t segmentEnd = (segmentIndex + 1 < mSegments.size()) ? mSegments[segmentIndex + 1].mFirstIndex : mKeys.size();
+
+	double predicted = segment.mFirstIndex + segment.mSlope * keyDistance(mSegmentKeys[segmentIndex], key);
+	std::size_t position = static_cast<std::size_t>(std::min(predicted, static_cast<double>(segmentEnd)));
+
+	std::size_t low = (position > segment.mFirstIndex + mEpsilon + 1) ? position - mEpsilon - 1 : segment.mFirstIndex;
+	std::size_t high = std::min(position + mEpsilon + 2, mKeys.size());
+
+	std::size_t index = std::lower_bound(mKeys.begin() + low, mKeys.begin() + high, key) - mKeys.begin();
+
+	// The answer is outside the window
+	if ((index == low && low > 0 && !(mKeys[low - 1] < key)) || (index == high && high < mKeys.size())) {
+		return std::lower_bound(mKeys.begin(), mKeys.end(), key) - mKeys.begin();
+	}
+
+	return index;
+}
+
+/**
+* Returns an iterator to the smallest item.
+*/
+template<typename Key, typename Value>
+typename LearnedIndexSnapshot<Key, Value>::const_iterator LearnedIndexSnapshot<Key, Value>::begin() const
+{
+	return const_iterator(0, this);
+}
+
+/**
+* Returns an iterator past the largest item.
+*/
+template<typename Key, typename Value>
+typename LearnedIndexSnapshot<Key, Value>::const_iterator LearnedIndexSnapshot<Key, Value>::end() const
+{
+	return const_iterator(mKeys.size(), this);
+}
+
+/**
+* Returns an iterator to the item with the given key, or end() if it is not in
+* the snapshot.
+*/
+template<typename Key, typename Value>
+typename LearnedIndexSnapshot<Key, Value>::const_iterator LearnedIndexSnapshot<Key, Value>::find(const Key& key) const
+{
+	std::size_t index = search(key);
+
+	// The first key >= key is key itself
+	if (index < mKeys.size() && !(key < mKeys[index])) {
+		return const_iterator(index, this);
+	}
+
+	return end();
+}
+
+/**
+* Returns an iterator to the first item with a key >= key.
+*/
+template<typename Key, typename Value>
+typename LearnedIndexSnapshot<Key, Value>::const_iterator LearnedIndexSnapshot<Key, Value>::lower_bound(const Key& key) const
+{
+	return const_iterator(search(key), this);
+}
+
+/*
+------------------------------------------
+End implementations for the LearnedIndexSnapshot class.
+------------------------------------------
+*/
+
+#endif
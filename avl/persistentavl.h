@@ -0,0 +1,654 @@
+#ifndef PERSISTENTAVL_H
+#define PERSISTENTAVL_H
+
+#include <iostream>
+#include <cstdlib>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+/**
+* An immutable node of a PersistentAVLTree. Nodes never change after they are built
+* and have no parent pointer, so one node can be shared by many versions of a tree.
+* Nodes are reference counted and freed when the last version using them is gone.
+*/
+template <typename Key, typename Value>
+class PersistentAVLNode
+{
+public:
+	typedef std::shared_ptr<const PersistentAVLNode<Key, Value> > Ptr;
+
+	PersistentAVLNode(const std::pair<Key, Value>& item, const Ptr& left, const Ptr& right);
+
+	const std::pair<Key, Value>& getItem() const;
+	const Key& getKey() const;
+	const Value& getValue() const;
+
+	const Ptr& getLeft() const;
+	const Ptr& getRight() const;
+
+	int getHeight() const;
+	int getSize() const;
+
+protected:
+	std::pair<Key, Value> mItem;
+	Ptr mLeft;
+	Ptr mRight;
+	int mHeight;
+	int mSize;
+};
+
+/*
+--------------------------------------------
+Begin implementations for the PersistentAVLNode class.
+--------------------------------------------
+*/
+
+/**
+* Constructor for a PersistentAVLNode. The height and subtree size are computed from
+* the children, which are complete when the node is built.
+*/
+template<typename Key, typename Value>
+PersistentAVLNode<Key, Value>::PersistentAVLNode(const std::pair<Key, Value>& item, const Ptr& left, const Ptr& right)
+	: mItem(item)
+	, mLeft(left)
+	, mRight(right)
+	, mHeight(1)
+	, mSize(1)
+{
+	int leftHeight = (left != NULL) ? left->getHeight() : 0;
+	int rightHeight = (right != NULL) ? right->getHeight() : 0;
+
+	mHeight = std::max(leftHeight, rightHeight) + 1;
+
+	mSize = ((left != NULL) ? left->getSize() : 0) + ((right != NULL) ? right->getSize() : 0) + 1;
+}
+
+/**
+* Getter function for the key/value pair.
+*/
+template<typename Key, typename Value>
+const std::pair<Key, Value>& PersistentAVLNode<Key, Value>::getItem() const
+{
+	return mItem;
+}
+
+/**
+* Getter function for the key.
+*/
+template<typename Key, typename Value>
+const Key& PersistentAVLNode<Key, Value>::getKey() const
+{
+	return mItem.first;
+}
+
+/**
+* Getter function for the value.
+*/
+template<typename Key, typename Value>
+const Value& PersistentAVLNode<Key, Value>::getValue() const
+{
+	return mItem.second;
+}
+
+/**
+* Getter function for the left child.
+*/
+template<typename Key, typename Value>
+const typename PersistentAVLNode<Key, Value>::Ptr& PersistentAVLNode<Key, Value>::getLeft() const
+{
+	return mLeft;
+}
+
+/**
+* Getter function for the right child.
+*/
+template<typename Key, typename Value>
+const typename PersistentAVLNode<Key, Value>::Ptr& PersistentAVLNode<Key, Value>::getRight() const
+{
+	return mRight;
+}
+
+/**
+* Getter function for the height. A leaf has a height of 1.
+*/
+template<typename Key, typename Value>
+int PersistentAVLNode<Key, Value>::getHeight() const
+{
+	return mHeight;
+}
+
+/**
+* Getter function for the number of nodes in the subtree.
+*/
+template<typename Key, typename Value>
+int PersistentAVLNode<Key, Value>::getSize() const
+{
+	return mSize;
+}
+
+/*
+------------------------------------------
+End implementations for the PersistentAVLNode class.
+------------------------------------------
+*/
+
+/**
+* A persistent AVL tree. insert and remove never modify existing nodes; they build
+* new copies of the O(log n) nodes on the search path and share every other node
+* with the previous version. Copying a tree (or calling snapshot()) only copies the
+* root pointer, so a snapshot is O(1) and stays valid and unchanged no matter what
+* is done to the tree it was taken from.
+*
+* Nodes are freed by reference counting once no version uses them. The counts are
+* atomic, so a snapshot can be handed to a reader thread while the writer keeps
+* changing its own copy. A single tree object must not be used by several threads
+* at once while one of them writes to it.
+*/
+template <class Key, class Value>
+class PersistentAVLTree
+{
+public:
+	typedef PersistentAVLNode<Key, Value> NodeType;
+	typedef typename NodeType::Ptr Ptr;
+
+	PersistentAVLTree();
+
+	void insert(const std::pair<Key, Value>& keyValuePair);
+	void remove(const Key& key);
+	void clear();
+
+	// Returns a version of the tree that later changes to this tree do not affect
+	PersistentAVLTree<Key, Value> snapshot() const;
+
+	int size() const;
+	bool empty() const;
+
+	/**
+	* A read-only in-order iterator. It keeps the version it was created from
+	* alive, so it stays valid while the tree is changed.
+	*/
+	class const_iterator
+	{
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef std::pair<Key, Value> value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const std::pair<Key, Value>* pointer;
+		typedef const std::pair<Key, Value>& reference;
+
+		const_iterator();
+
+		const std::pair<Key, Value>& operator*() const;
+		const std::pair<Key, Value>* operator->() const;
+
+		bool operator==(const const_iterator& rhs) const;
+		bool operator!=(const const_iterator& rhs) const;
+
+		const_iterator& operator++();
+		const_iterator operator++(int);
+
+	protected:
+		// Pushes node and its left spine
+		void pushLeftSpine(const NodeType* node);
+
+		// The nodes whose items have not been visited yet on the path from the
+		// root, with the current node on top. Empty for the end iterator.
+		std::vector<const NodeType*> mStack;
+		Ptr mRoot;
+
+		friend class PersistentAVLTree<Key, Value>;
+	};
+
+	typedef const_iterator iterator;
+
+	const_iterator begin() const;
+	const_iterator end() const;
+	const_iterator find(const Key& key) const;
+
+protected:
+	// Builds a node from its parts and restores the AVL property at that node
+	static Ptr balance(const std::pair<Key, Value>& item, const Ptr& left, const Ptr& right);
+
+	// Copy the search path and return the root of the new version of the subtree.
+	// removeHelper must only be called with a key that is in the subtree.
+	static Ptr insertHelper(const Ptr& node, const std::pair<Key, Value>& keyValuePair);
+	static Ptr removeHelper(const Ptr& node, const Key& key);
+
+	// Returns true if key is in this version, without touching any reference counts
+	bool contains(const Key& key) const;
+
+	// Returns the subtree without its smallest node, which is stored in smallest
+	static Ptr removeSmallest(const Ptr& node, Ptr& smallest);
+
+	// Returns the height of a subtree, or 0 for NULL
+	static int getSubtreeHeight(const Ptr& node);
+
+protected:
+	Ptr mRoot;
+};
+
+/*
+--------------------------------------------------------------
+Begin implementations for the PersistentAVLTree::const_iterator class.
+--------------------------------------------------------------
+*/
+
+/**
+* A default constructor that initializes the iterator to the end.
+*/
+template<typename Key, typename Value>
+PersistentAVLTree<Key, Value>::const_iterator::const_iterator()
+{
+
+}
+
+/**
+* Provides read access to the item.
+*/
+template<typename Key, typename Value>
+const std::pair<Key, Value>& PersistentAVLTree<Key, Value>::const_iterator::operator*() const
+{
+	return mStack.back()->getItem();
+}
+
+/**
+* Provides read access to the address of the item.
+*/
+template<typename Key, typename Value>
+const std::pair<Key, Value>* PersistentAVLTree<Key, Value>::const_iterator::operator->() const
+{
+	return &(mStack.back()->getItem());
+}
+
+/**
+* Checks if 'this' iterator points at the same node as 'rhs'
+*/
+template<typename Key, typename Value>
+bool PersistentAVLTree<Key, Value>::const_iterator::operator==(const const_iterator& rhs) const
+{
+	// Both are end iterators
+	if (mStack.empty() || rhs.mStack.empty()) {
+		return mStack.empty() && rhs.mStack.empty();
+	}
+
+	return mStack.back() == rhs.mStack.back();
+}
+
+/**
+* Checks if 'this' iterator points at a different node than 'rhs'
+*/
+template<typename Key, typename Value>
+bool PersistentAVLTree<Key, Value>::const_iterator::operator!=(const const_iterator& rhs) const
+{
+	return !(*this == rhs);
+}
+
+/**
+* Advances the iterator using an in-order traversal. Nodes have no parent pointers,
+* so the path is kept on a stack; each node is pushed and popped once over a full
+* scan, which makes a step O(1) amortized.
+*/
+template<typename Key, typename Value>
+typename PersistentAVLTree<Key, Value>::const_iterator& PersistentAVLTree<Key, Value>::const_iterator::operator++()
+{
+	const NodeType* currNode = mStack.back();
+
+	mStack.pop_back();
+
+	// The next item is the smallest item of the right subtree, if there is one,
+	// otherwise the closest ancestor still on the stack
+	pushLeftSpine(currNode->getRight().get());
+
+	// Let go of the version once the scan is over
+	if (mStack.empty()) {
+		mRoot.reset();
+	}
+
+	return *this;
+}
+
+/**
+* Advances the iterator and returns its old location.
+*/
+template<typename Key, typename Value>
+typename PersistentAVLTree<Key, Value>::const_iterator PersistentAVLTree<Key, Value>::const_iterator::operator++(int)
+{
+	const_iterator old = *this;
+	++(*this);
+	return old;
+}
+
+/**
+* Pushes node and every node on its left spine.
+*/
+template<typename Key, typename Value>
+void PersistentAVLTree<Key, Value>::const_iterator::pushLeftSpine(const NodeType* node)
+{
+	while (node != NULL) {
+		mStack.push_back(node);
+
+		node = node->getLeft().get();
+	}
+}
+
+/*
+------------------------------------------------------------
+End implementations for the PersistentAVLTree::const_iterator class.
+------------------------------------------------------------
+*/
+
+/*
+--------------------------------------------
+Begin implementations for the PersistentAVLTree class.
+--------------------------------------------
+*/
+
+/**
+* Default constructor for a PersistentAVLTree, which starts empty.
+*/
+template<typename Key, typename Value>
+PersistentAVLTree<Key, Value>::PersistentAVLTree()
+{
+
+}
+
+/**
+* Inserts a key/value pair, replacing the value if the key already exists. Only
+* the nodes on the search path are copied.
+*/
+template<typename Key, typename Value>
+void PersistentAVLTree<Key, Value>::insert(const std::pair<Key, Value>& keyValuePair)
+{
+	mRoot = insertHelper(mRoot, keyValuePair);
+}
+
+/**
+* Removes the item with the given key, if there is one. Only the nodes on the
+* search path are copied. The key is searched for first, so removing a missing
+* key allocates nothing.
+*/
+template<typename Key, typename Value>
+void PersistentAVLTree<Key, Value>::remove(const Key& key)
+{
+	// If the key is missing the tree is unchanged
+	if (!contains(key)) {
+		return;
+	}
+
+	mRoot = removeHelper(mRoot, key);
+}
+
+/**
+* Empties this version of the tree. Nodes still used by snapshots are kept.
+*/
+template<typename Key, typename Value>
+void PersistentAVLTree<Key, Value>::clear()
+{
+	mRoot.reset();
+}
+
+/**
+* Returns a read-only version of the tree in O(1).
+*/
+template<typename Key, typename Value>
+PersistentAVLTree<Key, Value> PersistentAVLTree<Key, Value>::snapshot() const
+{
+	return *this;
+}
+
+/**
+* Returns the number of items in O(1).
+*/
+template<typename Key, typename Value>
+int PersistentAVLTree<Key, Value>::size() const
+{
+	return (mRoot != NULL) ? mRoot->getSize() : 0;
+}
+
+/**
+* Returns true if the tree has no items.
+*/
+template<typename Key, typename Value>
+bool PersistentAVLTree<Key, Value>::empty() const
+{
+	return mRoot == NULL;
+}
+
+/**
+* Returns an iterator to the smallest item.
+*/
+template<typename Key, typename Value>
+typename PersistentAVLTree<Key, Value>::const_iterator PersistentAVLTree<Key, Value>::begin() const
+{
+	const_iterator it;
+
+	it.pushLeftSpine(mRoot.get());
+
+	// Only a non-empty scan needs to keep the version alive
+	if (!it.mStack.empty()) {
+		it.mRoot = mRoot;
+	}
+
+	return it;
+}
+
+/**
+* Returns an iterator whose value means INVALID
+*/
+template<typename Key, typename Value>
+typename PersistentAVLTree<Key, Value>::const_iterator PersistentAVLTree<Key, Value>::end() const
+{
+	return const_iterator();
+}
+
+/**
+* Returns an iterator to the item with the given key, or the end iterator. The
+* nodes passed on the way down whose items come later are kept for the iterator.
+*/
+template<typename Key, typename Value>
+typename PersistentAVLTree<Key, Value>::const_iterator PersistentAVLTree<Key, Value>::find(const Key& key) const
+{
+	const_iterator it;
+	const NodeType* currNode = mRoot.get();
+
+	while (currNode != NULL) {
+		// If currNode holds key
+		if (key == currNode->getKey()) {
+			it.mStack.push_back(currNode);
+			it.mRoot = mRoot;
+
+			return it;
+		}
+
+		// If key is less than currNode, currNode comes after key
+		else if (key < currNode->getKey()) {
+			it.mStack.push_back(currNode);
+
+			currNode = currNode->getLeft().get();
+		}
+
+		// If key is greater than currNode
+		else {
+			currNode = currNode->getRight().get();
+		}
+	}
+
+	return end();
+}
+
+/**
+* Walks down with plain pointers, so a search copies no shared pointers and leaves
+* the reference counts alone.
+*/
+template<typename Key, typename Value>
+bool PersistentAVLTree<Key, Value>::contains(const Key& key) const
+{
+	const NodeType* currNode = mRoot.get();
+
+	while (currNode != NULL) {
+		// If currNode holds key
+		if (key == currNode->getKey()) {
+			return true;
+		}
+
+		// If key is less than currNode
+		else if (key < currNode->getKey()) {
+			currNode = currNode->getLeft().get();
+		}
+
+		// If key is greater than currNode
+		else {
+			currNode = currNode->getRight().get();
+		}
+	}
+
+	return false;
+}
+
+/**
+* Returns the height of a subtree, or 0 for NULL.
+*/
+template<typename Key, typename Value>
+int PersistentAVLTree<Key, Value>::getSubtreeHeight(const Ptr& node)
+{
+	return (node != NULL) ? node->getHeight() : 0;
+}
+
+/**
+* Builds a node with the given item and children. If the heights of the children
+* differ by 2, the single or double rotation is done while building, so the rotated
+* nodes are new copies as well.
+*/
+template<typename Key, typename Value>
+typename PersistentAVLTree<Key, Value>::Ptr PersistentAVLTree<Key, Value>::balance(const std::pair<Key, Value>& item, const Ptr& left, const Ptr& right)
+{
+	int leftHeight = getSubtreeHeight(left);
+	int rightHeight = getSubtreeHeight(right);
+
+	// If the left subtree is too tall
+	if (leftHeight > rightHeight + 1) {
+		// LL case: single right rotation
+		if (getSubtreeHeight(left->getLeft()) >= getSubtreeHeight(left->getRight())) {
+			Ptr newRight = std::make_shared<const NodeType>(item, left->getRight(), right);
+
+			return std::make_shared<const NodeType>(left->getItem(), left->getLeft(), newRight);
+		}
+
+		// LR case: the left child's right child becomes the root
+		const Ptr& middle = left->getRight();
+
+		Ptr newLeft = std::make_shared<const NodeType>(left->getItem(), left->getLeft(), middle->getLeft());
+		Ptr newRight = std::make_shared<const NodeType>(item, middle->getRight(), right);
+
+		return std::make_shared<const NodeType>(middle->getItem(), newLeft, newRight);
+	}
+
+	// If the right subtree is too tall
+	if (rightHeight > leftHeight + 1) {
+		// RR case: single left rotation
+		if (getSubtreeHeight(right->getRight()) >= getSubtreeHeight(right->getLeft())) {
+			Ptr newLeft = std::make_shared<const NodeType>(item, left, right->getLeft());
+
+			return std::make_shared<const NodeType>(right->getItem(), newLeft, right->getRight());
+		}
+
+		// RL case: the right child's left child becomes the root
+		const Ptr& middle = right->getLeft();
+
+		Ptr newLeft = std::make_shared<const NodeType>(item, left, middle->getLeft());
+		Ptr newRight = std::make_shared<const NodeType>(right->getItem(), middle->getRight(), right->getRight());
+
+		return std::make_shared<const NodeType>(middle->getItem(), newLeft, newRight);
+	}
+
+	// Already balanced
+	return std::make_shared<const NodeType>(item, left, right);
+}
+
+/**
+* Returns a new version of the subtree with keyValuePair inserted.
+*/
+template<typename Key, typename Value>
+typename PersistentAVLTree<Key, Value>::Ptr PersistentAVLTree<Key, Value>::insertHelper(const Ptr& node, const std::pair<Key, Value>& keyValuePair)
+{
+	// Insert as a new leaf
+	if (node == NULL) {
+		return std::make_shared<const NodeType>(keyValuePair, Ptr(), Ptr());
+	}
+
+	// If there is a duplicate entry only the value changes
+	if (keyValuePair.first == node->getKey()) {
+		return std::make_shared<const NodeType>(keyValuePair, node->getLeft(), node->getRight());
+	}
+
+	// If new node is lesser than node
+	else if (keyValuePair.first < node->getKey()) {
+		return balance(node->getItem(), insertHelper(node->getLeft(), keyValuePair), node->getRight());
+	}
+
+	// If new node is greater than node
+	else {
+		return balance(node->getItem(), node->getLeft(), insertHelper(node->getRight(), keyValuePair));
+	}
+}
+
+/**
+* Returns a new version of the subtree without key, which must be in it.
+*/
+template<typename Key, typename Value>
+typename PersistentAVLTree<Key, Value>::Ptr PersistentAVLTree<Key, Value>::removeHelper(const Ptr& node, const Key& key)
+{
+	// If key is in the left subtree
+	if (key < node->getKey()) {
+		return balance(node->getItem(), removeHelper(node->getLeft(), key), node->getRight());
+	}
+
+	// If key is in the right subtree
+	else if (node->getKey() < key) {
+		return balance(node->getItem(), node->getLeft(), removeHelper(node->getRight(), key));
+	}
+
+	// If node has at most one child, the child takes its place
+	if (node->getLeft() == NULL) {
+		return node->getRight();
+	}
+
+	if (node->getRight() == NULL) {
+		return node->getLeft();
+	}
+
+	// If node has two children its successor takes its place
+	Ptr successor;
+	Ptr newRight = removeSmallest(node->getRight(), successor);
+
+	return balance(successor->getItem(), node->getLeft(), newRight);
+}
+
+/**
+* Returns a new version of the subtree without its smallest node and stores the
+* smallest node in smallest.
+*/
+template<typename Key, typename Value>
+typename PersistentAVLTree<Key, Value>::Ptr PersistentAVLTree<Key, Value>::removeSmallest(const Ptr& node, Ptr& smallest)
+{
+	// If node is the smallest its right subtree takes its place
+	if (node->getLeft() == NULL) {
+		smallest = node;
+
+		return node->getRight();
+	}
+
+	return balance(node->getItem(), removeSmallest(node->getLeft(), smallest), node->getRight());
+}
+
+/*
+------------------------------------------
+End implementations for the PersistentAVLTree class.
+------------------------------------------
+*/
+
+#endif
@@ -0,0 +1,350 @@
+#ifndef THREADEDAVL_H
+#define THREADEDAVL_H
+
+#include "avlbst.h"
+
+/**
+* An AVLNode that also links directly to the next and previous nodes in key order,
+* so stepping an iterator is a single pointer follow instead of a climb through the
+* parents. The two threads cost two pointers per node.
+*/
+template <typename Key, typename Value>
+class ThreadedAVLNode : public AVLNode<Key, Value>
+{
+public:
+	ThreadedAVLNode(const Key& key, const Value& value, AVLNode<Key, Value>* parent);
+	ThreadedAVLNode(std::pair<Key, Value> item, AVLNode<Key, Value>* parent);
+	virtual ~ThreadedAVLNode();
+
+	// Follow the threads instead of walking the tree
+	virtual ThreadedAVLNode<Key, Value>* getSuccessor() const override;
+	virtual ThreadedAVLNode<Key, Value>* getPredecessor() const override;
+	void setSuccessor(ThreadedAVLNode<Key, Value>* next);
+	void setPredecessor(ThreadedAVLNode<Key, Value>* prev);
+
+	// The threads are left NULL for the tree to relink
+	virtual ThreadedAVLNode<Key, Value>* clone(Node<Key, Value>* parent) const override;
+	virtual std::size_t getNodeBytes() const override;
+	virtual ThreadedAVLNode<Key, Value>* relocate(void* place) override;
+
+protected:
+	ThreadedAVLNode<Key, Value>* mNext;
+	ThreadedAVLNode<Key, Value>* mPrev;
+};
+
+/*
+--------------------------------------------
+Begin implementations for the ThreadedAVLNode class.
+--------------------------------------------
+*/
+
+/**
+* Constructor for a ThreadedAVLNode. The tree links the threads once the node is
+* in place.
+*/
+template<typename Key, typename Value>
+ThreadedAVLNode<Key, Value>::ThreadedAVLNode(const Key& key, const Value& value, AVLNode<Key, Value>* parent)
+	: AVLNode<Key, Value>(key, value, parent)
+	, mNext(NULL)
+	, mPrev(NULL)
+{
+
+}
+
+/**
+* Constructor that moves the item into the node.
+*/
+template<typename Key, typename Value>
+ThreadedAVLNode<Key, Value>::ThreadedAVLNode(std::pair<Key, Value> item, AVLNode<Key, Value>* parent)
+	: AVLNode<Key, Value>(std::move(item), parent)
+	, mNext(NULL)
+	, mPrev(NULL)
+{
+
+}
+
+/**
+* Destructor.
+*/
+template<typename Key, typename Value>
+ThreadedAVLNode<Key, Value>::~ThreadedAVLNode()
+{
+
+}
+
+/**
+* Getter function for the next node in key order. Unlike the base Node, this
+* does not walk the tree.
+*/
+template<typename Key, typename Value>
+ThreadedAVLNode<Key, Value>* ThreadedAVLNode<Key, Value>::getSuccessor() const
+{
+	return mNext;
+}
+
+/**
+* Getter function for the previous node in key order. Unlike the base Node, this
+* does not walk the tree.
+*/
+template<typename Key, typename Value>
+ThreadedAVLNode<Key, Value>* ThreadedAVLNode<Key, Value>::getPredecessor() const
+{
+	return mPrev;
+}
+
+/**
+* Setter function for the next node in key order.
+*/
+template<typename Key, typename Value>
+void ThreadedAVLNode<Key, Value>::setSuccessor(ThreadedAVLNode<Key, Value>* next)
+{
+	mNext = next;
+}
+
+/**
+* Setter function for the previous node in key order.
+*/
+template<typename Key, typename Value>
+void ThreadedAVLNode<Key, Value>::setPredecessor(ThreadedAVLNode<Key, Value>* prev)
+{
+	mPrev = prev;
+}
+
+/**
+* Allocates a copy of this node with the given parent and no children or threads.
+*/
+template<typename Key, typename Value>
+ThreadedAVLNode<Key, Value>* ThreadedAVLNode<Key, Value>::clone(Node<Key, Value>* parent) const
+{
+	ThreadedAVLNode<Key, Value>* copy = new ThreadedAVLNode<Key, Value>(this->getKey(), this->getValue(), static_cast<AVLNode<Key, Value>*>(parent));
+
+	copy->setHeight(this->getHeight());
+	copy->setSize(this->getSize());
+
+	return copy;
+}
+
+/**
+* Returns the number of bytes a ThreadedAVLNode takes.
+*/
+template<typename Key, typename Value>
+std::size_t ThreadedAVLNode<Key, Value>::getNodeBytes() const
+{
+	return sizeof(ThreadedAVLNode<Key, Value>);
+}
+
+/**
+* Moves this node to place with no links or threads.
+*/
+template<typename Key, typename Value>
+ThreadedAVLNode<Key, Value>* ThreadedAVLNode<Key, Value>::relocate(void* place)
+{
+	ThreadedAVLNode<Key, Value>* copy = new (place) ThreadedAVLNode<Key, Value>(std::move_if_noexcept(this->getItem()), NULL);
+
+	copy->setHeight(this->getHeight());
+	copy->setSize(this->getSize());
+
+	return copy;
+}
+
+/*
+------------------------------------------
+End implementations for the ThreadedAVLNode class.
+------------------------------------------
+*/
+
+/**
+* An AVL tree whose nodes are threaded in key order, for scan heavy use. Iterator
+* steps, hinted inserts and finger searches find a node's neighbours in O(1)
+* instead of walking the tree. The threads are spliced in on insert, spliced out on
+* every kind of remove and relinked after copies, merges and compaction; rotations,
+* split and join keep key order, so they need no changes.
+*/
+template <class Key, class Value>
+class ThreadedAVLTree : public AVLTree<Key, Value>
+{
+public:
+	ThreadedAVLTree();
+
+	// The base copy constructor runs before this tree can link threads, so the
+	// copy links them itself
+	ThreadedAVLTree(const ThreadedAVLTree<Key, Value>& other);
+	ThreadedAVLTree(ThreadedAVLTree<Key, Value>&& other) noexcept;
+	ThreadedAVLTree<Key, Value>& operator=(const ThreadedAVLTree<Key, Value>& other);
+	ThreadedAVLTree<Key, Value>& operator=(ThreadedAVLTree<Key, Value>&& other) noexcept;
+
+protected:
+	typedef ThreadedAVLNode<Key, Value> NodeType;
+
+	virtual NodeType* createNode(const Key& key, const Value& value, Node<Key, Value>* parent) override;
+
+	virtual void linkThreads(AVLNode<Key, Value>* newNode) override;
+	virtual void unlinkThreads(AVLNode<Key, Value>* first, AVLNode<Key, Value>* last) override;
+	virtual void rebuildThreads() override;
+};
+
+/*
+--------------------------------------------
+Begin implementations for the ThreadedAVLTree class.
+--------------------------------------------
+*/
+
+/**
+* Default constructor for an empty tree.
+*/
+template<typename Key, typename Value>
+ThreadedAVLTree<Key, Value>::ThreadedAVLTree()
+{
+
+}
+
+/**
+* Copy constructor. The nodes are cloned by BinarySearchTree, only the threads
+* need to be linked again.
+*/
+template<typename Key, typename Value>
+ThreadedAVLTree<Key, Value>::ThreadedAVLTree(const ThreadedAVLTree<Key, Value>& other)
+	: AVLTree<Key, Value>(other)
+{
+	rebuildThreads();
+}
+
+/**
+* Move constructor. The threads move along with the nodes.
+*/
+template<typename Key, typename Value>
+ThreadedAVLTree<Key, Value>::ThreadedAVLTree(ThreadedAVLTree<Key, Value>&& other) noexcept
+	: AVLTree<Key, Value>(std::move(other))
+{
+
+}
+
+/**
+* Copy assignment. AVLTree relinks the threads through rebuildThreads().
+*/
+template<typename Key, typename Value>
+ThreadedAVLTree<Key, Value>& ThreadedAVLTree<Key, Value>::operator=(const ThreadedAVLTree<Key, Value>& other)
+{
+	AVLTree<Key, Value>::operator=(other);
+
+	return *this;
+}
+
+/**
+* Move assignment.
+*/
+template<typename Key, typename Value>
+ThreadedAVLTree<Key, Value>& ThreadedAVLTree<Key, Value>::operator=(ThreadedAVLTree<Key, Value>&& other) noexcept
+{
+	AVLTree<Key, Value>::operator=(std::move(other));
+
+	return *this;
+}
+
+/**
+* Allocates a node that carries threads.
+*/
+template<typename Key, typename Value>
+typename ThreadedAVLTree<Key, Value>::NodeType* ThreadedAVLTree<Key, Value>::createNode(const Key& key, const Value& value, Node<Key, Value>* parent) {
+	return new NodeType(key, value, static_cast<AVLNode<Key, Value>*>(parent));
+}
+
+/**
+* Splices a newly inserted leaf into the in-order threads. A left child comes right
+* before its parent and a right child comes right after it.
+*/
+template<typename Key, typename Value>
+void ThreadedAVLTree<Key, Value>::linkThreads(AVLNode<Key, Value>* newAVLNode) {
+	NodeType* newNode = static_cast<NodeType*>(newAVLNode);
+	NodeType* parent = static_cast<NodeType*>(newNode->getParent());
+
+	// The first node has no neighbours
+	if (parent == NULL) {
+		return;
+	}
+
+	NodeType* prev;
+	NodeType* next;
+
+	// If newNode is a left child it goes between parent's predecessor and parent
+	if (parent->getLeft() == newNode) {
+		prev = parent->getPredecessor();
+		next = parent;
+	}
+
+	// If newNode is a right child it goes between parent and parent's successor
+	else {
+		prev = parent;
+		next = parent->getSuccessor();
+	}
+
+	newNode->setPredecessor(prev);
+	newNode->setSuccessor(next);
+
+	if (prev != NULL) {
+		prev->setSuccessor(newNode);
+	}
+
+	if (next != NULL) {
+		next->setPredecessor(newNode);
+	}
+}
+
+/**
+* Splices the nodes from first to last out of the in-order threads by linking
+* the nodes on either side of them to each other.
+*/
+template<typename Key, typename Value>
+void ThreadedAVLTree<Key, Value>::unlinkThreads(AVLNode<Key, Value>* firstAVLNode, AVLNode<Key, Value>* lastAVLNode) {
+	NodeType* prev = static_cast<NodeType*>(firstAVLNode)->getPredecessor();
+	NodeType* next = static_cast<NodeType*>(lastAVLNode)->getSuccessor();
+
+	if (prev != NULL) {
+		prev->setSuccessor(next);
+	}
+
+	if (next != NULL) {
+		next->setPredecessor(prev);
+	}
+
+	static_cast<NodeType*>(firstAVLNode)->setPredecessor(NULL);
+	static_cast<NodeType*>(lastAVLNode)->setSuccessor(NULL);
+}
+
+/**
+* Links every node to its neighbours in key order. The neighbours are found by
+* walking the tree through the parent pointers, which is O(n) for a full pass.
+*/
+template<typename Key, typename Value>
+void ThreadedAVLTree<Key, Value>::rebuildThreads() {
+	NodeType* prevNode = NULL;
+	Node<Key, Value>* currNode = BinarySearchTree<Key, Value>::getSmallestNode();
+
+	while (currNode != NULL) {
+		NodeType* currThreadedNode = static_cast<NodeType*>(currNode);
+
+		currThreadedNode->setPredecessor(prevNode);
+
+		if (prevNode != NULL) {
+			prevNode->setSuccessor(currThreadedNode);
+		}
+
+		prevNode = currThreadedNode;
+
+		// The threads are not set up yet, so use the tree walk from Node
+		currNode = currNode->Node<Key, Value>::getSuccessor();
+	}
+
+	// The largest node has no successor
+	if (prevNode != NULL) {
+		prevNode->setSuccessor(NULL);
+	}
+}
+
+/*
+------------------------------------------
+End implementations for the ThreadedAVLTree class.
+------------------------------------------
+*/
+
+#endif
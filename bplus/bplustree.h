@@ -0,0 +1,1092 @@
+#ifndef BPLUSTREE_H
+#define BPLUSTREE_H
+
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include "nodesearch.h"
+
+/**
+* A templated map implemented as a B+ tree, with the same interface as AVLTree for
+* inserting, removing, finding and iterating. Every item lives in a leaf, and the
+* leaves are linked in order so iteration never climbs the tree. Each node holds
+* its keys in one sorted array sized to a few cache lines, so a lookup touches about
+* log_B(n) nodes instead of the log2(n) scattered nodes of a binary tree, and the
+* keys of a node are searched with SIMD compares for int and long long keys (see
+* nodesearch.h). Key and Value must be default constructible.
+*
+* Unlike BinarySearchTree, the items are not stored as pairs, so iterators dereference
+* to a std::pair of references to the key and value.
+*/
+template <class Key, class Value>
+class BPlusTree
+{
+public:
+	// Keys per node: 128 bytes of keys (two cache lines), but at least 8, and even
+	// so that a full node splits into two halves that are both at least half full.
+	static const int Slots = (128 / sizeof(Key) < 8) ? 8 : static_cast<int>(128 / sizeof(Key)) & ~1;
+
+	BPlusTree();
+	~BPlusTree();
+
+	// Copies keep the exact shape of the original and do no comparisons. Moves take
+	// over the nodes in O(1) and leave the source empty.
+	BPlusTree(const BPlusTree<Key, Value>& other);
+	BPlusTree(BPlusTree<Key, Value>&& other) noexcept;
+	BPlusTree<Key, Value>& operator=(const BPlusTree<Key, Value>& other);
+	BPlusTree<Key, Value>& operator=(BPlusTree<Key, Value>&& other) noexcept;
+
+	// Methods for inserting/removing elements from the tree. A duplicate key updates
+	// the value, and removing a missing key does nothing.
+	void insert(const std::pair<Key, Value>& keyValuePair);
+	void remove(const Key& key);
+	void clear();
+	void print() const;
+
+	// Returns the number of items in O(1)
+	int size() const;
+	bool empty() const;
+
+private:
+	struct InnerNode;
+	struct LeafNode;
+
+	// The part shared by both kinds of node. Each array has one spare slot so that
+	// an item can be added to a full node before it is split.
+	struct BaseNode
+	{
+		bool mIsLeaf;
+		int mCount;
+		Key mKeys[Slots + 1];
+	};
+
+	// Every key in mChildren[i] is <= mKeys[i], and every key in mChildren[i + 1]
+	// is > mKeys[i]. An inner node with mCount keys has mCount + 1 children.
+	struct InnerNode : public BaseNode
+	{
+		BaseNode* mChildren[Slots + 2];
+	};
+
+	// mValues[i] belongs to mKeys[i]. Leaves are linked in key order.
+	struct LeafNode : public BaseNode
+	{
+		Value mValues[Slots + 1];
+		LeafNode* mNext;
+		LeafNode* mPrev;
+	};
+
+public:
+	/**
+	* An iterator over the items in key order. ValueType is Value for iterator and
+	* const Value for const_iterator. It walks the linked leaves, so ++ and -- are
+	* O(1). An iterator converts to a const_iterator.
+	*/
+	template <typename ValueType>
+	class basic_iterator
+	{
+	public:
+		typedef std::bidirectional_iterator_tag iterator_category;
+		typedef std::pair<Key, Value> value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef std::pair<const Key&, ValueType&> reference;
+
+		// Holds the pair of references so that -> has something to point at
+		class pointer
+		{
+		public:
+			pointer(const reference& item);
+			const reference* operator->() const;
+
+		private:
+			reference mItem;
+		};
+
+		basic_iterator();
+		basic_iterator(LeafNode* leaf, int index, const BPlusTree<Key, Value>* tree);
+		basic_iterator(const basic_iterator<Value>& other);
+
+		reference operator*() const;
+		pointer operator->() const;
+
+		bool operator==(const basic_iterator& rhs) const;
+		bool operator!=(const basic_iterator& rhs) const;
+
+		basic_iterator& operator++();
+		basic_iterator operator++(int);
+		basic_iterator& operator--();
+		basic_iterator operator--(int);
+
+	protected:
+		// The leaf and slot of the item, or NULL for end()
+		LeafNode* mLeaf;
+		int mIndex;
+		const BPlusTree<Key, Value>* mTree;
+
+		template <typename OtherValueType> friend class basic_iterator;
+	};
+
+	typedef basic_iterator<Value> iterator;
+	typedef basic_iterator<const Value> const_iterator;
+
+	iterator begin();
+	iterator end();
+	const_iterator begin() const;
+	const_iterator end() const;
+
+	iterator find(const Key& key);
+	const_iterator find(const Key& key) const;
+
+	// First item with key >= key, or end() if there is none
+	iterator lower_bound(const Key& key);
+	const_iterator lower_bound(const Key& key) const;
+
+private:
+	// Walks from the root to the leaf whose key range holds key
+	LeafNode* findLeaf(const Key& key) const;
+
+	// Inserts into the subtree at node. If node splits, returns the new right
+	// node and sets separator to the largest key left in node; otherwise returns
+	// NULL.
+	BaseNode* insertInto(BaseNode* node, const Key& key, const Value& value, Key& separator);
+
+	// Split a node holding Slots + 1 keys in two and return the new right node
+	LeafNode* splitLeaf(LeafNode* leaf, Key& separator);
+	InnerNode* splitInner(InnerNode* node, Key& separator);
+
+	// Removes key from the subtree at node. Returns false if key was not found.
+	bool removeFrom(BaseNode* node, const Key& key);
+
+	// Refills parent's child at index, which is one below half full, by borrowing
+	// an item from a sibling or merging with one
+	void fixChild(InnerNode* parent, int index);
+
+	// Frees every node in a subtree
+	static void deleteSubtree(BaseNode* node);
+
+	// Copies a subtree node by node, linking each copied leaf after prevLeaf
+	static BaseNode* cloneSubtree(const BaseNode* node, LeafNode*& prevLeaf);
+
+	void printRoot(const BaseNode* node, int depth) const;
+
+	BaseNode* mRoot;
+	LeafNode* mFirst;
+	LeafNode* mLast;
+	int mSize;
+};
+
+template<typename Key, typename Value>
+const int BPlusTree<Key, Value>::Slots;
+
+/*
+	---------------------------------------------------------------
+	Begin implementations for the BPlusTree::basic_iterator class.
+	---------------------------------------------------------------
+*/
+
+/**
+* Stores the pair of references returned by operator*.
+*/
+template<typename Key, typename Value>
+template<typename ValueType>
+BPlusTree<Key, Value>::basic_iterator<ValueType>::pointer::pointer(const reference& item)
+	: mItem(item)
+{
+
+}
+
+/**
+* Provides access to the stored pair.
+*/
+template<typename Key, typename Value>
+template<typename ValueType>
+const typename BPlusTree<Key, Value>::template basic_iterator<ValueType>::reference*
+BPlusTree<Key, Value>::basic_iterator<ValueType>::pointer::operator->() const
+{
+	return &mItem;
+}
+
+/**
+* A default constructor that initializes the iterator to end().
+*/
+template<typename Key, typename Value>
+template<typename ValueType>
+BPlusTree<Key, Value>::basic_iterator<ValueType>::basic_iterator()
+	: mLeaf(NULL)
+	, mIndex(0)
+	, mTree(NULL)
+{
+
+}
+
+/**
+* Constructor that points the iterator at slot index of a leaf in tree.
+*/
+template<typename Key, typename Value>
+template<typename ValueType>
+BPlusTree<Key, Value>::basic_iterator<ValueType>::basic_iterator(LeafNode* leaf, int index, const BPlusTree<Key, Value>* tree)
+	: mLeaf(leaf)
+	, mIndex(index)
+	, mTree(tree)
+{
+
+}
+
+/**
+* Converts an iterator to a const_iterator, and copies an iterator.
+*/
+template<typename Key, typename Value>
+template<typename ValueType>
+BPlusTree<Key, Value>::basic_iterator<ValueType>::basic_iterator(const basic_iterator<Value>& other)
+	: mLeaf(other.mLeaf)
+	, mIndex(other.mIndex)
+	, mTree(other.mTree)
+{
+
+}
+
+/**
+* Provides access to the key and value.
+*/
+template<typename Key, typename Value>
+template<typename ValueType>
+typename BPlusTree<Key, Value>::template basic_iterator<ValueType>::reference
+BPlusTree<Key, Value>::basic_iterator<ValueType>::operator*() const
+{
+	return reference(mLeaf->mKeys[mIndex], mLeaf->mValues[mIndex]);
+}
+
+/**
+* Provides access to the key and value through ->first and ->second.
+*/
+template<typename Key, typename Value>
+template<typename ValueType>
+typename BPlusTree<Key, Value>::template basic_iterator<ValueType>::pointer
+BPlusTree<Key, Value>::basic_iterator<ValueType>::operator->() const
+{
+	return pointer(**this);
+}
+
+/**
+* Checks if 'this' iterator points at the same item as 'rhs'.
+*/
+template<typename Key, typename Value>
+template<typename ValueType>
+bool BPlusTree<Key, Value>::basic_iterator<ValueType>::operator==(const basic_iterator& rhs) const
+{
+	return mLeaf == rhs.mLeaf && mIndex == rhs.mIndex;
+}
+
+/**
+* Checks if 'this' iterator points at a different item than 'rhs'.
+*/
+template<typename Key, typename Value>
+template<typename ValueType>
+bool BPlusTree<Key, Value>::basic_iterator<ValueType>::operator!=(const basic_iterator& rhs) const
+{
+	return !(*this == rhs);
+}
+
+/**
+* Advances the iterator to the next item, moving to the next leaf after the last
+* slot of a leaf.
+*/
+template<typename Key, typename Value>
+template<typename ValueType>
+typename BPlusTree<Key, Value>::template basic_iterator<ValueType>&
+BPlusTree<Key, Value>::basic_iterator<ValueType>::operator++()
+{
+	++mIndex;
+
+	// Past the last slot of this leaf
+	if (mIndex == mLeaf->mCount) {
+		mLeaf = mLeaf->mNext;
+		mIndex = 0;
+	}
+
+	return *this;
+}
+
+/**
+* Post-increment.
+*/
+template<typename Key, typename Value>
+template<typename ValueType>
+typename BPlusTree<Key, Value>::template basic_iterator<ValueType>
+BPlusTree<Key, Value>::basic_iterator<ValueType>::operator++(int)
+{
+	basic_iterator copy(*this);
+	++(*this);
+	return copy;
+}
+
+/**
+* Moves the iterator to the previous item. Decrementing end() moves to the last item.
+*/
+template<typename Key, typename Value>
+template<typename ValueType>
+typename BPlusTree<Key, Value>::template basic_iterator<ValueType>&
+BPlusTree<Key, Value>::basic_iterator<ValueType>::operator--()
+{
+	// end() goes to the last slot of the last leaf
+	if (mLeaf == NULL) {
+		mLeaf = mTree->mLast;
+		mIndex = mLeaf->mCount - 1;
+	}
+
+	// Before the first slot of this leaf
+	else if (mIndex == 0) {
+		mLeaf = mLeaf->mPrev;
+		mIndex = mLeaf->mCount - 1;
+	}
+
+	else {
+		--mIndex;
+	}
+
+	return *this;
+}
+
+/**
+* Post-decrement.
+*/
+template<typename Key, typename Value>
+template<typename ValueType>
+typename BPlusTree<Key, Value>::template basic_iterator<ValueType>
+BPlusTree<Key, Value>::basic_iterator<ValueType>::operator--(int)
+{
+	basic_iterator copy(*this);
+	--(*this);
+	return copy;
+}
+
+/*
+	-------------------------------------------------------------
+	End implementations for the BPlusTree::basic_iterator class.
+	-------------------------------------------------------------
+*/
+
+/*
+--------------------------------------------
+Begin implementations for the BPlusTree class.
+--------------------------------------------
+*/
+
+/**
+* Default constructor for a BPlusTree, which sets the root to NULL.
+*/
+template<typename Key, typename Value>
+BPlusTree<Key, Value>::BPlusTree()
+	: mRoot(NULL)
+	, mFirst(NULL)
+	, mLast(NULL)
+	, mSize(0)
+{
+
+}
+
+template<typename Key, typename Value>
+BPlusTree<Key, Value>::~BPlusTree()
+{
+	clear();
+}
+
+/**
+* Copy constructor. Clones other's nodes in O(n).
+*/
+template<typename Key, typename Value>
+BPlusTree<Key, Value>::BPlusTree(const BPlusTree<Key, Value>& other)
+	: mRoot(NULL)
+	, mFirst(NULL)
+	, mLast(NULL)
+	, mSize(0)
+{
+	*this = other;
+}
+
+/**
+* Move constructor. Takes over other's nodes and leaves other empty.
+*/
+template<typename Key, typename Value>
+BPlusTree<Key, Value>::BPlusTree(BPlusTree<Key, Value>&& other) noexcept
+	: mRoot(other.mRoot)
+	, mFirst(other.mFirst)
+	, mLast(other.mLast)
+	, mSize(other.mSize)
+{
+	other.mRoot = NULL;
+	other.mFirst = NULL;
+	other.mLast = NULL;
+	other.mSize = 0;
+}
+
+/**
+* Copy assignment. Frees this tree's nodes and clones other's.
+*/
+template<typename Key, typename Value>
+BPlusTree<Key, Value>& BPlusTree<Key, Value>::operator=(const BPlusTree<Key, Value>& other)
+{
+	// Self assignment
+	if (this == &other) {
+		return *this;
+	}
+
+	clear();
+
+	LeafNode* prevLeaf = NULL;
+
+	if (other.mRoot != NULL) {
+		mRoot = cloneSubtree(other.mRoot, prevLeaf);
+	}
+
+	// The last leaf copied is the largest, and the first is found by walking back
+	mLast = prevLeaf;
+	mFirst = prevLeaf;
+
+	while (mFirst != NULL && mFirst->mPrev != NULL) {
+		mFirst = mFirst->mPrev;
+	}
+
+	mSize = other.mSize;
+
+	return *this;
+}
+
+/**
+* Move assignment. Frees this tree's nodes, takes over other's and leaves other empty.
+*/
+template<typename Key, typename Value>
+BPlusTree<Key, Value>& BPlusTree<Key, Value>::operator=(BPlusTree<Key, Value>&& other) noexcept
+{
+	// Self assignment
+	if (this == &other) {
+		return *this;
+	}
+
+	clear();
+
+	mRoot = other.mRoot;
+	mFirst = other.mFirst;
+	mLast = other.mLast;
+	mSize = other.mSize;
+
+	other.mRoot = NULL;
+	other.mFirst = NULL;
+	other.mLast = NULL;
+	other.mSize = 0;
+
+	return *this;
+}
+
+/**
+* Copies the subtree at node, visiting children left to right so that copied leaves
+* are met in key order and can be linked as they are made.
+*/
+template<typename Key, typename Value>
+typename BPlusTree<Key, Value>::BaseNode* BPlusTree<Key, Value>::cloneSubtree(const BaseNode* node, LeafNode*& prevLeaf)
+{
+	// Copy a leaf and link it after the previous one
+	if (node->mIsLeaf) {
+		LeafNode* copy = new LeafNode(*static_cast<const LeafNode*>(node));
+
+		copy->mPrev = prevLeaf;
+		copy->mNext = NULL;
+
+		if (prevLeaf != NULL) {
+			prevLeaf->mNext = copy;
+		}
+
+		prevLeaf = copy;
+		return copy;
+	}
+
+	const InnerNode* inner = static_cast<const InnerNode*>(node);
+	InnerNode* copy = new InnerNode(*inner);
+
+	// Replace the copied child pointers with copies of the children
+	for (int i = 0; i <= inner->mCount; ++i) {
+		copy->mChildren[i] = cloneSubtree(inner->mChildren[i], prevLeaf);
+	}
+
+	return copy;
+}
+
+/**
+* Returns the number of items in O(1).
+*/
+template<typename Key, typename Value>
+int BPlusTree<Key, Value>::size() const
+{
+	return mSize;
+}
+
+/**
+* Returns true if the tree holds no items.
+*/
+template<typename Key, typename Value>
+bool BPlusTree<Key, Value>::empty() const
+{
+	return mSize == 0;
+}
+
+/**
+* Deletes all nodes inside the tree, resetting it to the empty tree.
+*/
+template<typename Key, typename Value>
+void BPlusTree<Key, Value>::clear()
+{
+	if (mRoot != NULL) {
+		deleteSubtree(mRoot);
+	}
+
+	mRoot = NULL;
+	mFirst = NULL;
+	mLast = NULL;
+	mSize = 0;
+}
+
+/**
+* Frees the subtree at node, children first.
+*/
+template<typename Key, typename Value>
+void BPlusTree<Key, Value>::deleteSubtree(BaseNode* node)
+{
+	if (node->mIsLeaf) {
+		delete static_cast<LeafNode*>(node);
+		return;
+	}
+
+	InnerNode* inner = static_cast<InnerNode*>(node);
+
+	for (int i = 0; i <= inner->mCount; ++i) {
+		deleteSubtree(inner->mChildren[i]);
+	}
+
+	delete inner;
+}
+
+template<typename Key, typename Value>
+void BPlusTree<Key, Value>::print() const
+{
+	if (mRoot != NULL) {
+		printRoot(mRoot, 0);
+	}
+
+	std::cout << "\n";
+}
+
+/**
+* Prints one node per line, indented by depth, children under their parent.
+*/
+template<typename Key, typename Value>
+void BPlusTree<Key, Value>::printRoot(const BaseNode* node, int depth) const
+{
+	std::cout << std::string(2 * depth, ' ') << "[";
+
+	for (int i = 0; i < node->mCount; ++i) {
+		std::cout << (i == 0 ? "" : " ") << node->mKeys[i];
+	}
+
+	std::cout << "]\n";
+
+	if (!node->mIsLeaf) {
+		const InnerNode* inner = static_cast<const InnerNode*>(node);
+
+		for (int i = 0; i <= inner->mCount; ++i) {
+			printRoot(inner->mChildren[i], depth + 1);
+		}
+	}
+}
+
+/**
+* Returns an iterator to the smallest item.
+*/
+template<typename Key, typename Value>
+typename BPlusTree<Key, Value>::iterator BPlusTree<Key, Value>::begin()
+{
+	return iterator(mFirst, 0, this);
+}
+
+/**
+* Returns an iterator past the largest item.
+*/
+template<typename Key, typename Value>
+typename BPlusTree<Key, Value>::iterator BPlusTree<Key, Value>::end()
+{
+	return iterator(NULL, 0, this);
+}
+
+/**
+* Returns a const_iterator to the smallest item.
+*/
+template<typename Key, typename Value>
+typename BPlusTree<Key, Value>::const_iterator BPlusTree<Key, Value>::begin() const
+{
+	return const_iterator(mFirst, 0, this);
+}
+
+/**
+* Returns a const_iterator past the largest item.
+*/
+template<typename Key, typename Value>
+typename BPlusTree<Key, Value>::const_iterator BPlusTree<Key, Value>::end() const
+{
+	return const_iterator(NULL, 0, this);
+}
+
+/**
+* Walks from the root to the leaf that would hold key, searching each inner node's
+* keys for the first separator >= key. Returns NULL for an empty tree.
+*/
+template<typename Key, typename Value>
+typename BPlusTree<Key, Value>::LeafNode* BPlusTree<Key, Value>::findLeaf(const Key& key) const
+{
+	BaseNode* currNode = mRoot;
+
+	// Empty tree
+	if (currNode == NULL) {
+		return NULL;
+	}
+
+	while (!currNode->mIsLeaf) {
+		InnerNode* inner = static_cast<InnerNode*>(currNode);
+		currNode = inner->mChildren[nodeLowerBound(inner->mKeys, inner->mCount, key)];
+	}
+
+	return static_cast<LeafNode*>(currNode);
+}
+
+/**
+* Returns an iterator to the item with the given key, or end() if it is not in
+* the tree.
+*/
+template<typename Key, typename Value>
+typename BPlusTree<Key, Value>::iterator BPlusTree<Key, Value>::find(const Key& key)
+{
+	LeafNode* leaf = findLeaf(key);
+
+	// Empty tree
+	if (leaf == NULL) {
+		return end();
+	}
+
+	int index = nodeLowerBound(leaf->mKeys, leaf->mCount, key);
+
+	// The first key >= key is key itself
+	if (index < leaf->mCount && !(key < leaf->mKeys[index])) {
+		return iterator(leaf, index, this);
+	}
+
+	return end();
+}
+
+/**
+* Const version of find.
+*/
+template<typename Key, typename Value>
+typename BPlusTree<Key, Value>::const_iterator BPlusTree<Key, Value>::find(const Key& key) const
+{
+	return const_cast<BPlusTree<Key, Value>*>(this)->find(key);
+}
+
+/**
+* Returns an iterator to the first item with a key >= key. Separators can be larger
+* than every key left in their child, so the item may be the first of the next leaf.
+*/
+template<typename Key, typename Value>
+typename BPlusTree<Key, Value>::iterator BPlusTree<Key, Value>::lower_bound(const Key& key)
+{
+	LeafNode* leaf = findLeaf(key);
+
+	// Empty tree
+	if (leaf == NULL) {
+		return end();
+	}
+
+	int index = nodeLowerBound(leaf->mKeys, leaf->mCount, key);
+
+	// Every key in this leaf is smaller
+	if (index == leaf->mCount) {
+		return iterator(leaf->mNext, 0, this);
+	}
+
+	return iterator(leaf, index, this);
+}
+
+/**
+* Const version of lower_bound.
+*/
+template<typename Key, typename Value>
+typename BPlusTree<Key, Value>::const_iterator BPlusTree<Key, Value>::lower_bound(const Key& key) const
+{
+	return const_cast<BPlusTree<Key, Value>*>(this)->lower_bound(key);
+}
+
+/**
+* Inserts a key value pair. If the root splits, a new root is made above the two
+* halves, so the tree only grows at the top and every leaf stays at the same depth.
+*/
+template<typename Key, typename Value>
+void BPlusTree<Key, Value>::insert(const std::pair<Key, Value>& keyValuePair)
+{
+	// If the tree is empty the item goes in a new leaf at the root
+	if (mRoot == NULL) {
+		LeafNode* leaf = new LeafNode();
+		leaf->mIsLeaf = true;
+		leaf->mCount = 1;
+		leaf->mKeys[0] = keyValuePair.first;
+		leaf->mValues[0] = keyValuePair.second;
+		leaf->mNext = NULL;
+		leaf->mPrev = NULL;
+
+		mRoot = leaf;
+		mFirst = leaf;
+		mLast = leaf;
+		mSize = 1;
+		return;
+	}
+
+	Key separator;
+	BaseNode* right = insertInto(mRoot, keyValuePair.first, keyValuePair.second, separator);
+
+	// The root split, so grow the tree by one level
+	if (right != NULL) {
+		InnerNode* newRoot = new InnerNode();
+		newRoot->mIsLeaf = false;
+		newRoot->mCount = 1;
+		newRoot->mKeys[0] = separator;
+		newRoot->mChildren[0] = mRoot;
+		newRoot->mChildren[1] = right;
+
+		mRoot = newRoot;
+	}
+}
+
+/**
+* Inserts into the subtree at node. A leaf takes the item in sorted position, or
+* updates the value of a duplicate key. An inner node passes the item to the child
+* whose range holds the key, and adds a separator and child if that child split.
+* Either kind of node is split once it holds Slots + 1 keys.
+*/
+template<typename Key, typename Value>
+typename BPlusTree<Key, Value>::BaseNode* BPlusTree<Key, Value>::insertInto(BaseNode* node, const Key& key, const Value& value, Key& separator)
+{
+	int index = nodeLowerBound(node->mKeys, node->mCount, key);
+
+	if (node->mIsLeaf) {
+		LeafNode* leaf = static_cast<LeafNode*>(node);
+
+		// If there is a duplicate entry update its value
+		if (index < leaf->mCount && !(key < leaf->mKeys[index])) {
+			leaf->mValues[index] = value;
+			return NULL;
+		}
+
+		// Open a slot at index
+		std::move_backward(leaf->mKeys + index, leaf->mKeys + leaf->mCount, leaf->mKeys + leaf->mCount + 1);
+		std::move_backward(leaf->mValues + index, leaf->mValues + leaf->mCount, leaf->mValues + leaf->mCount + 1);
+
+		leaf->mKeys[index] = key;
+		leaf->mValues[index] = value;
+		++leaf->mCount;
+		++mSize;
+
+		// Leaf overflowed
+		if (leaf->mCount > Slots) {
+			return splitLeaf(leaf, separator);
+		}
+
+		return NULL;
+	}
+
+	InnerNode* inner = static_cast<InnerNode*>(node);
+
+	Key childSeparator;
+	BaseNode* right = insertInto(inner->mChildren[index], key, value, childSeparator);
+
+	// The child did not split
+	if (right == NULL) {
+		return NULL;
+	}
+
+	// The child's separator goes at index and its new right half just after it
+	std::move_backward(inner->mKeys + index, inner->mKeys + inner->mCount, inner->mKeys + inner->mCount + 1);
+	std::move_backward(inner->mChildren + index + 1, inner->mChildren + inner->mCount + 1, inner->mChildren + inner->mCount + 2);
+
+	inner->mKeys[index] = childSeparator;
+	inner->mChildren[index + 1] = right;
+	++inner->mCount;
+
+	// Inner node overflowed
+	if (inner->mCount > Slots) {
+		return splitInner(inner, separator);
+	}
+
+	return NULL;
+}
+
+/**
+* Moves the upper half of a full leaf into a new leaf linked after it. The separator
+* is the largest key left in the lower half.
+*/
+template<typename Key, typename Value>
+typename BPlusTree<Key, Value>::LeafNode* BPlusTree<Key, Value>::splitLeaf(LeafNode* leaf, Key& separator)
+{
+	int half = Slots / 2;
+
+	LeafNode* right = new LeafNode();
+	right->mIsLeaf = true;
+	right->mCount = leaf->mCount - half;
+
+	std::move(leaf->mKeys + half, leaf->mKeys + leaf->mCount, right->mKeys);
+	std::move(leaf->mValues + half, leaf->mValues + leaf->mCount, right->mValues);
+	leaf->mCount = half;
+
+	// Link the new leaf after leaf
+	right->mPrev = leaf;
+	right->mNext = leaf->mNext;
+
+	if (leaf->mNext != NULL) {
+		leaf->mNext->mPrev = right;
+	}
+
+	else {
+		mLast = right;
+	}
+
+	leaf->mNext = right;
+
+	separator = leaf->mKeys[half - 1];
+	return right;
+}
+
+/**
+* Splits a full inner node around its middle key, which moves up to the parent as
+* the separator. The keys and children after it go to a new node.
+*/
+template<typename Key, typename Value>
+typename BPlusTree<Key, Value>::InnerNode* BPlusTree<Key, Value>::splitInner(InnerNode* node, Key& separator)
+{
+	int half = Slots / 2;
+
+	InnerNode* right = new InnerNode();
+	right->mIsLeaf = false;
+	right->mCount = node->mCount - half - 1;
+
+	std::move(node->mKeys + half + 1, node->mKeys + node->mCount, right->mKeys);
+	std::copy(node->mChildren + half + 1, node->mChildren + node->mCount + 1, right->mChildren);
+
+	separator = node->mKeys[half];
+	node->mCount = half;
+
+	return right;
+}
+
+/**
+* Removes the item with the given key. Does nothing if the key is not in the tree.
+* If the root is left with no keys, the level below it becomes the root.
+*/
+template<typename Key, typename Value>
+void BPlusTree<Key, Value>::remove(const Key& key)
+{
+	// If the key does not exist do nothing
+	if (mRoot == NULL || !removeFrom(mRoot, key)) {
+		return;
+	}
+
+	// The root is an empty leaf, so the tree is empty
+	if (mRoot->mIsLeaf && mRoot->mCount == 0) {
+		delete static_cast<LeafNode*>(mRoot);
+
+		mRoot = NULL;
+		mFirst = NULL;
+		mLast = NULL;
+	}
+
+	// The root has a single child, so shrink the tree by one level
+	else if (!mRoot->mIsLeaf && mRoot->mCount == 0) {
+		InnerNode* oldRoot = static_cast<InnerNode*>(mRoot);
+
+		mRoot = oldRoot->mChildren[0];
+		delete oldRoot;
+	}
+}
+
+/**
+* Removes key from the subtree at node. Separators are left alone when a key is
+* removed, since a stale separator still bounds its child. After removing from a
+* child, the child is refilled if it fell below half full.
+*/
+template<typename Key, typename Value>
+bool BPlusTree<Key, Value>::removeFrom(BaseNode* node, const Key& key)
+{
+	int index = nodeLowerBound(node->mKeys, node->mCount, key);
+
+	if (node->mIsLeaf) {
+		LeafNode* leaf = static_cast<LeafNode*>(node);
+
+		// Key is not in the tree
+		if (index == leaf->mCount || key < leaf->mKeys[index]) {
+			return false;
+		}
+
+		// Close the slot at index
+		std::move(leaf->mKeys + index + 1, leaf->mKeys + leaf->mCount, leaf->mKeys + index);
+		std::move(leaf->mValues + index + 1, leaf->mValues + leaf->mCount, leaf->mValues + index);
+
+		--leaf->mCount;
+		--mSize;
+		return true;
+	}
+
+	InnerNode* inner = static_cast<InnerNode*>(node);
+
+	if (!removeFrom(inner->mChildren[index], key)) {
+		return false;
+	}
+
+	// The child is below half full
+	if (inner->mChildren[index]->mCount < Slots / 2) {
+		fixChild(inner, index);
+	}
+
+	return true;
+}
+
+/**
+* Refills the child at index. It borrows one item from the left sibling if that
+* sibling is more than half full, otherwise from the right sibling. If neither can
+* spare one, the child is merged with a sibling, which removes a separator and a
+* child from parent.
+*/
+template<typename Key, typename Value>
+void BPlusTree<Key, Value>::fixChild(InnerNode* parent, int index)
+{
+	BaseNode* child = parent->mChildren[index];
+	BaseNode* left = (index > 0) ? parent->mChildren[index - 1] : NULL;
+	BaseNode* right = (index < parent->mCount) ? parent->mChildren[index + 1] : NULL;
+
+	// Borrow the largest item of the left sibling
+	if (left != NULL && left->mCount > Slots / 2) {
+		std::move_backward(child->mKeys, child->mKeys + child->mCount, child->mKeys + child->mCount + 1);
+
+		if (child->mIsLeaf) {
+			LeafNode* leafChild = static_cast<LeafNode*>(child);
+			LeafNode* leafLeft = static_cast<LeafNode*>(left);
+
+			std::move_backward(leafChild->mValues, leafChild->mValues + leafChild->mCount, leafChild->mValues + leafChild->mCount + 1);
+
+			leafChild->mKeys[0] = leafLeft->mKeys[leafLeft->mCount - 1];
+			leafChild->mValues[0] = leafLeft->mValues[leafLeft->mCount - 1];
+
+			// The separator is the largest key still in left
+			parent->mKeys[index - 1] = leafLeft->mKeys[leafLeft->mCount - 2];
+		}
+
+		else {
+			InnerNode* innerChild = static_cast<InnerNode*>(child);
+			InnerNode* innerLeft = static_cast<InnerNode*>(left);
+
+			std::copy_backward(innerChild->mChildren, innerChild->mChildren + innerChild->mCount + 1, innerChild->mChildren + innerChild->mCount + 2);
+
+			// Rotate through the parent: the separator comes down, left's last key goes up
+			innerChild->mKeys[0] = parent->mKeys[index - 1];
+			innerChild->mChildren[0] = innerLeft->mChildren[innerLeft->mCount];
+			parent->mKeys[index - 1] = innerLeft->mKeys[innerLeft->mCount - 1];
+		}
+
+		++child->mCount;
+		--left->mCount;
+	}
+
+	// Borrow the smallest item of the right sibling
+	else if (right != NULL && right->mCount > Slots / 2) {
+		if (child->mIsLeaf) {
+			LeafNode* leafChild = static_cast<LeafNode*>(child);
+			LeafNode* leafRight = static_cast<LeafNode*>(right);
+
+			leafChild->mKeys[leafChild->mCount] = leafRight->mKeys[0];
+			leafChild->mValues[leafChild->mCount] = leafRight->mValues[0];
+
+			// The separator is the key just moved, now the largest in child
+			parent->mKeys[index] = leafRight->mKeys[0];
+
+			std::move(leafRight->mKeys + 1, leafRight->mKeys + leafRight->mCount, leafRight->mKeys);
+			std::move(leafRight->mValues + 1, leafRight->mValues + leafRight->mCount, leafRight->mValues);
+		}
+
+		else {
+			InnerNode* innerChild = static_cast<InnerNode*>(child);
+			InnerNode* innerRight = static_cast<InnerNode*>(right);
+
+			// Rotate through the parent: the separator comes down, right's first key goes up
+			innerChild->mKeys[innerChild->mCount] = parent->mKeys[index];
+			innerChild->mChildren[innerChild->mCount + 1] = innerRight->mChildren[0];
+			parent->mKeys[index] = innerRight->mKeys[0];
+
+			std::move(innerRight->mKeys + 1, innerRight->mKeys + innerRight->mCount, innerRight->mKeys);
+			std::copy(innerRight->mChildren + 1, innerRight->mChildren + innerRight->mCount + 1, innerRight->mChildren);
+		}
+
+		++child->mCount;
+		--right->mCount;
+	}
+
+	// Merge the child at mergeIndex + 1 into the one at mergeIndex
+	else {
+		int mergeIndex = (left != NULL) ? index - 1 : index;
+		BaseNode* lower = parent->mChildren[mergeIndex];
+		BaseNode* upper = parent->mChildren[mergeIndex + 1];
+
+		if (lower->mIsLeaf) {
+			LeafNode* leafLower = static_cast<LeafNode*>(lower);
+			LeafNode* leafUpper = static_cast<LeafNode*>(upper);
+
+			std::move(leafUpper->mKeys, leafUpper->mKeys + leafUpper->mCount, leafLower->mKeys + leafLower->mCount);
+			std::move(leafUpper->mValues, leafUpper->mValues + leafUpper->mCount, leafLower->mValues + leafLower->mCount);
+			leafLower->mCount += leafUpper->mCount;
+
+			// Unlink the upper leaf
+			leafLower->mNext = leafUpper->mNext;
+
+			if (leafUpper->mNext != NULL) {
+				leafUpper->mNext->mPrev = leafLower;
+			}
+
+			else {
+				mLast = leafLower;
+			}
+
+			delete leafUpper;
+		}
+
+		else {
+			InnerNode* innerLower = static_cast<InnerNode*>(lower);
+			InnerNode* innerUpper = static_cast<InnerNode*>(upper);
+
+			// The separator between them comes down between their keys
+			innerLower->mKeys[innerLower->mCount] = parent->mKeys[mergeIndex];
+
+			std::move(innerUpper->mKeys, innerUpper->mKeys + innerUpper->mCount, innerLower->mKeys + innerLower->mCount + 1);
+			std::copy(innerUpper->mChildren, innerUpper->mChildren + innerUpper->mCount + 1, innerLower->mChildren + innerLower->mCount + 1);
+			innerLower->mCount += innerUpper->mCount + 1;
+
+			delete innerUpper;
+		}
+
+		// Remove the separator and the merged child from parent
+		std::move(parent->mKeys + mergeIndex + 1, parent->mKeys + parent->mCount, parent->mKeys + mergeIndex);
+		std::copy(parent->mChildren + mergeIndex + 2, parent->mChildren + parent->mCount + 1, parent->mChildren + mergeIndex + 1);
+		--parent->mCount;
+	}
+}
+
+/*
+------------------------------------------
+End implementations for the BPlusTree class.
+------------------------------------------
+*/
+
+#endif
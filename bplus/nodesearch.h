@@ -0,0 +1,109 @@
+#ifndef NODESEARCH_H
+#define NODESEARCH_H
+
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+* Searches within one sorted node of a B+ tree. Each function returns the number of
+* keys in keys[0, count) that are less than key, which is the index std::lower_bound
+* would return. Integer keys are compared several at a time with SIMD instructions:
+* SSE2 (on by default for x86-64) handles 4 ints per step, and building with -mavx2
+* handles 8 ints or 4 long longs per step. Other key types use a binary search.
+*/
+
+/**
+* Binary search for any key type with operator<.
+*/
+template <typename Key>
+int nodeLowerBound(const Key* keys, int count, const Key& key)
+{
+	return static_cast<int>(std::lower_bound(keys, keys + count, key) - keys);
+}
+
+/**
+* Vectorized search for int keys. The node is scanned front to back a vector at a
+* time, counting the keys below key, and stops at the first vector that holds a key
+* that is not below key since the keys are sorted. A node spans a few cache lines,
+* so this touches no more memory than a binary search and has no hard to predict
+* branches.
+*/
+inline int nodeLowerBound(const int* keys, int count, const int& key)
+{
+	int index = 0;
+
+#if defined(__AVX2__)
+	__m256i target = _mm256_set1_epi32(key);
+
+	for (; index + 8 <= count; index += 8) {
+		__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + index));
+
+		// One bit for every key below key
+		int below = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(target, block)));
+
+		if (below != 0xFF) {
+			return index + __builtin_popcount(below);
+		}
+	}
+#elif defined(__SSE2__)
+	__m128i target = _mm_set1_epi32(key);
+
+	for (; index + 4 <= count; index += 4) {
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + index));
+
+		// One bit for every key below key
+		int below = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(target, block)));
+
+		if (below != 0xF) {
+			return index + __builtin_popcount(below);
+		}
+	}
+#endif
+
+	// The keys left over after the last full vector
+	while (index < count && keys[index] < key) {
+		++index;
+	}
+
+	return index;
+}
+
+/**
+* Vectorized search for long long keys, see the int version. 64 bit compares need
+* AVX2, so without it this is a binary search.
+*/
+inline int nodeLowerBound(const long long* keys, int count, const long long& key)
+{
+#if !defined(__AVX2__)
+	return static_cast<int>(std::lower_bound(keys, keys + count, key) - keys);
+#else
+	int index = 0;
+
+	__m256i target = _mm256_set1_epi64x(key);
+
+	for (; index + 4 <= count; index += 4) {
+		__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + index));
+
+		// One bit for every key below key
+		int below = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(target, block)));
+
+		if (below != 0xF) {
+			return index + __builtin_popcount(below);
+		}
+	}
+
+	// The keys left over after the last full vector
+	while (index < count && keys[index] < key) {
+		++index;
+	}
+
+	return index;
+#endif
+}
+
+#endif
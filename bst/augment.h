@@ -0,0 +1,215 @@
+#ifndef AUGMENT_H
+#define AUGMENT_H
+
+#include <limits>
+#include <algorithm>
+
+/**
+* Monoid policies for augmented search trees. A policy provides the Summary type stored
+* in every node, the identity summary, the summary of a single item, and an associative
+* combine function. combine does not need to be commutative since summaries are always
+* combined in key order.
+*/
+
+/**
+* Sums the values of a range.
+*/
+template <typename Key, typename Value>
+struct SumMonoid
+{
+	typedef Value Summary;
+
+	static Summary identity();
+	static Summary fromItem(const Key& key, const Value& value);
+	static Summary combine(const Summary& left, const Summary& right);
+};
+
+/**
+* Finds the smallest value in a range. The identity is the largest representable value.
+*/
+template <typename Key, typename Value>
+struct MinMonoid
+{
+	typedef Value Summary;
+
+	static Summary identity();
+	static Summary fromItem(const Key& key, const Value& value);
+	static Summary combine(const Summary& left, const Summary& right);
+};
+
+/**
+* Finds the largest value in a range. The identity is the lowest representable value.
+*/
+template <typename Key, typename Value>
+struct MaxMonoid
+{
+	typedef Value Summary;
+
+	static Summary identity();
+	static Summary fromItem(const Key& key, const Value& value);
+	static Summary combine(const Summary& left, const Summary& right);
+};
+
+/*
+	------------------------------------------
+	Begin implementations for the monoid policies.
+	------------------------------------------
+*/
+
+template<typename Key, typename Value>
+typename SumMonoid<Key, Value>::Summary SumMonoid<Key, Value>::identity()
+{
+	return Value();
+}
+
+template<typename Key, typename Value>
+typename SumMonoid<Key, Value>::Summary SumMonoid<Key, Value>::fromItem(const Key& key, const Value& value)
+{
+	return value;
+}
+
+template<typename Key, typename Value>
+typename SumMonoid<Key, Value>::Summary SumMonoid<Key, Value>::combine(const Summary& left, const Summary& right)
+{
+	return left + right;
+}
+
+template<typename Key, typename Value>
+typename MinMonoid<Key, Value>::Summary MinMonoid<Key, Value>::identity()
+{
+	return std::numeric_limits<Value>::max();
+}
+
+template<typename Key, typename Value>
+typename MinMonoid<Key, Value>::Summary MinMonoid<Key, Value>::fromItem(const Key& key, const Value& value)
+{
+	return value;
+}
+
+template<typename Key, typename Value>
+typename MinMonoid<Key, Value>::Summary MinMonoid<Key, Value>::combine(const Summary& left, const Summary& right)
+{
+	return std::min(left, right);
+}
+
+template<typename Key, typename Value>
+typename MaxMonoid<Key, Value>::Summary MaxMonoid<Key, Value>::identity()
+{
+	return std::numeric_limits<Value>::lowest();
+}
+
+template<typename Key, typename Value>
+typename MaxMonoid<Key, Value>::Summary MaxMonoid<Key, Value>::fromItem(const Key& key, const Value& value)
+{
+	return value;
+}
+
+template<typename Key, typename Value>
+typename MaxMonoid<Key, Value>::Summary MaxMonoid<Key, Value>::combine(const Summary& left, const Summary& right)
+{
+	return std::max(left, right);
+}
+
+/*
+	----------------------------------------
+	End implementations for the monoid policies.
+	----------------------------------------
+*/
+
+/**
+* Returns the summary stored in a node, or the identity for an empty subtree.
+*/
+template <typename Monoid, typename NodeType>
+typename Monoid::Summary subtreeSummary(const NodeType* node)
+{
+	if (node == NULL) {
+		return Monoid::identity();
+	}
+
+	return node->getSummary();
+}
+
+/**
+* Combines the summaries of all items with lo <= key < hi in the subtree rooted at root.
+* NodeType must provide getSummary() and children that can be cast to NodeType. Runs in
+* O(height) by walking down to the node where the search paths for lo and hi split and
+* then along both boundaries, taking whole subtrees that lie inside the range.
+*/
+template <typename Monoid, typename NodeType, typename Key>
+typename Monoid::Summary aggregateRange(NodeType* root, const Key& lo, const Key& hi)
+{
+	NodeType* splitNode = root;
+
+	// Find the highest node inside the range
+	while (splitNode != NULL) {
+		// If splitNode is below the range go right
+		if (splitNode->getKey() < lo) {
+			splitNode = static_cast<NodeType*>(splitNode->getRight());
+		}
+
+		// If splitNode is above the range go left
+		else if (!(splitNode->getKey() < hi)) {
+			splitNode = static_cast<NodeType*>(splitNode->getLeft());
+		}
+
+		// splitNode is inside the range
+		else {
+			break;
+		}
+	}
+
+	// If nothing is inside the range
+	if (splitNode == NULL) {
+		return Monoid::identity();
+	}
+
+	// Items in the left subtree that are >= lo. Nodes found later have smaller
+	// keys, so they are combined on the left
+	typename Monoid::Summary leftSummary = Monoid::identity();
+	NodeType* currNode = static_cast<NodeType*>(splitNode->getLeft());
+
+	while (currNode != NULL) {
+		// currNode and its whole right subtree are inside the range
+		if (!(currNode->getKey() < lo)) {
+			typename Monoid::Summary taken = Monoid::combine(
+				Monoid::fromItem(currNode->getKey(), currNode->getValue()),
+				subtreeSummary<Monoid>(static_cast<NodeType*>(currNode->getRight())));
+
+			leftSummary = Monoid::combine(taken, leftSummary);
+
+			currNode = static_cast<NodeType*>(currNode->getLeft());
+		}
+
+		else {
+			currNode = static_cast<NodeType*>(currNode->getRight());
+		}
+	}
+
+	// Items in the right subtree that are < hi. Nodes found later have larger
+	// keys, so they are combined on the right
+	typename Monoid::Summary rightSummary = Monoid::identity();
+	currNode = static_cast<NodeType*>(splitNode->getRight());
+
+	while (currNode != NULL) {
+		// currNode and its whole left subtree are inside the range
+		if (currNode->getKey() < hi) {
+			typename Monoid::Summary taken = Monoid::combine(
+				subtreeSummary<Monoid>(static_cast<NodeType*>(currNode->getLeft())),
+				Monoid::fromItem(currNode->getKey(), currNode->getValue()));
+
+			rightSummary = Monoid::combine(rightSummary, taken);
+
+			currNode = static_cast<NodeType*>(currNode->getRight());
+		}
+
+		else {
+			currNode = static_cast<NodeType*>(currNode->getLeft());
+		}
+	}
+
+	typename Monoid::Summary middle = Monoid::fromItem(splitNode->getKey(), splitNode->getValue());
+
+	return Monoid::combine(Monoid::combine(leftSummary, middle), rightSummary);
+}
+
+#endif
@@ -4,6 +4,9 @@
 #include <iostream>
 #include <exception>
 #include <cstdlib>
+#include <cstddef>
+#include <cmath>
+#include <iterator>
 #include <utility>
 
 /**
@@ -15,6 +18,9 @@ class Node
 {
 public:
 	Node(const Key& key, const Value& value, Node<Key, Value>* parent);
+
+	// Takes over an item, for trees that move nodes to new memory
+	Node(std::pair<Key, Value> item, Node<Key, Value>* parent);
 	virtual ~Node();
 
 	const std::pair<Key, Value>& getItem() const;
@@ -28,6 +34,14 @@ public:
 	virtual Node<Key, Value>* getLeft() const;
 	virtual Node<Key, Value>* getRight() const;
 
+	// The next and previous nodes in key order, or NULL at either end of the tree
+	virtual Node<Key, Value>* getSuccessor() const;
+	virtual Node<Key, Value>* getPredecessor() const;
+
+	// Allocates a copy of this node, including any data derived nodes store, with
+	// the given parent and no children. Used to copy trees without rebalancing.
+	virtual Node<Key, Value>* clone(Node<Key, Value>* parent) const;
+
 	void setParent(Node<Key, Value>* parent);
 	void setLeft(Node<Key, Value>* left);
 	void setRight(Node<Key, Value>* right);
@@ -59,6 +73,19 @@ Node<Key, Value>::Node(const Key& key, const Value& value, Node<Key, Value>* par
 
 }
 
+/**
+* Constructor that moves the item into the node.
+*/
+template<typename Key, typename Value>
+Node<Key, Value>::Node(std::pair<Key, Value> item, Node<Key, Value>* parent)
+	: mItem(std::move(item))
+	, mParent(parent)
+	, mLeft(NULL)
+	, mRight(NULL)
+{
+
+}
+
 /**
 * Destructor, which does not need to do anything since the pointers inside of a node
 * are only used as references to existing nodes. The nodes pointed to by parent/left/right
@@ -151,6 +178,75 @@ Node<Key, Value>* Node<Key, Value>::getRight() const
 	return mRight;
 }
 
+/**
+* Allocates a copy of this node's item with the given parent and no children.
+*/
+template<typename Key, typename Value>
+Node<Key, Value>* Node<Key, Value>::clone(Node<Key, Value>* parent) const
+{
+	return new Node<Key, Value>(mItem.first, mItem.second, parent);
+}
+
+/**
+* Finds the next node in key order: the leftmost node of the right subtree, or
+* else the first ancestor that this node is in the left subtree of.
+*/
+template<typename Key, typename Value>
+Node<Key, Value>* Node<Key, Value>::getSuccessor() const
+{
+	// If there is a right subtree, the successor is its smallest node
+	if (mRight != NULL) {
+		Node<Key, Value>* currNode = mRight;
+
+		while (currNode->mLeft != NULL) {
+			currNode = currNode->mLeft;
+		}
+
+		return currNode;
+	}
+
+	// Otherwise climb until we come up from a left child
+	const Node<Key, Value>* currNode = this;
+	Node<Key, Value>* parent = mParent;
+
+	while (parent != NULL && currNode == parent->mRight) {
+		currNode = parent;
+		parent = parent->mParent;
+	}
+
+	return parent;
+}
+
+/**
+* Finds the previous node in key order: the rightmost node of the left subtree, or
+* else the first ancestor that this node is in the right subtree of.
+*/
+template<typename Key, typename Value>
+Node<Key, Value>* Node<Key, Value>::getPredecessor() const
+{
+	// If there is a left subtree, the predecessor is its largest node
+	if (mLeft != NULL) {
+		Node<Key, Value>* currNode = mLeft;
+
+		while (currNode->mRight != NULL) {
+			currNode = currNode->mRight;
+		}
+
+		return currNode;
+	}
+
+	// Otherwise climb until we come up from a right child
+	const Node<Key, Value>* currNode = this;
+	Node<Key, Value>* parent = mParent;
+
+	while (parent != NULL && currNode == parent->mLeft) {
+		currNode = parent;
+		parent = parent->mParent;
+	}
+
+	return parent;
+}
+
 /**
 * A setter for setting the parent of a node.
 */
@@ -201,51 +297,269 @@ class BinarySearchTree
 {
 public:
 	BinarySearchTree();
-	~BinarySearchTree();
+
+	// Virtual so that deleting a derived tree through a BinarySearchTree pointer
+	// frees its nodes the way the derived tree allocated them
+	virtual ~BinarySearchTree();
+
+	// Copies keep the exact shape of the original and do no comparisons or
+	// rebalancing. Moves take over the nodes in O(1) and leave the source empty.
+	BinarySearchTree(const BinarySearchTree<Key, Value>& other);
+	BinarySearchTree(BinarySearchTree<Key, Value>&& other) noexcept;
+	BinarySearchTree<Key, Value>& operator=(const BinarySearchTree<Key, Value>& other);
+	BinarySearchTree<Key, Value>& operator=(BinarySearchTree<Key, Value>&& other) noexcept;
 
 	virtual void insert(const std::pair<Key, Value>& keyValuePair);
-	void clear();
+	virtual void clear();
 	void print() const;
 
+	// Rebuilds the tree into a complete tree in place with the Day-Stout-Warren
+	// algorithm: O(n) time and O(1) extra space, no comparisons and no allocation.
+	void rebalance();
+
+	// Makes insert call rebalance() when a new node lands deeper than factor * log2(n).
+	// 0 (the default) turns the automatic rebalance off. Only the unbalanced trees
+	// use it: BinarySearchTree checks it in insert and SplayTree before every splay.
+	// The self-balancing trees (AVL, red-black, weak AVL, scapegoat and treap)
+	// override insert and ignore it, since their height is already bounded.
+	void setRebalanceFactor(double factor);
+
 public:
+	class const_iterator;
+
 	/**
-	* An internal iterator class for traversing the contents of the BST.
+	* An internal iterator class for traversing the contents of the BST in either
+	* direction. Stepping is O(1) amortized. The end iterator remembers its tree so
+	* that it can be decremented to the largest item.
 	*/
 	class iterator
 	{
 	public:
+		typedef std::bidirectional_iterator_tag iterator_category;
+		typedef std::pair<Key, Value> value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef std::pair<Key, Value>* pointer;
+		typedef std::pair<Key, Value>& reference;
+
 		iterator(Node<Key,Value>* ptr);
+		iterator(Node<Key,Value>* ptr, const BinarySearchTree<Key, Value>* tree);
 		iterator();
 
-		std::pair<Key,Value>& operator*();
-		std::pair<Key,Value>* operator->();
+		std::pair<Key,Value>& operator*() const;
+		std::pair<Key,Value>* operator->() const;
 
 		bool operator==(const iterator& rhs) const;
 		bool operator!=(const iterator& rhs) const;
 		iterator& operator=(const iterator& rhs);
 
 		iterator& operator++();
+		iterator operator++(int);
+		iterator& operator--();
+		iterator operator--(int);
 
 	protected:
 		Node<Key, Value>* mCurrent;
+		const BinarySearchTree<Key, Value>* mTree;
+
+		friend class BinarySearchTree<Key, Value>;
+		friend class const_iterator;
+	};
+
+	/**
+	* The same as iterator, but only gives read access to the items. An iterator
+	* converts to a const_iterator.
+	*/
+	class const_iterator
+	{
+	public:
+		typedef std::bidirectional_iterator_tag iterator_category;
+		typedef std::pair<Key, Value> value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const std::pair<Key, Value>* pointer;
+		typedef const std::pair<Key, Value>& reference;
+
+		const_iterator(const Node<Key,Value>* ptr);
+		const_iterator(const Node<Key,Value>* ptr, const BinarySearchTree<Key, Value>* tree);
+		const_iterator(const iterator& it);
+		const_iterator();
+
+		const std::pair<Key,Value>& operator*() const;
+		const std::pair<Key,Value>* operator->() const;
+
+		bool operator==(const const_iterator& rhs) const;
+		bool operator!=(const const_iterator& rhs) const;
+
+		const_iterator& operator++();
+		const_iterator operator++(int);
+		const_iterator& operator--();
+		const_iterator operator--(int);
+
+	protected:
+		const Node<Key, Value>* mCurrent;
+		const BinarySearchTree<Key, Value>* mTree;
+
+		friend class BinarySearchTree<Key, Value>;
+	};
+
+	typedef std::reverse_iterator<iterator> reverse_iterator;
+	typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+	/**
+	* A view over the items with lo <= key < hi. It only holds the two boundary
+	* iterators, so no items are copied and iteration walks the tree in place.
+	*/
+	template <typename Iterator>
+	class basic_range_view
+	{
+	public:
+		basic_range_view(const Iterator& first, const Iterator& last);
+
+		Iterator begin() const;
+		Iterator end() const;
+		bool empty() const;
+
+	protected:
+		Iterator mBegin;
+		Iterator mEnd;
 	};
 
+	typedef basic_range_view<iterator> range_view;
+	typedef basic_range_view<const_iterator> const_range_view;
+
 public:
 	iterator begin();
 	iterator end();
-	iterator find(const Key& key) const;
+	const_iterator begin() const;
+	const_iterator end() const;
+	const_iterator cbegin() const;
+	const_iterator cend() const;
+	reverse_iterator rbegin();
+	reverse_iterator rend();
+	const_reverse_iterator rbegin() const;
+	const_reverse_iterator rend() const;
+
+	iterator find(const Key& key);
+	const_iterator find(const Key& key) const;
+
+	// Ordered searches, all O(height). Each returns end() if no such item exists.
+	iterator lower_bound(const Key& key);		// First item with key >= key
+	iterator upper_bound(const Key& key);		// First item with key > key
+	std::pair<iterator, iterator> equal_range(const Key& key);
+	iterator floor(const Key& key);			// Last item with key <= key
+	iterator ceiling(const Key& key);		// First item with key >= key
+	iterator predecessor(const Key& key);		// Last item with key < key
+	iterator successor(const Key& key);		// First item with key > key
+	range_view range(const Key& lo, const Key& hi);
+
+	const_iterator lower_bound(const Key& key) const;
+	const_iterator upper_bound(const Key& key) const;
+	std::pair<const_iterator, const_iterator> equal_range(const Key& key) const;
+	const_iterator floor(const Key& key) const;
+	const_iterator ceiling(const Key& key) const;
+	const_iterator predecessor(const Key& key) const;
+	const_iterator successor(const Key& key) const;
+	const_range_view range(const Key& lo, const Key& hi) const;
+
+	// Removes the item an iterator points at and returns an iterator to the next
+	// item. The node is unlinked directly, without comparing any keys.
+	iterator erase(iterator pos);
+
+	// The smallest and largest items. These use the cached min/max nodes and run
+	// in O(1). The tree must not be empty.
+	std::pair<Key, Value>& front();
+	std::pair<Key, Value>& back();
+	const std::pair<Key, Value>& front() const;
+	const std::pair<Key, Value>& back() const;
+
+	// Remove and return the smallest or largest item, so the tree can be used as a
+	// priority queue. The tree must not be empty.
+	std::pair<Key, Value> pop_min();
+	std::pair<Key, Value> pop_max();
 
 protected:
 	Node<Key, Value>* internalFind(const Key& key) const;
+
+	// Returns the smallest node with a key greater than (or equal to, if inclusive)
+	// key, or NULL if there is none
+	Node<Key, Value>* internalCeiling(const Key& key, bool inclusive) const;
+
+	// Returns the largest node with a key less than (or equal to, if inclusive)
+	// key, or NULL if there is none
+	Node<Key, Value>* internalFloor(const Key& key, bool inclusive) const;
+
+	// Returns the nodes bounding the items equal to key as [first, last)
+	void internalEqualRange(const Key& key, Node<Key, Value>*& first, Node<Key, Value>*& last) const;
+
+	// Return the cached smallest and largest nodes in O(1)
 	Node<Key, Value>* getSmallestNode() const;
+	Node<Key, Value>* getLargestNode() const;
+
+	// Keep the cached smallest and largest nodes up to date. cacheInsertedNode is
+	// called with every newly linked node, uncacheRemovedNode with every node about
+	// to be unlinked (while it is still in the tree), and recacheBounds after bulk
+	// changes that cannot track single nodes.
+	void cacheInsertedNode(Node<Key, Value>* newNode);
+	void uncacheRemovedNode(Node<Key, Value>* node);
+	void recacheBounds();
+
 	void printRoot (Node<Key, Value>* root) const;
 
+	// Frees every node in a subtree
+	void deleteSubtree(Node<Key, Value>* root);
+
+	// Copies a subtree node by node in O(size) and returns the root of the copy
+	static Node<Key, Value>* cloneSubtree(const Node<Key, Value>* root);
+
+	// Returns true if depth is deep enough to trigger the automatic rebalance
+	bool rebalanceNeeded(int depth) const;
+
+	// Rebuilds the subtree at root into a complete tree in place and links it back
+	// in where root was. Returns the new root of the subtree. Does not call
+	// rebuildNodeData().
+	Node<Key, Value>* rebalanceSubtree(Node<Key, Value>* root);
+
+	// Steps of rebalanceSubtree(), on the subtree whose root is held in root.
+	// treeToVine turns the subtree into a chain of right children and returns its
+	// length, compressVine does count left rotations down the chain.
+	static int treeToVine(Node<Key, Value>*& root);
+	static void compressVine(Node<Key, Value>*& root, int count);
+
+	// Called once after rebalance() has restructured the tree. Trees that store data
+	// derived from subtrees override this to recompute it, for example by walking
+	// the nodes in post-order.
+	virtual void rebuildNodeData();
+
+	// Post-order traversal without recursion: children before their parent
+	static Node<Key, Value>* getPostOrderFirst(Node<Key, Value>* root);
+	static Node<Key, Value>* getPostOrderNext(Node<Key, Value>* node);
+
+	// Allocates a node for insert. Trees that store extra data in their nodes
+	// override this to allocate their own node type.
+	virtual Node<Key, Value>* createNode(const Key& key, const Value& value, Node<Key, Value>* parent);
+
+	// Frees a node that is no longer linked into the tree. Trees that place their
+	// nodes in memory of their own override this to give it back there.
+	virtual void destroyNode(Node<Key, Value>* node);
+
 	/* Helper functions are strongly encouraged to help separate the problem
 	   into smaller pieces. You should not need additional data members. */
 
 	virtual void remove(const Key& key);
+
+	// Removes a node that is known to be in the tree without searching for it.
+	// Balanced trees override this to rebalance after the node is unlinked.
+	virtual void removeNode(Node<Key, Value>* nodeToDelete);
+
+	// Gives derived trees access to the node an iterator points at. The tree owns
+	// its nodes, so a const_iterator gives a node that can be changed as well.
+	static Node<Key, Value>* getNode(const iterator& it);
+	static Node<Key, Value>* getNode(const const_iterator& it);
 protected:
 	Node<Key, Value>* mRoot;
+	Node<Key, Value>* mMin;
+	Node<Key, Value>* mMax;
+	int mNodeCount;
+	double mRebalanceFactor;
 
 };
 
@@ -257,10 +571,24 @@ protected:
 
 /**
 * Explicit constructor that initializes an iterator with a given node pointer.
+* An iterator built this way cannot be decremented from the end.
 */
 template<typename Key, typename Value>
 BinarySearchTree<Key, Value>::iterator::iterator(Node<Key,Value>* ptr)
 	: mCurrent(ptr)
+	, mTree(NULL)
+{
+
+}
+
+/**
+* Constructor that initializes an iterator with a given node pointer and the tree
+* it belongs to.
+*/
+template<typename Key, typename Value>
+BinarySearchTree<Key, Value>::iterator::iterator(Node<Key,Value>* ptr, const BinarySearchTree<Key, Value>* tree)
+	: mCurrent(ptr)
+	, mTree(tree)
 {
 
 }
@@ -271,6 +599,7 @@ BinarySearchTree<Key, Value>::iterator::iterator(Node<Key,Value>* ptr)
 template<typename Key, typename Value>
 BinarySearchTree<Key, Value>::iterator::iterator()
 	: mCurrent(NULL)
+	, mTree(NULL)
 {
 
 }
@@ -279,7 +608,7 @@ BinarySearchTree<Key, Value>::iterator::iterator()
 * Provides access to the item.
 */
 template<typename Key, typename Value>
-std::pair<Key, Value>& BinarySearchTree<Key, Value>::iterator::operator*()
+std::pair<Key, Value>& BinarySearchTree<Key, Value>::iterator::operator*() const
 {
 	return mCurrent->getItem(); 
 }
@@ -288,7 +617,7 @@ std::pair<Key, Value>& BinarySearchTree<Key, Value>::iterator::operator*()
 * Provides access to the address of the item.
 */
 template<typename Key, typename Value>
-std::pair<Key, Value>* BinarySearchTree<Key, Value>::iterator::operator->()
+std::pair<Key, Value>* BinarySearchTree<Key, Value>::iterator::operator->() const
 {
 	return &(mCurrent->getItem());
 }
@@ -320,6 +649,7 @@ template<typename Key, typename Value>
 typename BinarySearchTree<Key, Value>::iterator &BinarySearchTree<Key, Value>::iterator::operator=(const BinarySearchTree<Key, Value>::iterator& rhs)
 {
 	this->mCurrent = rhs.mCurrent;
+	this->mTree = rhs.mTree;
 	return *this;
 }
 
@@ -329,27 +659,50 @@ typename BinarySearchTree<Key, Value>::iterator &BinarySearchTree<Key, Value>::i
 template<typename Key, typename Value>
 typename BinarySearchTree<Key, Value>::iterator& BinarySearchTree<Key, Value>::iterator::operator++()
 {
-	if(mCurrent->getRight() != NULL)
-	{
-		mCurrent = mCurrent->getRight();
-		while(mCurrent->getLeft() != NULL)
-		{
-			mCurrent = mCurrent->getLeft();
-		}
+	mCurrent = mCurrent->getSuccessor();
+	return *this;
+}
+
+/**
+* Advances the iterator and returns its old location.
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::iterator BinarySearchTree<Key, Value>::iterator::operator++(int)
+{
+	iterator old = *this;
+	++(*this);
+	return old;
+}
+
+/**
+* Moves the iterator back using a reverse in-order traversal. Decrementing the
+* end iterator moves it to the largest item.
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::iterator& BinarySearchTree<Key, Value>::iterator::operator--()
+{
+	if (mCurrent == NULL) {
+		mCurrent = mTree->getLargestNode();
 	}
-	else if(mCurrent->getRight() == NULL)
-	{
-		Node<Key, Value>* parent = mCurrent->getParent();
-		while(parent != NULL && mCurrent == parent->getRight())
-		{
-			mCurrent = parent;
-			parent = parent->getParent();
-		}
-		mCurrent = parent;
+
+	else {
+		mCurrent = mCurrent->getPredecessor();
 	}
+
 	return *this;
 }
 
+/**
+* Moves the iterator back and returns its old location.
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::iterator BinarySearchTree<Key, Value>::iterator::operator--(int)
+{
+	iterator old = *this;
+	--(*this);
+	return old;
+}
+
 /* 
 	-------------------------------------------------------------
 	End implementations for the BinarySearchTree::iterator class.
@@ -357,136 +710,679 @@ typename BinarySearchTree<Key, Value>::iterator& BinarySearchTree<Key, Value>::i
 */
 
 /* 
-	-----------------------------------------------------
-	Begin implementations for the BinarySearchTree class.
-	-----------------------------------------------------
-*/
+	---------------------------------------------------------------------
+	Begin implementations for the BinarySearchTree::const_iterator class.
+	---------------------------------------------------------------------
+*/ 
 
 /**
-* Default constructor for a BinarySearchTree, which sets the root to NULL.
+* Explicit constructor that initializes an iterator with a given node pointer.
+* An iterator built this way cannot be decremented from the end.
 */
 template<typename Key, typename Value>
-BinarySearchTree<Key, Value>::BinarySearchTree()
+BinarySearchTree<Key, Value>::const_iterator::const_iterator(const Node<Key,Value>* ptr)
+	: mCurrent(ptr)
+	, mTree(NULL)
 {
-	mRoot = NULL;
+
 }
 
+/**
+* Constructor that initializes an iterator with a given node pointer and the tree
+* it belongs to.
+*/
 template<typename Key, typename Value>
-BinarySearchTree<Key, Value>::~BinarySearchTree()
+BinarySearchTree<Key, Value>::const_iterator::const_iterator(const Node<Key,Value>* ptr, const BinarySearchTree<Key, Value>* tree)
+	: mCurrent(ptr)
+	, mTree(tree)
 {
-	clear();
+
 }
 
+/**
+* Converts a mutable iterator into a read-only one.
+*/
 template<typename Key, typename Value>
-void BinarySearchTree<Key, Value>::print() const
+BinarySearchTree<Key, Value>::const_iterator::const_iterator(const iterator& it)
+	: mCurrent(it.mCurrent)
+	, mTree(it.mTree)
 {
-	printRoot(mRoot);
-	std::cout << "\n";
+
 }
 
 /**
-* Returns an iterator to the "smallest" item in the tree
+* A default constructor that initializes the iterator to NULL.
 */
 template<typename Key, typename Value>
-typename BinarySearchTree<Key, Value>::iterator BinarySearchTree<Key, Value>::begin()
+BinarySearchTree<Key, Value>::const_iterator::const_iterator()
+	: mCurrent(NULL)
+	, mTree(NULL)
 {
-	BinarySearchTree<Key, Value>::iterator begin(getSmallestNode());
-	return begin;
+
 }
 
 /**
-* Returns an iterator whose value means INVALID
+* Provides read access to the item.
 */
 template<typename Key, typename Value>
-typename BinarySearchTree<Key, Value>::iterator BinarySearchTree<Key, Value>::end()
+const std::pair<Key, Value>& BinarySearchTree<Key, Value>::const_iterator::operator*() const
 {
-	BinarySearchTree<Key, Value>::iterator end(NULL);
-	return end;
+	return mCurrent->getItem(); 
 }
 
 /**
-* Returns an iterator to the item with the given key, k
-* or the end iterator if k does not exist in the tree
+* Provides read access to the address of the item.
 */
 template<typename Key, typename Value>
-typename BinarySearchTree<Key, Value>::iterator BinarySearchTree<Key, Value>::find(const Key& key) const
+const std::pair<Key, Value>* BinarySearchTree<Key, Value>::const_iterator::operator->() const
 {
-	Node<Key, Value>* curr = internalFind(key);
-	BinarySearchTree<Key, Value>::iterator it(curr);
-	return it;
+	return &(mCurrent->getItem());
 }
 
 /**
-* An insert method to insert into a Binary Search Tree. The tree will not remain balanced when
-* inserting.
+* Checks if 'this' iterator's internals have the same value
+* as 'rhs'
 */
 template<typename Key, typename Value>
-void BinarySearchTree<Key, Value>::insert(const std::pair<Key, Value>& keyValuePair)
+bool BinarySearchTree<Key, Value>::const_iterator::operator==(const BinarySearchTree<Key, Value>::const_iterator& rhs) const
 {
-	// If the BST is empty
-	if (mRoot == NULL) {
-		// Create new node with keyValuePair's information
-		// Set Parent to null
-		Node<Key, Value>* newNode = new Node<Key, Value>(keyValuePair.first, keyValuePair.second, NULL);
-
-		// Add new node to BST as root
-		mRoot = newNode;
-	}
+	return this->mCurrent == rhs.mCurrent;
+}
 
-	// If BST has only one node
-	else if (mRoot->getLeft() == NULL && mRoot->getRight() == NULL) {
-		// If there is a duplicate entry
-		if (keyValuePair.first == mRoot->getKey()) {
-			// Update root's value
-			mRoot->setValue(keyValuePair.second);
-			return;
-		}
+/**
+* Checks if 'this' iterator's internals have a different value
+* as 'rhs'
+*/
+template<typename Key, typename Value>
+bool BinarySearchTree<Key, Value>::const_iterator::operator!=(const BinarySearchTree<Key, Value>::const_iterator& rhs) const
+{
+	return this->mCurrent != rhs.mCurrent;
+}
 
-		// Create new node with keyValuePair's information
-		// Set Parent to mRoot
-		Node<Key, Value>* newNode = new Node<Key, Value>(keyValuePair.first, keyValuePair.second, mRoot);
+/**
+* Advances the iterator's location using an in-order traversal.
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::const_iterator& BinarySearchTree<Key, Value>::const_iterator::operator++()
+{
+	mCurrent = mCurrent->getSuccessor();
+	return *this;
+}
 
-		// If new node is lesser than root
-		if (newNode->getKey() < mRoot->getKey()) {
-			// Set newNode as root's left child
-			mRoot->setLeft(newNode);
-		}
+/**
+* Advances the iterator and returns its old location.
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::const_iterator BinarySearchTree<Key, Value>::const_iterator::operator++(int)
+{
+	const_iterator old = *this;
+	++(*this);
+	return old;
+}
 
-		// If new node is greater than root
-		else {
-			// Set newNode as root's right child
-			mRoot->setRight(newNode);
-		}
+/**
+* Moves the iterator back using a reverse in-order traversal. Decrementing the
+* end iterator moves it to the largest item.
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::const_iterator& BinarySearchTree<Key, Value>::const_iterator::operator--()
+{
+	if (mCurrent == NULL) {
+		mCurrent = mTree->getLargestNode();
 	}
 
-	// If BST has more than one node
 	else {
-		Node<Key, Value>* currNode = mRoot;
-		// Will store the parent of the new node that
-		// needs to be added after the while loop finishes
-		Node<Key, Value>* prevNode;
-
-		// Create new node with keyValuePair's information
-		// Set Parent to NULL (Will be changed after we find where to
-		// insert in tree)
-		Node<Key, Value>* newNode = new Node<Key, Value>(keyValuePair.first, keyValuePair.second, NULL);
+		mCurrent = mCurrent->getPredecessor();
+	}
 
-		// While loop to find location to add newNode
-		while(currNode != NULL) {
-			// If there is a duplicate entry
-			if (newNode->getKey() == currNode->getKey()) {
-				// Update currNode's value
-				currNode->setValue(newNode->getValue());
-				return;
-			}
+	return *this;
+}
 
-			// If new node is lesser than currNode
-			else if (newNode->getKey() < currNode->getKey()) {
-				// Save currNode
-				prevNode = currNode;
-				// Move to left child of currNode
-				currNode = currNode->getLeft();
-			}
+/**
+* Moves the iterator back and returns its old location.
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::const_iterator BinarySearchTree<Key, Value>::const_iterator::operator--(int)
+{
+	const_iterator old = *this;
+	--(*this);
+	return old;
+}
+
+/* 
+	-------------------------------------------------------------------
+	End implementations for the BinarySearchTree::const_iterator class.
+	-------------------------------------------------------------------
+*/
+
+/* 
+	-----------------------------------------------------------------
+	Begin implementations for the BinarySearchTree::range_view class.
+	-----------------------------------------------------------------
+*/
+
+/**
+* Constructs a view over [first, last).
+*/
+template<typename Key, typename Value>
+template<typename Iterator>
+BinarySearchTree<Key, Value>::basic_range_view<Iterator>::basic_range_view(const Iterator& first, const Iterator& last)
+	: mBegin(first)
+	, mEnd(last)
+{
+
+}
+
+/**
+* Returns an iterator to the first item in the view.
+*/
+template<typename Key, typename Value>
+template<typename Iterator>
+Iterator BinarySearchTree<Key, Value>::basic_range_view<Iterator>::begin() const
+{
+	return mBegin;
+}
+
+/**
+* Returns an iterator one past the last item in the view.
+*/
+template<typename Key, typename Value>
+template<typename Iterator>
+Iterator BinarySearchTree<Key, Value>::basic_range_view<Iterator>::end() const
+{
+	return mEnd;
+}
+
+/**
+* Returns true if the view has no items.
+*/
+template<typename Key, typename Value>
+template<typename Iterator>
+bool BinarySearchTree<Key, Value>::basic_range_view<Iterator>::empty() const
+{
+	return mBegin == mEnd;
+}
+
+/* 
+	---------------------------------------------------------------
+	End implementations for the BinarySearchTree::range_view class.
+	---------------------------------------------------------------
+*/
+
+/* 
+	-----------------------------------------------------
+	Begin implementations for the BinarySearchTree class.
+	-----------------------------------------------------
+*/
+
+/**
+* Default constructor for a BinarySearchTree, which sets the root to NULL.
+*/
+template<typename Key, typename Value>
+BinarySearchTree<Key, Value>::BinarySearchTree()
+{
+	mRoot = NULL;
+	mMin = NULL;
+	mMax = NULL;
+	mNodeCount = 0;
+	mRebalanceFactor = 0;
+}
+
+template<typename Key, typename Value>
+BinarySearchTree<Key, Value>::~BinarySearchTree()
+{
+	clear();
+}
+
+/**
+* Copy constructor. Every node is cloned in place, so the copy has the same shape
+* and the same per-node data (such as AVL heights) as other.
+*/
+template<typename Key, typename Value>
+BinarySearchTree<Key, Value>::BinarySearchTree(const BinarySearchTree<Key, Value>& other)
+{
+	mRoot = cloneSubtree(other.mRoot);
+	mNodeCount = other.mNodeCount;
+	mRebalanceFactor = other.mRebalanceFactor;
+
+	recacheBounds();
+}
+
+/**
+* Move constructor. Takes over other's nodes and leaves other empty.
+*/
+template<typename Key, typename Value>
+BinarySearchTree<Key, Value>::BinarySearchTree(BinarySearchTree<Key, Value>&& other) noexcept
+	: mRoot(other.mRoot)
+	, mMin(other.mMin)
+	, mMax(other.mMax)
+	, mNodeCount(other.mNodeCount)
+	, mRebalanceFactor(other.mRebalanceFactor)
+{
+	other.mRoot = NULL;
+	other.mMin = NULL;
+	other.mMax = NULL;
+	other.mNodeCount = 0;
+}
+
+/**
+* Copy assignment. Frees this tree's nodes and clones other's.
+*/
+template<typename Key, typename Value>
+BinarySearchTree<Key, Value>& BinarySearchTree<Key, Value>::operator=(const BinarySearchTree<Key, Value>& other)
+{
+	// Self assignment
+	if (this == &other) {
+		return *this;
+	}
+
+	clear();
+
+	mRoot = cloneSubtree(other.mRoot);
+	mNodeCount = other.mNodeCount;
+	mRebalanceFactor = other.mRebalanceFactor;
+
+	recacheBounds();
+
+	return *this;
+}
+
+/**
+* Move assignment. Frees this tree's nodes, takes over other's and leaves other empty.
+*/
+template<typename Key, typename Value>
+BinarySearchTree<Key, Value>& BinarySearchTree<Key, Value>::operator=(BinarySearchTree<Key, Value>&& other) noexcept
+{
+	// Self assignment
+	if (this == &other) {
+		return *this;
+	}
+
+	clear();
+
+	mRoot = other.mRoot;
+	mMin = other.mMin;
+	mMax = other.mMax;
+	mNodeCount = other.mNodeCount;
+	mRebalanceFactor = other.mRebalanceFactor;
+
+	other.mRoot = NULL;
+	other.mMin = NULL;
+	other.mMax = NULL;
+	other.mNodeCount = 0;
+
+	return *this;
+}
+
+template<typename Key, typename Value>
+void BinarySearchTree<Key, Value>::print() const
+{
+	printRoot(mRoot);
+	std::cout << "\n";
+}
+
+/**
+* Returns an iterator to the "smallest" item in the tree
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::iterator BinarySearchTree<Key, Value>::begin()
+{
+	BinarySearchTree<Key, Value>::iterator begin(getSmallestNode(), this);
+	return begin;
+}
+
+/**
+* Returns an iterator whose value means INVALID
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::iterator BinarySearchTree<Key, Value>::end()
+{
+	BinarySearchTree<Key, Value>::iterator end(NULL, this);
+	return end;
+}
+
+/**
+* Returns a read-only iterator to the "smallest" item in the tree
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::const_iterator BinarySearchTree<Key, Value>::begin() const
+{
+	return const_iterator(getSmallestNode(), this);
+}
+
+/**
+* Returns a read-only iterator whose value means INVALID
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::const_iterator BinarySearchTree<Key, Value>::end() const
+{
+	return const_iterator(NULL, this);
+}
+
+/**
+* Returns a read-only iterator to the "smallest" item in the tree
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::const_iterator BinarySearchTree<Key, Value>::cbegin() const
+{
+	return begin();
+}
+
+/**
+* Returns a read-only iterator whose value means INVALID
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::const_iterator BinarySearchTree<Key, Value>::cend() const
+{
+	return end();
+}
+
+/**
+* Returns a reverse iterator to the "largest" item in the tree
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::reverse_iterator BinarySearchTree<Key, Value>::rbegin()
+{
+	return reverse_iterator(end());
+}
+
+/**
+* Returns a reverse iterator one before the "smallest" item in the tree
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::reverse_iterator BinarySearchTree<Key, Value>::rend()
+{
+	return reverse_iterator(begin());
+}
+
+/**
+* Returns a read-only reverse iterator to the "largest" item in the tree
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::const_reverse_iterator BinarySearchTree<Key, Value>::rbegin() const
+{
+	return const_reverse_iterator(end());
+}
+
+/**
+* Returns a read-only reverse iterator one before the "smallest" item in the tree
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::const_reverse_iterator BinarySearchTree<Key, Value>::rend() const
+{
+	return const_reverse_iterator(begin());
+}
+
+/**
+* Returns an iterator to the item with the given key, k
+* or the end iterator if k does not exist in the tree
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::iterator BinarySearchTree<Key, Value>::find(const Key& key)
+{
+	return iterator(internalFind(key), this);
+}
+
+/**
+* Returns a read-only iterator to the item with the given key, k
+* or the end iterator if k does not exist in the tree
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::const_iterator BinarySearchTree<Key, Value>::find(const Key& key) const
+{
+	return const_iterator(internalFind(key), this);
+}
+
+/**
+* Returns an iterator to the first item whose key is not less than key.
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::iterator BinarySearchTree<Key, Value>::lower_bound(const Key& key)
+{
+	return iterator(internalCeiling(key, true), this);
+}
+
+/**
+* Returns an iterator to the first item whose key is greater than key.
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::iterator BinarySearchTree<Key, Value>::upper_bound(const Key& key)
+{
+	return iterator(internalCeiling(key, false), this);
+}
+
+/**
+* Returns the range of items equal to key. Keys are unique, so the range holds
+* at most one item.
+*/
+template<typename Key, typename Value>
+std::pair<typename BinarySearchTree<Key, Value>::iterator, typename BinarySearchTree<Key, Value>::iterator>
+BinarySearchTree<Key, Value>::equal_range(const Key& key)
+{
+	Node<Key, Value>* first;
+	Node<Key, Value>* last;
+
+	internalEqualRange(key, first, last);
+
+	return std::make_pair(iterator(first, this), iterator(last, this));
+}
+
+/**
+* Returns an iterator to the last item whose key is not greater than key.
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::iterator BinarySearchTree<Key, Value>::floor(const Key& key)
+{
+	return iterator(internalFloor(key, true), this);
+}
+
+/**
+* Returns an iterator to the first item whose key is not less than key.
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::iterator BinarySearchTree<Key, Value>::ceiling(const Key& key)
+{
+	return iterator(internalCeiling(key, true), this);
+}
+
+/**
+* Returns an iterator to the last item whose key is less than key.
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::iterator BinarySearchTree<Key, Value>::predecessor(const Key& key)
+{
+	return iterator(internalFloor(key, false), this);
+}
+
+/**
+* Returns an iterator to the first item whose key is greater than key.
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::iterator BinarySearchTree<Key, Value>::successor(const Key& key)
+{
+	return iterator(internalCeiling(key, false), this);
+}
+
+/**
+* Returns a view over the items with lo <= key < hi.
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::range_view BinarySearchTree<Key, Value>::range(const Key& lo, const Key& hi)
+{
+	// Empty range
+	if (!(lo < hi)) {
+		return range_view(end(), end());
+	}
+
+	return range_view(lower_bound(lo), lower_bound(hi));
+}
+
+/**
+* Returns a read-only iterator to the first item whose key is not less than key.
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::const_iterator BinarySearchTree<Key, Value>::lower_bound(const Key& key) const
+{
+	return const_iterator(internalCeiling(key, true), this);
+}
+
+/**
+* Returns a read-only iterator to the first item whose key is greater than key.
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::const_iterator BinarySearchTree<Key, Value>::upper_bound(const Key& key) const
+{
+	return const_iterator(internalCeiling(key, false), this);
+}
+
+/**
+* Returns the read-only range of items equal to key.
+*/
+template<typename Key, typename Value>
+std::pair<typename BinarySearchTree<Key, Value>::const_iterator, typename BinarySearchTree<Key, Value>::const_iterator>
+BinarySearchTree<Key, Value>::equal_range(const Key& key) const
+{
+	Node<Key, Value>* first;
+	Node<Key, Value>* last;
+
+	internalEqualRange(key, first, last);
+
+	return std::make_pair(const_iterator(first, this), const_iterator(last, this));
+}
+
+/**
+* Returns a read-only iterator to the last item whose key is not greater than key.
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::const_iterator BinarySearchTree<Key, Value>::floor(const Key& key) const
+{
+	return const_iterator(internalFloor(key, true), this);
+}
+
+/**
+* Returns a read-only iterator to the first item whose key is not less than key.
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::const_iterator BinarySearchTree<Key, Value>::ceiling(const Key& key) const
+{
+	return const_iterator(internalCeiling(key, true), this);
+}
+
+/**
+* Returns a read-only iterator to the last item whose key is less than key.
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::const_iterator BinarySearchTree<Key, Value>::predecessor(const Key& key) const
+{
+	return const_iterator(internalFloor(key, false), this);
+}
+
+/**
+* Returns a read-only iterator to the first item whose key is greater than key.
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::const_iterator BinarySearchTree<Key, Value>::successor(const Key& key) const
+{
+	return const_iterator(internalCeiling(key, false), this);
+}
+
+/**
+* Returns a read-only view over the items with lo <= key < hi.
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::const_range_view BinarySearchTree<Key, Value>::range(const Key& lo, const Key& hi) const
+{
+	// Empty range
+	if (!(lo < hi)) {
+		return const_range_view(end(), end());
+	}
+
+	return const_range_view(lower_bound(lo), lower_bound(hi));
+}
+
+/**
+* An insert method to insert into a Binary Search Tree. The tree will not remain balanced when
+* inserting.
+*/
+template<typename Key, typename Value>
+void BinarySearchTree<Key, Value>::insert(const std::pair<Key, Value>& keyValuePair)
+{
+	// If the BST is empty
+	if (mRoot == NULL) {
+		// Create new node with keyValuePair's information
+		// Set Parent to null
+		Node<Key, Value>* newNode = createNode(keyValuePair.first, keyValuePair.second, NULL);
+
+		// Add new node to BST as root
+		mRoot = newNode;
+
+		cacheInsertedNode(newNode);
+	}
+
+	// If BST has only one node
+	else if (mRoot->getLeft() == NULL && mRoot->getRight() == NULL) {
+		// If there is a duplicate entry
+		if (keyValuePair.first == mRoot->getKey()) {
+			// Update root's value
+			mRoot->setValue(keyValuePair.second);
+			return;
+		}
+
+		// Create new node with keyValuePair's information
+		// Set Parent to mRoot
+		Node<Key, Value>* newNode = createNode(keyValuePair.first, keyValuePair.second, mRoot);
+
+		// If new node is lesser than root
+		if (newNode->getKey() < mRoot->getKey()) {
+			// Set newNode as root's left child
+			mRoot->setLeft(newNode);
+		}
+
+		// If new node is greater than root
+		else {
+			// Set newNode as root's right child
+			mRoot->setRight(newNode);
+		}
+
+		cacheInsertedNode(newNode);
+	}
+
+	// If BST has more than one node
+	else {
+		Node<Key, Value>* currNode = mRoot;
+		// Will store the parent of the new node that
+		// needs to be added after the while loop finishes
+		Node<Key, Value>* prevNode;
+
+		// Create new node with keyValuePair's information
+		// Set Parent to NULL (Will be changed after we find where to
+		// insert in tree)
+		Node<Key, Value>* newNode = createNode(keyValuePair.first, keyValuePair.second, NULL);
+
+		// Number of nodes passed on the way down, which is the depth newNode ends up at
+		int depth = 0;
+
+		// While loop to find location to add newNode
+		while(currNode != NULL) {
+			++depth;
+
+			// If there is a duplicate entry
+			if (newNode->getKey() == currNode->getKey()) {
+				// Update currNode's value
+				currNode->setValue(newNode->getValue());
+
+				// newNode was never linked into the tree
+				destroyNode(newNode);
+				return;
+			}
+
+			// If new node is lesser than currNode
+			else if (newNode->getKey() < currNode->getKey()) {
+				// Save currNode
+				prevNode = currNode;
+				// Move to left child of currNode
+				currNode = currNode->getLeft();
+			}
 
 			// If new node is greater than currNode
 			else {
@@ -505,43 +1401,306 @@ void BinarySearchTree<Key, Value>::insert(const std::pair<Key, Value>& keyValueP
 			prevNode->setLeft(newNode);
 		}
 
-		// If newNode needs to be added as right child of prevNode
-		else {
-			prevNode->setRight(newNode);
-		}
-	}
-}
+		// If newNode needs to be added as right child of prevNode
+		else {
+			prevNode->setRight(newNode);
+		}
+
+		cacheInsertedNode(newNode);
+
+		// Rebuild the tree if the new node landed too deep
+		if (rebalanceNeeded(depth)) {
+			rebalance();
+		}
+	}
+}
+
+/**
+* Returns the node an iterator points at, or NULL for the end iterator.
+*/
+template<typename Key, typename Value>
+Node<Key, Value>* BinarySearchTree<Key, Value>::getNode(const iterator& it)
+{
+	return it.mCurrent;
+}
+
+/**
+* Returns the node a const_iterator points at, or NULL for the end iterator.
+*/
+template<typename Key, typename Value>
+Node<Key, Value>* BinarySearchTree<Key, Value>::getNode(const const_iterator& it)
+{
+	return const_cast<Node<Key, Value>*>(it.mCurrent);
+}
+
+/**
+* Allocates a new plain Node for insert.
+*/
+template<typename Key, typename Value>
+Node<Key, Value>* BinarySearchTree<Key, Value>::createNode(const Key& key, const Value& value, Node<Key, Value>* parent)
+{
+	return new Node<Key, Value>(key, value, parent);
+}
+
+/**
+* Frees a node allocated by createNode() or clone().
+*/
+template<typename Key, typename Value>
+void BinarySearchTree<Key, Value>::destroyNode(Node<Key, Value>* node)
+{
+	delete node;
+}
+
+/**
+* This function will implement BST Remove()
+*/
+template<typename Key, typename Value>
+void BinarySearchTree<Key, Value>::remove(const Key& key) {
+	// Do nothing if tree is empty
+	if (mRoot == NULL) {
+		return;
+	}
+
+	// Find node to delete
+	Node<Key, Value>* nodeToDelete = internalFind(key);
+
+	// If node to delete does not exist do nothing
+	if (nodeToDelete == NULL) {
+		return;
+	}
+
+	removeNode(nodeToDelete);
+}
+
+/**
+* Removes the item pos points at and returns an iterator to the item after it.
+* Removal relinks nodes rather than copying items between them, so the next
+* node stays valid.
+*/
+template<typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::iterator BinarySearchTree<Key, Value>::erase(iterator pos)
+{
+	// Nothing to erase
+	if (pos.mCurrent == NULL) {
+		return pos;
+	}
+
+	iterator next = pos;
+	++next;
+
+	removeNode(pos.mCurrent);
+
+	return next;
+}
+
+/**
+* Returns the smallest item in O(1).
+*/
+template<typename Key, typename Value>
+std::pair<Key, Value>& BinarySearchTree<Key, Value>::front()
+{
+	return mMin->getItem();
+}
+
+/**
+* Returns the largest item in O(1).
+*/
+template<typename Key, typename Value>
+std::pair<Key, Value>& BinarySearchTree<Key, Value>::back()
+{
+	return mMax->getItem();
+}
+
+/**
+* Returns the smallest item in O(1).
+*/
+template<typename Key, typename Value>
+const std::pair<Key, Value>& BinarySearchTree<Key, Value>::front() const
+{
+	return mMin->getItem();
+}
+
+/**
+* Returns the largest item in O(1).
+*/
+template<typename Key, typename Value>
+const std::pair<Key, Value>& BinarySearchTree<Key, Value>::back() const
+{
+	return mMax->getItem();
+}
+
+/**
+* Removes and returns the smallest item. The node is already known, so only the
+* unlinking (and any rebalancing) is paid for.
+*/
+template<typename Key, typename Value>
+std::pair<Key, Value> BinarySearchTree<Key, Value>::pop_min()
+{
+	std::pair<Key, Value> item = mMin->getItem();
+
+	removeNode(mMin);
+
+	return item;
+}
+
+/**
+* Removes and returns the largest item. The node is already known, so only the
+* unlinking (and any rebalancing) is paid for.
+*/
+template<typename Key, typename Value>
+std::pair<Key, Value> BinarySearchTree<Key, Value>::pop_max()
+{
+	std::pair<Key, Value> item = mMax->getItem();
+
+	removeNode(mMax);
+
+	return item;
+}
+
+/**
+* Unlinks and frees a node that is known to be in the tree. No keys are compared,
+* so callers that already hold the node do not need to search for it again.
+*/
+template<typename Key, typename Value>
+void BinarySearchTree<Key, Value>::removeNode(Node<Key, Value>* nodeToDelete) {
+
+	// Move the cached min/max off the node while it is still linked
+	uncacheRemovedNode(nodeToDelete);
+
+	// Check if node to delete is the root
+	if (nodeToDelete == mRoot) {
+		// If root has no children
+		if (nodeToDelete->getLeft() == NULL && nodeToDelete->getRight() == NULL) {
+			// Set mRoot to null
+			mRoot = NULL;
+
+			// Free allocated memory
+			destroyNode(nodeToDelete);
+		}
+
+		// If root has 2 children
+		else if (nodeToDelete->getLeft() != NULL && nodeToDelete->getRight() != NULL) {
+			// To store successor of nodeToDelete
+			Node<Key, Value>* successor = nodeToDelete->getRight();
+
+			while (successor->getLeft() != NULL) {
+				successor = successor->getLeft();
+			}
+
+			// If the right child has no left child
+			if (successor == nodeToDelete->getRight()) {
+				// Set successors left child to root's left child
+				successor->setLeft(nodeToDelete->getLeft());
+				// Set successor as nodeToDelete's left child's parent
+				nodeToDelete->getLeft()->setParent(successor);
+
+				// Set successor to NULL as it's the new root
+				successor->setParent(NULL);
+
+				// Set successor as the root
+				mRoot = successor;
+
+				// Free allocated memory
+				destroyNode(nodeToDelete);
+			}
+
+			// If successor has right child 
+			else if (successor->getRight() != NULL) {
+				// Set successor's right as it's parent's left
+				successor->getParent()->setLeft(successor->getRight());
+				// Set successor's right's parent as it's parent
+				successor->getRight()->setParent(successor->getParent());
+
+				// Set successor's left as root's left
+				successor->setLeft(nodeToDelete->getLeft());
+				// Set Successor as the parent of the left child of the root
+				nodeToDelete->getLeft()->setParent(successor);
+
+				// Set Successor's right to root's right
+				successor->setRight(nodeToDelete->getRight());
+				nodeToDelete->getRight()->setParent(successor);
+
+				// Set successor's parent to NULL
+				successor->setParent(NULL);
+
+				// Make successor the root
+				mRoot = successor;
+
+				// Free allocated memory
+				destroyNode(nodeToDelete);
+			}
+
+			// If successor is a leaf node
+			else {
+				// Set successor's parent's right to null
+				successor->getParent()->setLeft(NULL);
+				// Set successor's parent to null
+				successor->setParent(NULL);
+
+				// Update successor's left and right children
+				successor->setLeft(nodeToDelete->getLeft());
+				nodeToDelete->getLeft()->setParent(successor);
+
+				successor->setRight(nodeToDelete->getRight());
+				nodeToDelete->getRight()->setParent(successor);
+
+				// Make successor the root
+				mRoot = successor;
+
+				// Free allocated memory
+				destroyNode(nodeToDelete);
+			}
+		}
+
+		// If root has only one child
+		else {
+			// If root has only left child
+			if (nodeToDelete->getLeft() != NULL) {
+				// Set child of root's parent to null
+				nodeToDelete->getLeft()->setParent(NULL);
+
+				// Promote child of root
+				mRoot = nodeToDelete->getLeft();
+
+				// Free allocated memory
+				destroyNode(nodeToDelete);
+			}
 
-/**
-* This function will implement BST Remove()
-*/
-template<typename Key, typename Value>
-void BinarySearchTree<Key, Value>::remove(const Key& key) {
-	// Do nothing if tree is empty
-	if (mRoot == NULL) {
-		return;
-	}
+			// If root has only right child
+			else {
+				// Set child of root's parent to null
+				nodeToDelete->getRight()->setParent(NULL);
 
-	// Find node to delete
-	Node<Key, Value>* nodeToDelete = internalFind(key);
+				// Promote child of root
+				mRoot = nodeToDelete->getRight();
 
-	// If node to delete does not exist do nothing
-	if (nodeToDelete == NULL) {
-		return;
+				// Free allocated memory
+				destroyNode(nodeToDelete);
+			}
+		}
 	}
 
-	// Check if node to delete is the root
-	if (nodeToDelete == mRoot) {
-		// If root has no children
+	// If node to delete is not the root
+	else {
+		// If node to delete is a leaf node
 		if (nodeToDelete->getLeft() == NULL && nodeToDelete->getRight() == NULL) {
-			// Set mRoot to null
-			mRoot = NULL;
+			// If node to delete is left child
+			if (nodeToDelete->getParent()->getLeft() == nodeToDelete) {
+				// Remove node to delete from tree
+				nodeToDelete->getParent()->setLeft(NULL);
 
-			// Free allocated memory
-			delete nodeToDelete;
+				destroyNode(nodeToDelete);
+			}
+
+			// If node to delete is right child
+			else {
+				nodeToDelete->getParent()->setRight(NULL);
+
+				destroyNode(nodeToDelete);
+			}
 		}
 
-		// If root has 2 children
+		// If node to delete has 2 children
 		else if (nodeToDelete->getLeft() != NULL && nodeToDelete->getRight() != NULL) {
 			// To store successor of nodeToDelete
 			Node<Key, Value>* successor = nodeToDelete->getRight();
@@ -550,21 +1709,26 @@ void BinarySearchTree<Key, Value>::remove(const Key& key) {
 				successor = successor->getLeft();
 			}
 
-			// If the right child has no left child
+			// If the right child of node to delete has no left child
 			if (successor == nodeToDelete->getRight()) {
 				// Set successors left child to root's left child
 				successor->setLeft(nodeToDelete->getLeft());
 				// Set successor as nodeToDelete's left child's parent
 				nodeToDelete->getLeft()->setParent(successor);
 
-				// Set successor to NULL as it's the new root
-				successor->setParent(NULL);
+				successor->setParent(nodeToDelete->getParent());
 
-				// Set successor as the root
-				mRoot = successor;
+				// If nodeToDelete is the left child 
+				if (nodeToDelete->getParent()->getLeft() == nodeToDelete) {
+					nodeToDelete->getParent()->setLeft(successor);
+				}
 
-				// Free allocated memory
-				delete nodeToDelete;
+				// If nodeToDelete is the right child
+				else {
+					nodeToDelete->getParent()->setRight(successor);
+				}
+
+				destroyNode(nodeToDelete);
 			}
 
 			// If successor has right child 
@@ -574,31 +1738,35 @@ void BinarySearchTree<Key, Value>::remove(const Key& key) {
 				// Set successor's right's parent as it's parent
 				successor->getRight()->setParent(successor->getParent());
 
-				// Set successor's left as root's left
+				// Set successor's left as node to delete's left
 				successor->setLeft(nodeToDelete->getLeft());
-				// Set Successor as the parent of the left child of the root
+				// Set Successor as the parent of the left child of the NTD
 				nodeToDelete->getLeft()->setParent(successor);
 
 				// Set Successor's right to root's right
 				successor->setRight(nodeToDelete->getRight());
 				nodeToDelete->getRight()->setParent(successor);
 
-				// Set successor's parent to NULL
-				successor->setParent(NULL);
+				// Set successor's parent to node to delete's parent
+				successor->setParent(nodeToDelete->getParent());
 
-				// Make successor the root
-				mRoot = successor;
+				// If nodeToDelete is the left child 
+				if (nodeToDelete->getParent()->getLeft() == nodeToDelete) {
+					nodeToDelete->getParent()->setLeft(successor);
+				}
 
-				// Free allocated memory
-				delete nodeToDelete;
+				// If nodeToDelete is the right child
+				else {
+					nodeToDelete->getParent()->setRight(successor);
+				}
+
+				destroyNode(nodeToDelete);
 			}
 
 			// If successor is a leaf node
 			else {
-				// Set successor's parent's right to null
+				// Set successor's parent's left to null
 				successor->getParent()->setLeft(NULL);
-				// Set successor's parent to null
-				successor->setParent(NULL);
 
 				// Update successor's left and right children
 				successor->setLeft(nodeToDelete->getLeft());
@@ -607,236 +1775,532 @@ void BinarySearchTree<Key, Value>::remove(const Key& key) {
 				successor->setRight(nodeToDelete->getRight());
 				nodeToDelete->getRight()->setParent(successor);
 
-				// Make successor the root
-				mRoot = successor;
+				// Set successor's parent to NTD's parent
+				successor->setParent(nodeToDelete->getParent());
+
+				// If nodeToDelete is the left child 
+				if (nodeToDelete->getParent()->getLeft() == nodeToDelete) {
+					nodeToDelete->getParent()->setLeft(successor);
+				}
+
+				// If nodeToDelete is the right child
+				else {
+					nodeToDelete->getParent()->setRight(successor);
+				}
+
+				destroyNode(nodeToDelete);
+			}
+		}
+
+		// If node to delete has 1 child
+		else {
+			// If NTD has only left child
+			if (nodeToDelete->getLeft() != NULL) {
+				nodeToDelete->getLeft()->setParent(nodeToDelete->getParent());
+
+				// If nodeToDelete is the left child
+				if (nodeToDelete->getParent()->getLeft() == nodeToDelete) {
+					nodeToDelete->getParent()->setLeft(nodeToDelete->getLeft());
+				}
+
+				// If nodeToDelete is the right child
+				else {
+					nodeToDelete->getParent()->setRight(nodeToDelete->getLeft());
+				}
+
+				destroyNode(nodeToDelete);
+			}
+
+			// If NTD has only right child
+			else {
+				nodeToDelete->getRight()->setParent(nodeToDelete->getParent());
+
+				// If nodeToDelete is the left child
+				if (nodeToDelete->getParent()->getLeft() == nodeToDelete) {
+					nodeToDelete->getParent()->setLeft(nodeToDelete->getRight());
+				}
+
+				// If nodeToDelete is the right child
+				else {
+					nodeToDelete->getParent()->setRight(nodeToDelete->getRight());
+				}
+
+				destroyNode(nodeToDelete);
+			}
+		}
+	}
+}
+
+/**
+* A method to remove all contents of the tree and reset the values in the tree
+* for use again.
+*/
+template<typename Key, typename Value>
+void BinarySearchTree<Key, Value>::clear()
+{
+	deleteSubtree(mRoot);
+
+	// Tree is now empty
+	mRoot = NULL;
+	mMin = NULL;
+	mMax = NULL;
+	mNodeCount = 0;
+}
+
+/**
+* Frees every node in the subtree rooted at root in O(size) without using any
+* extra memory. The caller is responsible for unlinking root from its parent.
+*/
+template<typename Key, typename Value>
+void BinarySearchTree<Key, Value>::deleteSubtree(Node<Key, Value>* root)
+{
+	// If subtree is empty
+	if (root == NULL) {
+		return;
+	}
+
+	// The walk below climbs parent pointers until it passes root
+	root->setParent(NULL);
+
+	Node<Key, Value>* currNode = root;
+
+	// Delete all nodes in post-order so that a node is only freed after
+	// both of its children have been freed
+	while (currNode != NULL) {
+		// Descend into the left subtree first
+		if (currNode->getLeft() != NULL) {
+			currNode = currNode->getLeft();
+		}
+
+		// Then into the right subtree
+		else if (currNode->getRight() != NULL) {
+			currNode = currNode->getRight();
+		}
+
+		// currNode is a leaf so it can be freed
+		else {
+			Node<Key, Value>* parent = currNode->getParent();
+
+			// Unlink currNode from its parent
+			if (parent != NULL) {
+				if (parent->getLeft() == currNode) {
+					parent->setLeft(NULL);
+				}
+
+				else {
+					parent->setRight(NULL);
+				}
+			}
+
+			destroyNode(currNode);
+
+			currNode = parent;
+		}
+	}
+}
+
+/**
+* Copies the subtree rooted at root in O(size) without recursion, so degenerate
+* trees cannot overflow the stack. The source is walked in pre-order through its
+* parent pointers while the copy is walked in step with it.
+*/
+template<typename Key, typename Value>
+Node<Key, Value>* BinarySearchTree<Key, Value>::cloneSubtree(const Node<Key, Value>* root)
+{
+	// Empty subtree
+	if (root == NULL) {
+		return NULL;
+	}
+
+	Node<Key, Value>* copyRoot = root->clone(NULL);
+
+	const Node<Key, Value>* currNode = root;
+	Node<Key, Value>* currCopy = copyRoot;
+
+	while (true) {
+		// If the left subtree has not been copied yet, copy its root and go down
+		if (currNode->getLeft() != NULL && currCopy->getLeft() == NULL) {
+			currCopy->setLeft(currNode->getLeft()->clone(currCopy));
+
+			currNode = currNode->getLeft();
+			currCopy = currCopy->getLeft();
+		}
+
+		// If the right subtree has not been copied yet, copy its root and go down
+		else if (currNode->getRight() != NULL && currCopy->getRight() == NULL) {
+			currCopy->setRight(currNode->getRight()->clone(currCopy));
+
+			currNode = currNode->getRight();
+			currCopy = currCopy->getRight();
+		}
+
+		// Both subtrees are copied, go back up
+		else {
+			// Done once the subtree root is finished
+			if (currNode == root) {
+				break;
+			}
+
+			currNode = currNode->getParent();
+			currCopy = currCopy->getParent();
+		}
+	}
+
+	return copyRoot;
+}
+
+/**
+* Returns the smallest node in the tree, or NULL if it is empty.
+*/
+template<typename Key, typename Value>
+Node<Key, Value>* BinarySearchTree<Key, Value>::getSmallestNode() const
+{
+	return mMin;
+}
+
+/**
+* Returns the largest node in the tree, or NULL if it is empty.
+*/
+template<typename Key, typename Value>
+Node<Key, Value>* BinarySearchTree<Key, Value>::getLargestNode() const
+{
+	return mMax;
+}
+
+/**
+* Updates the node count and the cached smallest and largest nodes after newNode
+* has been linked into the tree.
+*/
+template<typename Key, typename Value>
+void BinarySearchTree<Key, Value>::cacheInsertedNode(Node<Key, Value>* newNode)
+{
+	++mNodeCount;
+
+	// If newNode is the first node it is both the smallest and the largest
+	if (mMin == NULL) {
+		mMin = newNode;
+		mMax = newNode;
+		return;
+	}
+
+	if (newNode->getKey() < mMin->getKey()) {
+		mMin = newNode;
+	}
+
+	if (mMax->getKey() < newNode->getKey()) {
+		mMax = newNode;
+	}
+}
+
+/**
+* Updates the node count and moves the cached smallest and largest nodes off a node
+* that is about to be unlinked. Must be called while the node is still in the tree.
+*/
+template<typename Key, typename Value>
+void BinarySearchTree<Key, Value>::uncacheRemovedNode(Node<Key, Value>* node)
+{
+	--mNodeCount;
+
+	if (node == mMin) {
+		mMin = node->getSuccessor();
+	}
+
+	if (node == mMax) {
+		mMax = node->getPredecessor();
+	}
+}
+
+/**
+* Rebuilds the tree into a complete tree in place with the Day-Stout-Warren
+* algorithm. The tree is first rotated into a chain of right children, then the
+* nodes that do not fit in a perfect tree are rotated off to form the bottom
+* level, and finally the chain is folded in half until it is one node long.
+* Runs in O(n) time with O(1) extra space, and every node keeps its address.
+*/
+template<typename Key, typename Value>
+void BinarySearchTree<Key, Value>::rebalance()
+{
+	// Nothing to reshape
+	if (mRoot == NULL) {
+		return;
+	}
+
+	rebalanceSubtree(mRoot);
 
-				// Free allocated memory
-				delete nodeToDelete;
-			}
-		}
+	rebuildNodeData();
+}
 
-		// If root has only one child
-		else {
-			// If root has only left child
-			if (nodeToDelete->getLeft() != NULL) {
-				// Set child of root's parent to null
-				nodeToDelete->getLeft()->setParent(NULL);
+/**
+* Rebuilds one subtree with the Day-Stout-Warren algorithm, see rebalance().
+* Nodes outside the subtree are not touched except for the link from root's
+* parent, which is pointed at the new subtree root.
+*/
+template<typename Key, typename Value>
+Node<Key, Value>* BinarySearchTree<Key, Value>::rebalanceSubtree(Node<Key, Value>* root)
+{
+	Node<Key, Value>* parent = root->getParent();
+	bool isLeft = (parent != NULL && parent->getLeft() == root);
 
-				// Promote child of root
-				mRoot = nodeToDelete->getLeft();
+	int count = treeToVine(root);
 
-				// Free allocated memory
-				delete nodeToDelete;
-			}
+	// Largest power of 2 not above count + 1
+	int full = 1;
 
-			// If root has only right child
-			else {
-				// Set child of root's parent to null
-				nodeToDelete->getRight()->setParent(NULL);
+	while (full * 2 <= count + 1) {
+		full *= 2;
+	}
 
-				// Promote child of root
-				mRoot = nodeToDelete->getRight();
+	// Rotate off the nodes of the partial bottom level
+	compressVine(root, count + 1 - full);
 
-				// Free allocated memory
-				delete nodeToDelete;
-			}
-		}
+	// The chain now holds the full - 1 nodes of a perfect tree
+	for (int spine = full - 1; spine > 1; ) {
+		spine /= 2;
+		compressVine(root, spine);
 	}
 
-	// If node to delete is not the root
-	else {
-		// If node to delete is a leaf node
-		if (nodeToDelete->getLeft() == NULL && nodeToDelete->getRight() == NULL) {
-			// If node to delete is left child
-			if (nodeToDelete->getParent()->getLeft() == nodeToDelete) {
-				// Remove node to delete from tree
-				nodeToDelete->getParent()->setLeft(NULL);
+	// Hang the rebuilt subtree where the old one was
+	if (parent == NULL) {
+		mRoot = root;
+	}
 
-				delete nodeToDelete;
-			}
+	else if (isLeft) {
+		parent->setLeft(root);
+	}
 
-			// If node to delete is right child
-			else {
-				nodeToDelete->getParent()->setRight(NULL);
+	else {
+		parent->setRight(root);
+	}
 
-				delete nodeToDelete;
-			}
-		}
+	return root;
+}
 
-		// If node to delete has 2 children
-		else if (nodeToDelete->getLeft() != NULL && nodeToDelete->getRight() != NULL) {
-			// To store successor of nodeToDelete
-			Node<Key, Value>* successor = nodeToDelete->getRight();
+/**
+* Sets how deep a node can land before insert calls rebalance(): when its depth
+* is above factor * log2(n). A factor of 0 disables the automatic rebalance. Has
+* no effect on the self-balancing trees.
+*/
+template<typename Key, typename Value>
+void BinarySearchTree<Key, Value>::setRebalanceFactor(double factor)
+{
+	mRebalanceFactor = factor;
+}
 
-			while (successor->getLeft() != NULL) {
-				successor = successor->getLeft();
-			}
+/**
+* Finds the smallest and largest nodes by walking the left and right spines.
+*/
+template<typename Key, typename Value>
+void BinarySearchTree<Key, Value>::recacheBounds()
+{
+	// If BST is empty
+	if (mRoot == NULL) {
+		mMin = NULL;
+		mMax = NULL;
+		return;
+	}
 
-			// If the right child of node to delete has no left child
-			if (successor == nodeToDelete->getRight()) {
-				// Set successors left child to root's left child
-				successor->setLeft(nodeToDelete->getLeft());
-				// Set successor as nodeToDelete's left child's parent
-				nodeToDelete->getLeft()->setParent(successor);
+	mMin = mRoot;
 
-				successor->setParent(nodeToDelete->getParent());
+	// Find the left-most(smallest) node
+	while (mMin->getLeft() != NULL) {
+		mMin = mMin->getLeft();
+	}
 
-				// If nodeToDelete is the left child 
-				if (nodeToDelete->getParent()->getLeft() == nodeToDelete) {
-					nodeToDelete->getParent()->setLeft(successor);
-				}
+	mMax = mRoot;
 
-				// If nodeToDelete is the right child
-				else {
-					nodeToDelete->getParent()->setRight(successor);
-				}
+	// Find the right-most(largest) node
+	while (mMax->getRight() != NULL) {
+		mMax = mMax->getRight();
+	}
+}
 
-				delete nodeToDelete;
-			}
+/**
+* Returns true if a node at the given depth (the root is at depth 0) is deep enough
+* for the automatic rebalance, which is when depth > factor * log2(n).
+*/
+template<typename Key, typename Value>
+bool BinarySearchTree<Key, Value>::rebalanceNeeded(int depth) const
+{
+	// Automatic rebalancing is off
+	if (mRebalanceFactor <= 0) {
+		return false;
+	}
 
-			// If successor has right child 
-			else if (successor->getRight() != NULL) {
-				// Set successor's right as it's parent's left
-				successor->getParent()->setLeft(successor->getRight());
-				// Set successor's right's parent as it's parent
-				successor->getRight()->setParent(successor->getParent());
+	return depth > mRebalanceFactor * std::log2(static_cast<double>(mNodeCount));
+}
 
-				// Set successor's left as node to delete's left
-				successor->setLeft(nodeToDelete->getLeft());
-				// Set Successor as the parent of the left child of the NTD
-				nodeToDelete->getLeft()->setParent(successor);
+/**
+* First step of rebalanceSubtree(). Rotates right at every node with a left child
+* while walking down the right spine, until the whole subtree is one chain of
+* right children in key order. Returns the number of nodes in the chain.
+*/
+template<typename Key, typename Value>
+int BinarySearchTree<Key, Value>::treeToVine(Node<Key, Value>*& root)
+{
+	// The subtree stays under the same parent
+	Node<Key, Value>* rootParent = root->getParent();
+
+	// Last node already in the chain, NULL while the root is still being rotated
+	Node<Key, Value>* tail = NULL;
+	Node<Key, Value>* rest = root;
+	int count = 0;
+
+	while (rest != NULL) {
+		// No left child, so rest is in place and the chain grows by one
+		if (rest->getLeft() == NULL) {
+			tail = rest;
+			rest = rest->getRight();
+			++count;
+		}
 
-				// Set Successor's right to root's right
-				successor->setRight(nodeToDelete->getRight());
-				nodeToDelete->getRight()->setParent(successor);
+		// Rotate right at rest, which moves its left child up into its place
+		else {
+			Node<Key, Value>* pivot = rest->getLeft();
 
-				// Set successor's parent to node to delete's parent
-				successor->setParent(nodeToDelete->getParent());
+			rest->setLeft(pivot->getRight());
 
-				// If nodeToDelete is the left child 
-				if (nodeToDelete->getParent()->getLeft() == nodeToDelete) {
-					nodeToDelete->getParent()->setLeft(successor);
-				}
+			if (pivot->getRight() != NULL) {
+				pivot->getRight()->setParent(rest);
+			}
 
-				// If nodeToDelete is the right child
-				else {
-					nodeToDelete->getParent()->setRight(successor);
-				}
+			pivot->setRight(rest);
+			rest->setParent(pivot);
 
-				delete nodeToDelete;
+			// Hang pivot where rest was
+			if (tail == NULL) {
+				pivot->setParent(rootParent);
+				root = pivot;
 			}
 
-			// If successor is a leaf node
 			else {
-				// Set successor's parent's left to null
-				successor->getParent()->setLeft(NULL);
+				pivot->setParent(tail);
+				tail->setRight(pivot);
+			}
 
-				// Update successor's left and right children
-				successor->setLeft(nodeToDelete->getLeft());
-				nodeToDelete->getLeft()->setParent(successor);
+			rest = pivot;
+		}
+	}
 
-				successor->setRight(nodeToDelete->getRight());
-				nodeToDelete->getRight()->setParent(successor);
+	return count;
+}
 
-				// Set successor's parent to NTD's parent
-				successor->setParent(nodeToDelete->getParent());
+/**
+* Step of rebalanceSubtree(). Performs count left rotations on every other node
+* down the right spine, starting at the root, which halves the length of the spine.
+*/
+template<typename Key, typename Value>
+void BinarySearchTree<Key, Value>::compressVine(Node<Key, Value>*& root, int count)
+{
+	// The subtree stays under the same parent
+	Node<Key, Value>* rootParent = root->getParent();
 
-				// If nodeToDelete is the left child 
-				if (nodeToDelete->getParent()->getLeft() == nodeToDelete) {
-					nodeToDelete->getParent()->setLeft(successor);
-				}
+	// Parent of the next node to rotate, NULL while that node is the root
+	Node<Key, Value>* scanner = NULL;
 
-				// If nodeToDelete is the right child
-				else {
-					nodeToDelete->getParent()->setRight(successor);
-				}
+	for (int i = 0; i < count; ++i) {
+		Node<Key, Value>* child = (scanner == NULL) ? root : scanner->getRight();
+		Node<Key, Value>* pivot = child->getRight();
 
-				delete nodeToDelete;
-			}
+		// Rotate left at child, which moves pivot up into its place
+		child->setRight(pivot->getLeft());
+
+		if (pivot->getLeft() != NULL) {
+			pivot->getLeft()->setParent(child);
+		}
+
+		pivot->setLeft(child);
+		child->setParent(pivot);
+
+		// Hang pivot where child was
+		if (scanner == NULL) {
+			pivot->setParent(rootParent);
+			root = pivot;
 		}
 
-		// If node to delete has 1 child
 		else {
-			// If NTD has only left child
-			if (nodeToDelete->getLeft() != NULL) {
-				nodeToDelete->getLeft()->setParent(nodeToDelete->getParent());
+			pivot->setParent(scanner);
+			scanner->setRight(pivot);
+		}
 
-				// If nodeToDelete is the left child
-				if (nodeToDelete->getParent()->getLeft() == nodeToDelete) {
-					nodeToDelete->getParent()->setLeft(nodeToDelete->getLeft());
-				}
+		// Skip over pivot to the next node on the spine
+		scanner = pivot;
+	}
+}
 
-				// If nodeToDelete is the right child
-				else {
-					nodeToDelete->getParent()->setRight(nodeToDelete->getLeft());
-				}
+/**
+* Recomputes node data after rebalance(). Plain trees store nothing derived from
+* their subtrees, so there is nothing to do.
+*/
+template<typename Key, typename Value>
+void BinarySearchTree<Key, Value>::rebuildNodeData()
+{
 
-				delete nodeToDelete;
-			}
+}
 
-			// If NTD has only right child
-			else {
-				nodeToDelete->getRight()->setParent(nodeToDelete->getParent());
+/**
+* Returns the first node of a post-order walk of the subtree at root: the deepest
+* node reached by going left whenever possible and right otherwise.
+*/
+template<typename Key, typename Value>
+Node<Key, Value>* BinarySearchTree<Key, Value>::getPostOrderFirst(Node<Key, Value>* root)
+{
+	// Empty subtree
+	if (root == NULL) {
+		return NULL;
+	}
 
-				// If nodeToDelete is the left child
-				if (nodeToDelete->getParent()->getLeft() == nodeToDelete) {
-					nodeToDelete->getParent()->setLeft(nodeToDelete->getRight());
-				}
+	while (true) {
+		if (root->getLeft() != NULL) {
+			root = root->getLeft();
+		}
 
-				// If nodeToDelete is the right child
-				else {
-					nodeToDelete->getParent()->setRight(nodeToDelete->getRight());
-				}
+		else if (root->getRight() != NULL) {
+			root = root->getRight();
+		}
 
-				delete nodeToDelete;
-			}
+		// A leaf has nothing below it left to visit
+		else {
+			return root;
 		}
 	}
 }
 
 /**
-* A method to remove all contents of the tree and reset the values in the tree
-* for use again.
+* Returns the node after node in a post-order walk, or NULL once the root is done.
 */
 template<typename Key, typename Value>
-void BinarySearchTree<Key, Value>::clear()
+Node<Key, Value>* BinarySearchTree<Key, Value>::getPostOrderNext(Node<Key, Value>* node)
 {
-	// Create iterator to traverse through the tree
-	BinarySearchTree<Key, Value>::iterator it = begin();
-
-	Node<Key, Value>* nodeToDelete;
+	Node<Key, Value>* parent = node->getParent();
 
-	// Delete all nodes in the BST
-	while (it != end()) {
-		// Get pointer to nodeToDelete
-		nodeToDelete = internalFind((*it).first);
+	// The root is visited last
+	if (parent == NULL) {
+		return NULL;
+	}
 
-		++it;
-		// Delete node
-		delete nodeToDelete;
+	// Coming up from the left, the right subtree still has to be visited
+	if (node == parent->getLeft() && parent->getRight() != NULL) {
+		return getPostOrderFirst(parent->getRight());
 	}
+
+	// Both subtrees of parent are done
+	return parent;
 }
 
 /**
-* A helper function to find the smallest node in the tree.
+* Helper function to find the nodes bounding the items equal to key. Keys are
+* unique, so the range holds at most one item.
 */
 template<typename Key, typename Value>
-Node<Key, Value>* BinarySearchTree<Key, Value>::getSmallestNode() const
+void BinarySearchTree<Key, Value>::internalEqualRange(const Key& key, Node<Key, Value>*& first, Node<Key, Value>*& last) const
 {
-	// If BST is empty
-	if (mRoot == NULL) {
-		return NULL;
-	}
-
-	Node<Key, Value>* currNode = mRoot;
+	first = internalCeiling(key, true);
+	last = first;
 
-	// Find the left-most(smallest) node
-	while (currNode->getLeft() != NULL) {
-		currNode = currNode->getLeft();
+	// If key is in the tree the range ends right after it
+	if (first != NULL && first->getKey() == key) {
+		last = first->getSuccessor();
 	}
-
-	// Return smallest node
-	return currNode;
 }
 
 /**
@@ -876,6 +2340,72 @@ Node<Key, Value>* BinarySearchTree<Key, Value>::internalFind(const Key& key) con
 	return NULL;
 }
 
+/**
+* Helper function to find the smallest node with a key greater than key, or equal
+* to key if inclusive is true. Returns NULL if no such node exists.
+*/
+template<typename Key, typename Value>
+Node<Key, Value>* BinarySearchTree<Key, Value>::internalCeiling(const Key& key, bool inclusive) const
+{
+	Node<Key, Value>* currNode = mRoot;
+
+	// Best candidate seen so far
+	Node<Key, Value>* bound = NULL;
+
+	while (currNode != NULL) {
+		// If currNode is a candidate, look for a smaller one on the left
+		if (key < currNode->getKey()) {
+			bound = currNode;
+			currNode = currNode->getLeft();
+		}
+
+		// An exact match cannot be beaten
+		else if (inclusive && currNode->getKey() == key) {
+			return currNode;
+		}
+
+		// Everything here and to the left is too small
+		else {
+			currNode = currNode->getRight();
+		}
+	}
+
+	return bound;
+}
+
+/**
+* Helper function to find the largest node with a key less than key, or equal
+* to key if inclusive is true. Returns NULL if no such node exists.
+*/
+template<typename Key, typename Value>
+Node<Key, Value>* BinarySearchTree<Key, Value>::internalFloor(const Key& key, bool inclusive) const
+{
+	Node<Key, Value>* currNode = mRoot;
+
+	// Best candidate seen so far
+	Node<Key, Value>* bound = NULL;
+
+	while (currNode != NULL) {
+		// If currNode is a candidate, look for a larger one on the right
+		if (currNode->getKey() < key) {
+			bound = currNode;
+			currNode = currNode->getRight();
+		}
+
+		// An exact match cannot be beaten
+		else if (inclusive && currNode->getKey() == key) {
+			return currNode;
+		}
+
+		// Everything here and to the right is too large
+		else {
+			currNode = currNode->getLeft();
+		}
+	}
+
+	return bound;
+}
+
 /**
 * Helper function to print the tree's contents
 */
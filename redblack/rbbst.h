@@ -0,0 +1,712 @@
+#ifndef RBBST_H
+#define RBBST_H
+
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include "../bst/bst.h"
+
+/**
+* The two colors of a red-black tree node. Scoped, so the names stay out of the
+* global namespace.
+*/
+enum class RBColor
+{
+	RED,
+	BLACK
+};
+
+/**
+* A special kind of node for a red-black tree, which adds the color as a data member.
+*/
+template <typename Key, typename Value>
+class RBNode : public Node<Key, Value>
+{
+public:
+	// Constructor/destructor. New nodes are red.
+	RBNode(const Key& key, const Value& value, RBNode<Key, Value>* parent);
+	virtual ~RBNode();
+
+	// Getter/setter for the node's color.
+	RBColor getColor() const;
+	void setColor(RBColor color);
+
+	// Getters for parent, left, and right. These need to be redefined since they
+	// return pointers to RBNodes - not plain Nodes.
+	virtual RBNode<Key, Value>* getParent() const override;
+	virtual RBNode<Key, Value>* getLeft() const override;
+	virtual RBNode<Key, Value>* getRight() const override;
+
+	// Copies the color as well as the item
+	virtual RBNode<Key, Value>* clone(Node<Key, Value>* parent) const override;
+
+protected:
+	RBColor mColor;
+};
+
+/*
+--------------------------------------------
+Begin implementations for the RBNode class.
+--------------------------------------------
+*/
+
+/**
+* Constructor for an RBNode. Nodes are initialized as red, which is the color
+* a newly inserted node gets.
+*/
+template<typename Key, typename Value>
+RBNode<Key, Value>::RBNode(const Key& key, const Value& value, RBNode<Key, Value>* parent)
+	: Node<Key, Value>(key, value, parent)
+	, mColor(RBColor::RED)
+{
+
+}
+
+/**
+* Destructor.
+*/
+template<typename Key, typename Value>
+RBNode<Key, Value>::~RBNode()
+{
+
+}
+
+/**
+* Getter function for the color.
+*/
+template<typename Key, typename Value>
+RBColor RBNode<Key, Value>::getColor() const
+{
+	return mColor;
+}
+
+/**
+* Setter function for the color.
+*/
+template<typename Key, typename Value>
+void RBNode<Key, Value>::setColor(RBColor color)
+{
+	mColor = color;
+}
+
+/**
+* Getter function for the parent. Used since the node inherits from a base node.
+*/
+template<typename Key, typename Value>
+RBNode<Key, Value>* RBNode<Key, Value>::getParent() const
+{
+	return static_cast<RBNode<Key, Value>*>(this->mParent);
+}
+
+/**
+* Getter function for the left child. Used since the node inherits from a base node.
+*/
+template<typename Key, typename Value>
+RBNode<Key, Value>* RBNode<Key, Value>::getLeft() const
+{
+	return static_cast<RBNode<Key, Value>*>(this->mLeft);
+}
+
+/**
+* Getter function for the right child. Used since the node inherits from a base node.
+*/
+template<typename Key, typename Value>
+RBNode<Key, Value>* RBNode<Key, Value>::getRight() const
+{
+	return static_cast<RBNode<Key, Value>*>(this->mRight);
+}
+
+/**
+* Allocates a copy of this node with the given parent and no children.
+*/
+template<typename Key, typename Value>
+RBNode<Key, Value>* RBNode<Key, Value>::clone(Node<Key, Value>* parent) const
+{
+	RBNode<Key, Value>* copy = new RBNode<Key, Value>(this->getKey(), this->getValue(), static_cast<RBNode<Key, Value>*>(parent));
+
+	copy->setColor(mColor);
+
+	return copy;
+}
+
+/*
+------------------------------------------
+End implementations for the RBNode class.
+------------------------------------------
+*/
+
+/**
+* A templated balanced binary search tree implemented as a red-black tree. The
+* tree is at most about twice as tall as a perfect tree, which is looser than an
+* AVL tree, but every insert does at most two rotations and every remove at most
+* three, so write heavy workloads spend less time restructuring.
+*/
+template <class Key, class Value>
+class RedBlackTree : public BinarySearchTree<Key, Value>
+{
+public:
+	RedBlackTree();
+
+	// Methods for inserting/removing elements from the tree
+	virtual void insert(const std::pair<Key, Value>& keyValuePair) override;
+	void remove(const Key& key);
+
+	typedef typename BinarySearchTree<Key, Value>::iterator iterator;
+	typedef typename BinarySearchTree<Key, Value>::const_iterator const_iterator;
+
+protected:
+	// Allocates an RBNode for insert
+	virtual RBNode<Key, Value>* createNode(const Key& key, const Value& value, Node<Key, Value>* parent) override;
+
+	// Unlinks a node and restores the red-black properties
+	virtual void removeNode(Node<Key, Value>* node) override;
+
+	// Recolors the complete tree left by rebalance()
+	virtual void rebuildNodeData() override;
+
+private:
+	// Rotations around x. Colors are left to the callers.
+	void rotateLeft(RBNode<Key, Value>* x);
+	void rotateRight(RBNode<Key, Value>* x);
+
+	// Puts newNode in place of oldNode under oldNode's parent
+	void transplant(RBNode<Key, Value>* oldNode, RBNode<Key, Value>* newNode);
+
+	// Fixes a red node with a red parent, starting at a newly inserted node
+	void insertFixup(RBNode<Key, Value>* node);
+
+	// Fixes the missing black on the path through node after a black node was
+	// removed. node may be NULL, so its parent is passed as well.
+	void removeFixup(RBNode<Key, Value>* node, RBNode<Key, Value>* parent);
+
+	// Returns true if node is red. NULL leaves are black.
+	static bool isRed(RBNode<Key, Value>* node);
+
+	RBNode<Key, Value>* getRoot() const;
+};
+
+/*
+--------------------------------------------
+Begin implementations for the RedBlackTree class.
+--------------------------------------------
+*/
+
+template<typename Key, typename Value>
+RedBlackTree<Key, Value>::RedBlackTree() {
+
+}
+
+/**
+* Allocates an RBNode for insert.
+*/
+template<typename Key, typename Value>
+RBNode<Key, Value>* RedBlackTree<Key, Value>::createNode(const Key& key, const Value& value, Node<Key, Value>* parent) {
+	return new RBNode<Key, Value>(key, value, static_cast<RBNode<Key, Value>*>(parent));
+}
+
+/**
+* Returns the root as an RBNode.
+*/
+template<typename Key, typename Value>
+RBNode<Key, Value>* RedBlackTree<Key, Value>::getRoot() const {
+	return static_cast<RBNode<Key, Value>*>(BinarySearchTree<Key, Value>::mRoot);
+}
+
+/**
+* Returns true if node is red. NULL leaves count as black.
+*/
+template<typename Key, typename Value>
+bool RedBlackTree<Key, Value>::isRed(RBNode<Key, Value>* node) {
+	return node != NULL && node->getColor() == RBColor::RED;
+}
+
+/**
+* Inserts a key value pair as a red leaf and then fixes any red node with a red
+* parent. A duplicate key updates the value without changing the tree.
+*/
+template<typename Key, typename Value>
+void RedBlackTree<Key, Value>::insert(const std::pair<Key, Value>& keyValuePair)
+{
+	RBNode<Key, Value>* parent = NULL;
+	RBNode<Key, Value>* currNode = getRoot();
+
+	// Find the leaf position for the key
+	while (currNode != NULL) {
+		// If there is a duplicate entry
+		if (keyValuePair.first == currNode->getKey()) {
+			// Update currNode's value
+			currNode->setValue(keyValuePair.second);
+			return;
+		}
+
+		parent = currNode;
+
+		// If key is less than currNode go to left child
+		if (keyValuePair.first < currNode->getKey()) {
+			currNode = currNode->getLeft();
+		}
+
+		// If key is greater than currNode go to right child
+		else {
+			currNode = currNode->getRight();
+		}
+	}
+
+	RBNode<Key, Value>* newNode = createNode(keyValuePair.first, keyValuePair.second, parent);
+
+	// If the tree was empty the new node is the root
+	if (parent == NULL) {
+		BinarySearchTree<Key, Value>::mRoot = newNode;
+	}
+
+	// If new node is lesser than parent
+	else if (newNode->getKey() < parent->getKey()) {
+		parent->setLeft(newNode);
+	}
+
+	// If new node is greater than parent
+	else {
+		parent->setRight(newNode);
+	}
+
+	BinarySearchTree<Key, Value>::cacheInsertedNode(newNode);
+
+	insertFixup(newNode);
+}
+
+/**
+* Walks up from a red node whose parent may also be red. A red uncle means the
+* grandparent's blackness can be pushed down to both its children and the problem
+* moves two levels up. A black uncle is fixed with one or two rotations, which
+* ends the walk.
+*/
+template<typename Key, typename Value>
+void RedBlackTree<Key, Value>::insertFixup(RBNode<Key, Value>* node)
+{
+	while (isRed(node->getParent())) {
+		RBNode<Key, Value>* parent = node->getParent();
+
+		// The parent is red so it is not the root and the grandparent exists
+		RBNode<Key, Value>* grandparent = parent->getParent();
+
+		// If parent is a left child
+		if (parent == grandparent->getLeft()) {
+			RBNode<Key, Value>* uncle = grandparent->getRight();
+
+			// Red uncle, so recolor and continue from the grandparent
+			if (isRed(uncle)) {
+				parent->setColor(RBColor::BLACK);
+				uncle->setColor(RBColor::BLACK);
+				grandparent->setColor(RBColor::RED);
+
+				node = grandparent;
+			}
+
+			else {
+				// If node is a right child, rotate it into the outer position first
+				if (node == parent->getRight()) {
+					rotateLeft(parent);
+
+					node = parent;
+					parent = node->getParent();
+				}
+
+				parent->setColor(RBColor::BLACK);
+				grandparent->setColor(RBColor::RED);
+
+				rotateRight(grandparent);
+			}
+		}
+
+		// If parent is a right child
+		else {
+			RBNode<Key, Value>* uncle = grandparent->getLeft();
+
+			// Red uncle, so recolor and continue from the grandparent
+			if (isRed(uncle)) {
+				parent->setColor(RBColor::BLACK);
+				uncle->setColor(RBColor::BLACK);
+				grandparent->setColor(RBColor::RED);
+
+				node = grandparent;
+			}
+
+			else {
+				// If node is a left child, rotate it into the outer position first
+				if (node == parent->getLeft()) {
+					rotateRight(parent);
+
+					node = parent;
+					parent = node->getParent();
+				}
+
+				parent->setColor(RBColor::BLACK);
+				grandparent->setColor(RBColor::RED);
+
+				rotateLeft(grandparent);
+			}
+		}
+	}
+
+	// The root is always black
+	getRoot()->setColor(RBColor::BLACK);
+}
+
+/**
+* Removes the node with the given key. Does nothing if the key is not in the tree.
+*/
+template<typename Key, typename Value>
+void RedBlackTree<Key, Value>::remove(const Key& key)
+{
+	Node<Key, Value>* nodeToDelete = BinarySearchTree<Key, Value>::internalFind(key);
+
+	// If node to delete does not exist do nothing
+	if (nodeToDelete == NULL) {
+		return;
+	}
+
+	removeNode(nodeToDelete);
+}
+
+/**
+* Unlinks a node that is known to be in the tree. A node with two children is
+* replaced by its successor, which takes over its position and color, so the
+* node that actually leaves its position has at most one child. If that node was
+* black, one path is now short a black node and removeFixup repairs it.
+*/
+template<typename Key, typename Value>
+void RedBlackTree<Key, Value>::removeNode(Node<Key, Value>* node)
+{
+	RBNode<Key, Value>* nodeToDelete = static_cast<RBNode<Key, Value>*>(node);
+
+	// Move the cached min/max off the node while it is still linked
+	BinarySearchTree<Key, Value>::uncacheRemovedNode(nodeToDelete);
+
+	// Color of the node that leaves its position
+	RBColor removedColor = nodeToDelete->getColor();
+
+	// The node that moves into the vacated position, and its new parent
+	RBNode<Key, Value>* child;
+	RBNode<Key, Value>* childParent;
+
+	// If there is no left child the right child moves up
+	if (nodeToDelete->getLeft() == NULL) {
+		child = nodeToDelete->getRight();
+		childParent = nodeToDelete->getParent();
+
+		transplant(nodeToDelete, child);
+	}
+
+	// If there is no right child the left child moves up
+	else if (nodeToDelete->getRight() == NULL) {
+		child = nodeToDelete->getLeft();
+		childParent = nodeToDelete->getParent();
+
+		transplant(nodeToDelete, child);
+	}
+
+	// Two children, so the successor takes nodeToDelete's place
+	else {
+		RBNode<Key, Value>* successor = nodeToDelete->getRight();
+
+		while (successor->getLeft() != NULL) {
+			successor = successor->getLeft();
+		}
+
+		removedColor = successor->getColor();
+		child = successor->getRight();
+
+		// If the successor is the right child it keeps its right subtree
+		if (successor->getParent() == nodeToDelete) {
+			childParent = successor;
+		}
+
+		// Otherwise its right subtree takes its place first
+		else {
+			childParent = successor->getParent();
+
+			transplant(successor, child);
+
+			successor->setRight(nodeToDelete->getRight());
+			successor->getRight()->setParent(successor);
+		}
+
+		transplant(nodeToDelete, successor);
+
+		successor->setLeft(nodeToDelete->getLeft());
+		successor->getLeft()->setParent(successor);
+		successor->setColor(nodeToDelete->getColor());
+	}
+
+	// Free allocated memory
+	this->destroyNode(nodeToDelete);
+
+	// Removing a red node does not change any black height
+	if (removedColor == RBColor::BLACK) {
+		removeFixup(child, childParent);
+	}
+}
+
+/**
+* Walks up from the position that lost a black node. A red node there simply
+* turns black. Otherwise the sibling's subtree is used: a red sibling is rotated
+* up so the sibling is black, a black sibling with black children turns red and
+* the problem moves up a level, and a black sibling with a red child is fixed
+* with one or two rotations, which ends the walk.
+*/
+template<typename Key, typename Value>
+void RedBlackTree<Key, Value>::removeFixup(RBNode<Key, Value>* node, RBNode<Key, Value>* parent)
+{
+	while (node != getRoot() && !isRed(node)) {
+		// If node is a left child
+		if (node == parent->getLeft()) {
+			// The path through the sibling has an extra black node, so it exists
+			RBNode<Key, Value>* sibling = parent->getRight();
+
+			// Red sibling, so rotate to get a black one
+			if (isRed(sibling)) {
+				sibling->setColor(RBColor::BLACK);
+				parent->setColor(RBColor::RED);
+
+				rotateLeft(parent);
+
+				sibling = parent->getRight();
+			}
+
+			// Black sibling with black children, so move the problem up
+			if (!isRed(sibling->getLeft()) && !isRed(sibling->getRight())) {
+				sibling->setColor(RBColor::RED);
+
+				node = parent;
+				parent = node->getParent();
+			}
+
+			else {
+				// If only the inner child is red, rotate it to the outside first
+				if (!isRed(sibling->getRight())) {
+					sibling->getLeft()->setColor(RBColor::BLACK);
+					sibling->setColor(RBColor::RED);
+
+					rotateRight(sibling);
+
+					sibling = parent->getRight();
+				}
+
+				sibling->setColor(parent->getColor());
+				parent->setColor(RBColor::BLACK);
+				sibling->getRight()->setColor(RBColor::BLACK);
+
+				rotateLeft(parent);
+
+				// Every path is fixed
+				node = getRoot();
+				parent = NULL;
+			}
+		}
+
+		// If node is a right child
+		else {
+			// The path through the sibling has an extra black node, so it exists
+			RBNode<Key, Value>* sibling = parent->getLeft();
+
+			// Red sibling, so rotate to get a black one
+			if (isRed(sibling)) {
+				sibling->setColor(RBColor::BLACK);
+				parent->setColor(RBColor::RED);
+
+				rotateRight(parent);
+
+				sibling = parent->getLeft();
+			}
+
+			// Black sibling with black children, so move the problem up
+			if (!isRed(sibling->getLeft()) && !isRed(sibling->getRight())) {
+				sibling->setColor(RBColor::RED);
+
+				node = parent;
+				parent = node->getParent();
+			}
+
+			else {
+				// If only the inner child is red, rotate it to the outside first
+				if (!isRed(sibling->getLeft())) {
+					sibling->getRight()->setColor(RBColor::BLACK);
+					sibling->setColor(RBColor::RED);
+
+					rotateLeft(sibling);
+
+					sibling = parent->getLeft();
+				}
+
+				sibling->setColor(parent->getColor());
+				parent->setColor(RBColor::BLACK);
+				sibling->getLeft()->setColor(RBColor::BLACK);
+
+				rotateRight(parent);
+
+				// Every path is fixed
+				node = getRoot();
+				parent = NULL;
+			}
+		}
+	}
+
+	// Absorb the missing black
+	if (node != NULL) {
+		node->setColor(RBColor::BLACK);
+	}
+}
+
+/**
+* Puts newNode (which may be NULL) in place of oldNode under oldNode's parent.
+* oldNode's own links are left for the caller.
+*/
+template<typename Key, typename Value>
+void RedBlackTree<Key, Value>::transplant(RBNode<Key, Value>* oldNode, RBNode<Key, Value>* newNode)
+{
+	RBNode<Key, Value>* parent = oldNode->getParent();
+
+	// If oldNode was the root
+	if (parent == NULL) {
+		BinarySearchTree<Key, Value>::mRoot = newNode;
+	}
+
+	// If oldNode was a left child
+	else if (oldNode == parent->getLeft()) {
+		parent->setLeft(newNode);
+	}
+
+	// If oldNode was a right child
+	else {
+		parent->setRight(newNode);
+	}
+
+	if (newNode != NULL) {
+		newNode->setParent(parent);
+	}
+}
+
+/**
+* Rotates x's right child up into x's place.
+*/
+template<typename Key, typename Value>
+void RedBlackTree<Key, Value>::rotateLeft(RBNode<Key, Value>* x)
+{
+	RBNode<Key, Value>* y = x->getRight();
+
+	// y's left subtree moves over to x
+	x->setRight(y->getLeft());
+
+	if (y->getLeft() != NULL) {
+		y->getLeft()->setParent(x);
+	}
+
+	// y takes x's place
+	transplant(x, y);
+
+	// x becomes y's left child
+	y->setLeft(x);
+	x->setParent(y);
+}
+
+/**
+* Rotates x's left child up into x's place.
+*/
+template<typename Key, typename Value>
+void RedBlackTree<Key, Value>::rotateRight(RBNode<Key, Value>* x)
+{
+	RBNode<Key, Value>* y = x->getLeft();
+
+	// y's right subtree moves over to x
+	x->setLeft(y->getRight());
+
+	if (y->getRight() != NULL) {
+		y->getRight()->setParent(x);
+	}
+
+	// y takes x's place
+	transplant(x, y);
+
+	// x becomes y's right child
+	y->setRight(x);
+	x->setParent(y);
+}
+
+/**
+* Colors the tree left by rebalance(). Every level of that tree is full except
+* possibly the deepest one, so coloring the nodes on a partial deepest level red
+* and everything else black gives every path the same number of black nodes. The
+* depth of each node is tracked during a walk through the parent pointers.
+*/
+template<typename Key, typename Value>
+void RedBlackTree<Key, Value>::rebuildNodeData()
+{
+	int count = BinarySearchTree<Key, Value>::mNodeCount;
+
+	// Depth of the deepest full level, and the size of the tree down to it
+	int fullDepth = 0;
+	int perfect = 1;
+
+	while (perfect * 2 + 1 <= count) {
+		perfect = perfect * 2 + 1;
+		++fullDepth;
+	}
+
+	// Nodes below the full levels are red. If there are none the tree is all black
+	bool partial = (perfect != count);
+
+	RBNode<Key, Value>* prevNode = NULL;
+	RBNode<Key, Value>* currNode = getRoot();
+	int depth = 0;
+
+	while (currNode != NULL) {
+		RBNode<Key, Value>* nextNode;
+
+		// Coming down from the parent, so currNode is visited now
+		if (prevNode == currNode->getParent()) {
+			currNode->setColor((partial && depth > fullDepth) ? RBColor::RED : RBColor::BLACK);
+
+			if (currNode->getLeft() != NULL) {
+				nextNode = currNode->getLeft();
+			}
+
+			else if (currNode->getRight() != NULL) {
+				nextNode = currNode->getRight();
+			}
+
+			else {
+				nextNode = currNode->getParent();
+			}
+		}
+
+		// Coming up from the left subtree
+		else if (prevNode == currNode->getLeft() && currNode->getRight() != NULL) {
+			nextNode = currNode->getRight();
+		}
+
+		// Both subtrees are done
+		else {
+			nextNode = currNode->getParent();
+		}
+
+		// Track the depth of nextNode
+		if (nextNode != NULL && nextNode == currNode->getParent()) {
+			--depth;
+		}
+
+		else {
+			++depth;
+		}
+
+		prevNode = currNode;
+		currNode = nextNode;
+	}
+}
+
+/*
+------------------------------------------
+End implementations for the RedBlackTree class.
+------------------------------------------
+*/
+
+#endif
@@ -0,0 +1,275 @@
+#ifndef SCAPEGOAT_H
+#define SCAPEGOAT_H
+
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <cmath>
+#include <algorithm>
+#include "../bst/bst.h"
+
+/**
+* A templated balanced binary search tree implemented as a scapegoat tree. Nodes are
+* plain BinarySearchTree nodes with no height, size or color, so the tree uses the
+* least memory per item of the balanced trees. Balance is restored only when an
+* insert lands deeper than log(n) / log(1 / alpha): the lowest ancestor whose
+* subtree is out of alpha-weight balance (the scapegoat) is rebuilt into a complete
+* subtree in O(size). A remove rebuilds the whole tree once enough items have been
+* removed since the last full rebuild. Both are O(log n) amortized.
+*/
+template <class Key, class Value>
+class ScapegoatTree : public BinarySearchTree<Key, Value>
+{
+public:
+	ScapegoatTree();
+
+	// Methods for inserting/removing elements from the tree
+	virtual void insert(const std::pair<Key, Value>& keyValuePair) override;
+	void remove(const Key& key);
+	virtual void clear() override;
+
+	typedef typename BinarySearchTree<Key, Value>::iterator iterator;
+	typedef typename BinarySearchTree<Key, Value>::const_iterator const_iterator;
+
+	// Returns the number of items in O(1)
+	int size() const;
+
+	// Sets the balance factor, between 0.5 and 1. A subtree is rebuilt when one
+	// child holds more than alpha of its nodes. Lower values keep the tree shorter
+	// at the cost of more rebuilding. Defaults to 0.7.
+	void setAlpha(double alpha);
+
+protected:
+	// Unlinks a node and rebuilds the tree if it has shrunk enough
+	virtual void removeNode(Node<Key, Value>* node) override;
+
+private:
+	// Returns the deepest depth allowed for a tree of the given size
+	int depthLimit(int count) const;
+
+	// Climbs from a newly inserted node to the lowest unbalanced ancestor
+	Node<Key, Value>* findScapegoat(Node<Key, Value>* newNode) const;
+
+	// Counts the nodes of a subtree in O(size)
+	static int countSubtree(Node<Key, Value>* root);
+
+	double mAlpha;
+
+	// Largest size since the tree was last rebuilt as a whole
+	int mMaxNodeCount;
+};
+
+/*
+--------------------------------------------
+Begin implementations for the ScapegoatTree class.
+--------------------------------------------
+*/
+
+template<typename Key, typename Value>
+ScapegoatTree<Key, Value>::ScapegoatTree()
+	: mAlpha(0.7)
+	, mMaxNodeCount(0)
+{
+
+}
+
+/**
+* Sets the balance factor, clamped to [0.55, 0.95]. Near 0.5 almost every insert
+* would rebuild, and near 1 the tree could grow very tall before rebuilding.
+*/
+template<typename Key, typename Value>
+void ScapegoatTree<Key, Value>::setAlpha(double alpha)
+{
+	mAlpha = std::min(std::max(alpha, 0.55), 0.95);
+}
+
+/**
+* Returns the number of items in O(1).
+*/
+template<typename Key, typename Value>
+int ScapegoatTree<Key, Value>::size() const
+{
+	return BinarySearchTree<Key, Value>::mNodeCount;
+}
+
+/**
+* Removes every item and resets the rebuild bookkeeping.
+*/
+template<typename Key, typename Value>
+void ScapegoatTree<Key, Value>::clear()
+{
+	BinarySearchTree<Key, Value>::clear();
+
+	mMaxNodeCount = 0;
+}
+
+/**
+* Returns floor(log(count) / log(1 / alpha)), the deepest a node may be in a
+* balanced tree of count nodes.
+*/
+template<typename Key, typename Value>
+int ScapegoatTree<Key, Value>::depthLimit(int count) const
+{
+	return static_cast<int>(std::floor(std::log(static_cast<double>(count)) / std::log(1.0 / mAlpha)));
+}
+
+/**
+* Counts the nodes of the subtree at root with a post-order walk, which visits
+* root last.
+*/
+template<typename Key, typename Value>
+int ScapegoatTree<Key, Value>::countSubtree(Node<Key, Value>* root)
+{
+	// Empty subtree
+	if (root == NULL) {
+		return 0;
+	}
+
+	int count = 1;
+
+	for (Node<Key, Value>* currNode = BinarySearchTree<Key, Value>::getPostOrderFirst(root); currNode != root;
+		currNode = BinarySearchTree<Key, Value>::getPostOrderNext(currNode)) {
+		++count;
+	}
+
+	return count;
+}
+
+/**
+* Inserts a key value pair as a leaf. If the leaf is deeper than the depth limit,
+* the subtree at its scapegoat is rebuilt. A duplicate key updates the value
+* without changing the tree.
+*/
+template<typename Key, typename Value>
+void ScapegoatTree<Key, Value>::insert(const std::pair<Key, Value>& keyValuePair)
+{
+	Node<Key, Value>* parent = NULL;
+	Node<Key, Value>* currNode = BinarySearchTree<Key, Value>::mRoot;
+
+	// Depth the new node ends up at
+	int depth = 0;
+
+	// Find the leaf position for the key
+	while (currNode != NULL) {
+		// If there is a duplicate entry
+		if (keyValuePair.first == currNode->getKey()) {
+			// Update currNode's value
+			currNode->setValue(keyValuePair.second);
+			return;
+		}
+
+		parent = currNode;
+		++depth;
+
+		// If key is less than currNode go to left child
+		if (keyValuePair.first < currNode->getKey()) {
+			currNode = currNode->getLeft();
+		}
+
+		// If key is greater than currNode go to right child
+		else {
+			currNode = currNode->getRight();
+		}
+	}
+
+	Node<Key, Value>* newNode = BinarySearchTree<Key, Value>::createNode(keyValuePair.first, keyValuePair.second, parent);
+
+	// If the tree was empty the new node is the root
+	if (parent == NULL) {
+		BinarySearchTree<Key, Value>::mRoot = newNode;
+	}
+
+	// If new node is lesser than parent
+	else if (newNode->getKey() < parent->getKey()) {
+		parent->setLeft(newNode);
+	}
+
+	// If new node is greater than parent
+	else {
+		parent->setRight(newNode);
+	}
+
+	BinarySearchTree<Key, Value>::cacheInsertedNode(newNode);
+
+	mMaxNodeCount = std::max(mMaxNodeCount, BinarySearchTree<Key, Value>::mNodeCount);
+
+	// Rebuild the scapegoat's subtree if the new node is too deep
+	if (depth > depthLimit(BinarySearchTree<Key, Value>::mNodeCount)) {
+		Node<Key, Value>* scapegoat = findScapegoat(newNode);
+
+		if (scapegoat != NULL) {
+			BinarySearchTree<Key, Value>::rebalanceSubtree(scapegoat);
+		}
+	}
+}
+
+/**
+* Walks up from a new node that is too deep, keeping the size of the subtree it
+* came from, until it reaches an ancestor with one child holding more than alpha
+* of its nodes. A node that deep always has such an ancestor. Each step counts
+* the nodes of the sibling subtree, so the walk costs O(size of the scapegoat).
+*/
+template<typename Key, typename Value>
+Node<Key, Value>* ScapegoatTree<Key, Value>::findScapegoat(Node<Key, Value>* newNode) const
+{
+	Node<Key, Value>* child = newNode;
+	int childSize = 1;
+
+	while (child->getParent() != NULL) {
+		Node<Key, Value>* parent = child->getParent();
+		Node<Key, Value>* sibling = (child == parent->getLeft()) ? parent->getRight() : parent->getLeft();
+
+		int parentSize = childSize + countSubtree(sibling) + 1;
+
+		// child is too heavy for parent
+		if (childSize > mAlpha * parentSize) {
+			return parent;
+		}
+
+		child = parent;
+		childSize = parentSize;
+	}
+
+	return NULL;
+}
+
+/**
+* Removes the node with the given key. Does nothing if the key is not in the tree.
+*/
+template<typename Key, typename Value>
+void ScapegoatTree<Key, Value>::remove(const Key& key)
+{
+	Node<Key, Value>* nodeToDelete = BinarySearchTree<Key, Value>::internalFind(key);
+
+	// If node to delete does not exist do nothing
+	if (nodeToDelete == NULL) {
+		return;
+	}
+
+	removeNode(nodeToDelete);
+}
+
+/**
+* Unlinks a node like a plain BinarySearchTree. Once the tree has fewer than
+* alpha times the nodes it had at its largest, the whole tree is rebuilt.
+*/
+template<typename Key, typename Value>
+void ScapegoatTree<Key, Value>::removeNode(Node<Key, Value>* node)
+{
+	BinarySearchTree<Key, Value>::removeNode(node);
+
+	// Rebuild the whole tree once enough nodes are gone
+	if (BinarySearchTree<Key, Value>::mNodeCount < mAlpha * mMaxNodeCount) {
+		BinarySearchTree<Key, Value>::rebalance();
+
+		mMaxNodeCount = BinarySearchTree<Key, Value>::mNodeCount;
+	}
+}
+
+/*
+------------------------------------------
+End implementations for the ScapegoatTree class.
+------------------------------------------
+*/
+
+#endif
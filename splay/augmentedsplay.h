@@ -0,0 +1,431 @@
+#ifndef AUGMENTEDSPLAY_H
+#define AUGMENTEDSPLAY_H
+
+#include "splay.h"
+#include "../bst/augment.h"
+
+/**
+* A Node that also stores the combined summary of every item in its subtree.
+*/
+template <typename Key, typename Value, typename Summary>
+class AugmentedSplayNode : public Node<Key, Value>
+{
+public:
+	AugmentedSplayNode(const Key& key, const Value& value, Node<Key, Value>* parent, const Summary& summary);
+	virtual ~AugmentedSplayNode();
+
+	const Summary& getSummary() const;
+	void setSummary(const Summary& summary);
+
+	// Copies the summary as well as the data the base node copies
+	virtual AugmentedSplayNode<Key, Value, Summary>* clone(Node<Key, Value>* parent) const override;
+
+protected:
+	Summary mSummary;
+};
+
+/*
+--------------------------------------------
+Begin implementations for the AugmentedSplayNode class.
+--------------------------------------------
+*/
+
+/**
+* Constructor for an AugmentedSplayNode. A new node is a leaf, so its summary is the
+* summary of its own item.
+*/
+template<typename Key, typename Value, typename Summary>
+AugmentedSplayNode<Key, Value, Summary>::AugmentedSplayNode(const Key& key, const Value& value, Node<Key, Value>* parent, const Summary& summary)
+	: Node<Key, Value>(key, value, parent)
+	, mSummary(summary)
+{
+
+}
+
+/**
+* Destructor.
+*/
+template<typename Key, typename Value, typename Summary>
+AugmentedSplayNode<Key, Value, Summary>::~AugmentedSplayNode()
+{
+
+}
+
+/**
+* Getter function for the subtree summary.
+*/
+template<typename Key, typename Value, typename Summary>
+const Summary& AugmentedSplayNode<Key, Value, Summary>::getSummary() const
+{
+	return mSummary;
+}
+
+/**
+* Setter function for the subtree summary.
+*/
+template<typename Key, typename Value, typename Summary>
+void AugmentedSplayNode<Key, Value, Summary>::setSummary(const Summary& summary)
+{
+	mSummary = summary;
+}
+
+/**
+* Allocates a copy of this node with the given parent and no children.
+*/
+template<typename Key, typename Value, typename Summary>
+AugmentedSplayNode<Key, Value, Summary>* AugmentedSplayNode<Key, Value, Summary>::clone(Node<Key, Value>* parent) const
+{
+	return new AugmentedSplayNode<Key, Value, Summary>(this->getKey(), this->getValue(), parent, mSummary);
+}
+
+/*
+------------------------------------------
+End implementations for the AugmentedSplayNode class.
+------------------------------------------
+*/
+
+/**
+* A splay tree where every node stores the Monoid summary of its subtree. See augment.h
+* for the Monoid policy requirements. Every structural change of a splay tree ends with
+* the touched node being splayed to the root, so recomputing the rotated nodes in each
+* splay step keeps all summaries up to date. Queries do not splay, so they cost O(depth).
+*
+* A value written behind the tree's back would leave the summaries above it stale,
+* so the tree only hands out const access to its items. The functions below hide
+* the ones from SplayTree that return iterators or references that can write, and
+* values are changed through insert or modify().
+*/
+template <class Key, class Value, class Monoid>
+class AugmentedSplayTree : public SplayTree<Key, Value>
+{
+public:
+	typedef typename Monoid::Summary Summary;
+	typedef typename SplayTree<Key, Value>::const_iterator const_iterator;
+	typedef typename SplayTree<Key, Value>::const_reverse_iterator const_reverse_iterator;
+	typedef typename SplayTree<Key, Value>::const_range_view const_range_view;
+
+	// Returns the combined summary of all items with lo <= key < hi. It does not
+	// splay, so it costs O(depth), which is O(n) when the tree has become a path,
+	// as it does after inserting keys in sorted order.
+	Summary aggregate(const Key& lo, const Key& hi) const;
+
+	// Returns the combined summary of every item in the tree
+	Summary total() const;
+
+	// Splays the node holding key to the root, calls fn with its value and
+	// recomputes its summary, which is the only one that includes the value.
+	// Amortized O(log n). Returns false, without calling fn, if key is not in the
+	// tree.
+	template <typename Function>
+	bool modify(const Key& key, Function fn);
+
+	// The same as in SplayTree, but taking and returning const_iterators. A splay
+	// insert always searches from the root and leaves the item at the root, so the
+	// hint is not used.
+	virtual void insert(const std::pair<Key, Value>& keyValuePair) override;
+	const_iterator insert(const_iterator hint, const std::pair<Key, Value>& keyValuePair);
+	const_iterator erase(const_iterator pos);
+
+	// Read only access to the items
+	const_iterator begin() const;
+	const_iterator end() const;
+	const_reverse_iterator rbegin() const;
+	const_reverse_iterator rend() const;
+	const_iterator find(const Key& key) const;
+	std::pair<const_iterator, const_iterator> equal_range(const Key& key) const;
+	const_iterator predecessor(const Key& key) const;
+	const_iterator successor(const Key& key) const;
+	const std::pair<Key, Value>& front() const;
+	const std::pair<Key, Value>& back() const;
+
+	// Ordered searches. On a non-const tree these splay the node they return when
+	// setSplayBounds() is on, as in SplayTree; the const versions never splay.
+	const_iterator lower_bound(const Key& key);
+	const_iterator upper_bound(const Key& key);
+	const_iterator floor(const Key& key);
+	const_iterator ceiling(const Key& key);
+	const_range_view range(const Key& lo, const Key& hi);
+	const_iterator lower_bound(const Key& key) const;
+	const_iterator upper_bound(const Key& key) const;
+	const_iterator floor(const Key& key) const;
+	const_iterator ceiling(const Key& key) const;
+	const_range_view range(const Key& lo, const Key& hi) const;
+
+protected:
+	typedef AugmentedSplayNode<Key, Value, Summary> NodeType;
+
+	virtual NodeType* createNode(const Key& key, const Value& value, Node<Key, Value>* parent) override;
+	virtual void updateNode(Node<Key, Value>* node) override;
+};
+
+/*
+--------------------------------------------
+Begin implementations for the AugmentedSplayTree class.
+--------------------------------------------
+*/
+
+/**
+* Allocates a node that carries a summary.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedSplayTree<Key, Value, Monoid>::NodeType* AugmentedSplayTree<Key, Value, Monoid>::createNode(const Key& key, const Value& value, Node<Key, Value>* parent) {
+	return new NodeType(key, value, parent, Monoid::fromItem(key, value));
+}
+
+/**
+* Recomputes the summary of a node from its children.
+*/
+template<typename Key, typename Value, typename Monoid>
+void AugmentedSplayTree<Key, Value, Monoid>::updateNode(Node<Key, Value>* node) {
+	NodeType* augmentedNode = static_cast<NodeType*>(node);
+
+	Summary leftSummary = subtreeSummary<Monoid>(static_cast<NodeType*>(node->getLeft()));
+	Summary rightSummary = subtreeSummary<Monoid>(static_cast<NodeType*>(node->getRight()));
+
+	augmentedNode->setSummary(Monoid::combine(Monoid::combine(leftSummary,
+		Monoid::fromItem(node->getKey(), node->getValue())), rightSummary));
+}
+
+/**
+* Returns the combined summary of all items with lo <= key < hi in O(depth).
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedSplayTree<Key, Value, Monoid>::Summary AugmentedSplayTree<Key, Value, Monoid>::aggregate(const Key& lo, const Key& hi) const {
+	return aggregateRange<Monoid>(static_cast<NodeType*>(BinarySearchTree<Key, Value>::mRoot), lo, hi);
+}
+
+/**
+* Returns the combined summary of every item in the tree in O(1).
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedSplayTree<Key, Value, Monoid>::Summary AugmentedSplayTree<Key, Value, Monoid>::total() const {
+	return subtreeSummary<Monoid>(static_cast<NodeType*>(BinarySearchTree<Key, Value>::mRoot));
+}
+
+/**
+* Changes the value under key in place and brings the summaries back up to date.
+*/
+template<typename Key, typename Value, typename Monoid>
+template<typename Function>
+bool AugmentedSplayTree<Key, Value, Monoid>::modify(const Key& key, Function fn) {
+	Node<Key, Value>* node = BinarySearchTree<Key, Value>::internalFind(key);
+
+	// If key is not in the tree
+	if (node == NULL) {
+		return false;
+	}
+
+	// At the root no other summary includes the value
+	this->splay(node);
+
+	fn(node->getValue());
+
+	updateNode(node);
+
+	return true;
+}
+
+/**
+* Inserts keyValuePair, or replaces the value of its key, as SplayTree does.
+*/
+template<typename Key, typename Value, typename Monoid>
+void AugmentedSplayTree<Key, Value, Monoid>::insert(const std::pair<Key, Value>& keyValuePair) {
+	SplayTree<Key, Value>::insert(keyValuePair);
+}
+
+/**
+* Inserts keyValuePair and returns a const_iterator to it. The hint is not used.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedSplayTree<Key, Value, Monoid>::const_iterator AugmentedSplayTree<Key, Value, Monoid>::insert(const_iterator hint, const std::pair<Key, Value>& keyValuePair) {
+	SplayTree<Key, Value>::insert(keyValuePair);
+
+	// The item was splayed to the root
+	return const_iterator(BinarySearchTree<Key, Value>::mRoot, this);
+}
+
+/**
+* Removes the item at pos and returns a const_iterator to the next item.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedSplayTree<Key, Value, Monoid>::const_iterator AugmentedSplayTree<Key, Value, Monoid>::erase(const_iterator pos) {
+	typename SplayTree<Key, Value>::iterator writablePos(BinarySearchTree<Key, Value>::getNode(pos), this);
+
+	return SplayTree<Key, Value>::erase(writablePos);
+}
+
+/**
+* Returns a const_iterator to the smallest item.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedSplayTree<Key, Value, Monoid>::const_iterator AugmentedSplayTree<Key, Value, Monoid>::begin() const {
+	return SplayTree<Key, Value>::begin();
+}
+
+/**
+* Returns the end const_iterator.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedSplayTree<Key, Value, Monoid>::const_iterator AugmentedSplayTree<Key, Value, Monoid>::end() const {
+	return SplayTree<Key, Value>::end();
+}
+
+/**
+* Returns a reverse iterator to the largest item.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedSplayTree<Key, Value, Monoid>::const_reverse_iterator AugmentedSplayTree<Key, Value, Monoid>::rbegin() const {
+	return SplayTree<Key, Value>::rbegin();
+}
+
+/**
+* Returns the end reverse iterator.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedSplayTree<Key, Value, Monoid>::const_reverse_iterator AugmentedSplayTree<Key, Value, Monoid>::rend() const {
+	return SplayTree<Key, Value>::rend();
+}
+
+/**
+* Returns a const_iterator to the item with the given key, or end().
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedSplayTree<Key, Value, Monoid>::const_iterator AugmentedSplayTree<Key, Value, Monoid>::find(const Key& key) const {
+	return SplayTree<Key, Value>::find(key);
+}
+
+/**
+* Returns the items equal to key as [first, second).
+*/
+template<typename Key, typename Value, typename Monoid>
+std::pair<typename AugmentedSplayTree<Key, Value, Monoid>::const_iterator, typename AugmentedSplayTree<Key, Value, Monoid>::const_iterator>
+AugmentedSplayTree<Key, Value, Monoid>::equal_range(const Key& key) const {
+	return SplayTree<Key, Value>::equal_range(key);
+}
+
+/**
+* Returns a const_iterator to the last item whose key is less than key.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedSplayTree<Key, Value, Monoid>::const_iterator AugmentedSplayTree<Key, Value, Monoid>::predecessor(const Key& key) const {
+	return SplayTree<Key, Value>::predecessor(key);
+}
+
+/**
+* Returns a const_iterator to the first item whose key is greater than key.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedSplayTree<Key, Value, Monoid>::const_iterator AugmentedSplayTree<Key, Value, Monoid>::successor(const Key& key) const {
+	return SplayTree<Key, Value>::successor(key);
+}
+
+/**
+* Returns the smallest item. The tree must not be empty.
+*/
+template<typename Key, typename Value, typename Monoid>
+const std::pair<Key, Value>& AugmentedSplayTree<Key, Value, Monoid>::front() const {
+	return SplayTree<Key, Value>::front();
+}
+
+/**
+* Returns the largest item. The tree must not be empty.
+*/
+template<typename Key, typename Value, typename Monoid>
+const std::pair<Key, Value>& AugmentedSplayTree<Key, Value, Monoid>::back() const {
+	return SplayTree<Key, Value>::back();
+}
+
+/**
+* Returns a const_iterator to the first item whose key is not less than key,
+* splaying it if enabled.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedSplayTree<Key, Value, Monoid>::const_iterator AugmentedSplayTree<Key, Value, Monoid>::lower_bound(const Key& key) {
+	return SplayTree<Key, Value>::lower_bound(key);
+}
+
+/**
+* Returns a const_iterator to the first item whose key is greater than key,
+* splaying it if enabled.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedSplayTree<Key, Value, Monoid>::const_iterator AugmentedSplayTree<Key, Value, Monoid>::upper_bound(const Key& key) {
+	return SplayTree<Key, Value>::upper_bound(key);
+}
+
+/**
+* Returns a const_iterator to the last item whose key is not greater than key,
+* splaying it if enabled.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedSplayTree<Key, Value, Monoid>::const_iterator AugmentedSplayTree<Key, Value, Monoid>::floor(const Key& key) {
+	return SplayTree<Key, Value>::floor(key);
+}
+
+/**
+* Returns a const_iterator to the first item whose key is not less than key,
+* splaying it if enabled.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedSplayTree<Key, Value, Monoid>::const_iterator AugmentedSplayTree<Key, Value, Monoid>::ceiling(const Key& key) {
+	return SplayTree<Key, Value>::ceiling(key);
+}
+
+/**
+* Returns a read only view over the items with lo <= key < hi, splaying the lower
+* boundary if enabled.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedSplayTree<Key, Value, Monoid>::const_range_view AugmentedSplayTree<Key, Value, Monoid>::range(const Key& lo, const Key& hi) {
+	typename SplayTree<Key, Value>::range_view view = SplayTree<Key, Value>::range(lo, hi);
+
+	return const_range_view(view.begin(), view.end());
+}
+
+/**
+* Returns a const_iterator to the first item whose key is not less than key.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedSplayTree<Key, Value, Monoid>::const_iterator AugmentedSplayTree<Key, Value, Monoid>::lower_bound(const Key& key) const {
+	return SplayTree<Key, Value>::lower_bound(key);
+}
+
+/**
+* Returns a const_iterator to the first item whose key is greater than key.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedSplayTree<Key, Value, Monoid>::const_iterator AugmentedSplayTree<Key, Value, Monoid>::upper_bound(const Key& key) const {
+	return SplayTree<Key, Value>::upper_bound(key);
+}
+
+/**
+* Returns a const_iterator to the last item whose key is not greater than key.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedSplayTree<Key, Value, Monoid>::const_iterator AugmentedSplayTree<Key, Value, Monoid>::floor(const Key& key) const {
+	return SplayTree<Key, Value>::floor(key);
+}
+
+/**
+* Returns a const_iterator to the first item whose key is not less than key.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedSplayTree<Key, Value, Monoid>::const_iterator AugmentedSplayTree<Key, Value, Monoid>::ceiling(const Key& key) const {
+	return SplayTree<Key, Value>::ceiling(key);
+}
+
+/**
+* Returns a read only view over the items with lo <= key < hi.
+*/
+template<typename Key, typename Value, typename Monoid>
+typename AugmentedSplayTree<Key, Value, Monoid>::const_range_view AugmentedSplayTree<Key, Value, Monoid>::range(const Key& lo, const Key& hi) const {
+	return SplayTree<Key, Value>::range(lo, hi);
+}
+
+/*
+------------------------------------------
+End implementations for the AugmentedSplayTree class.
+------------------------------------------
+*/
+
+#endif
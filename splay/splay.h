@@ -17,10 +17,52 @@ public:
 	// Methods for inserting/removing elements from the tree. You must implement
 	// both of these methods.
 	SplayTree();
+
+	// Copies and moves carry the node and bad insert counts along with the nodes.
+	// A moved from tree is empty, so its counts start again from 0.
+	SplayTree(const SplayTree<Key, Value>& other);
+	SplayTree(SplayTree<Key, Value>&& other) noexcept;
+	SplayTree<Key, Value>& operator=(const SplayTree<Key, Value>& other);
+	SplayTree<Key, Value>& operator=(SplayTree<Key, Value>&& other) noexcept;
+
 	virtual void insert(const std::pair<Key, Value>& keyValuePair) override;
 	void remove(const Key& key);
 	int report() const;
 
+	typedef typename BinarySearchTree<Key, Value>::iterator iterator;
+	typedef typename BinarySearchTree<Key, Value>::range_view range_view;
+
+	// When enabled, the ordered searches below splay the node they return so that
+	// repeated nearby range scans start close to the root. Disabled by default.
+	void setSplayBounds(bool enabled);
+
+	// The const versions from BinarySearchTree never splay
+	using BinarySearchTree<Key, Value>::lower_bound;
+	using BinarySearchTree<Key, Value>::upper_bound;
+	using BinarySearchTree<Key, Value>::floor;
+	using BinarySearchTree<Key, Value>::ceiling;
+	using BinarySearchTree<Key, Value>::range;
+
+	iterator lower_bound(const Key& key);
+	iterator upper_bound(const Key& key);
+	iterator floor(const Key& key);
+	iterator ceiling(const Key& key);
+	range_view range(const Key& lo, const Key& hi);
+
+protected:
+	// Recomputes any data a node derives from its subtree. Plain splay trees
+	// store nothing extra, augmented splay trees override this.
+	virtual void updateNode(Node<Key, Value>* node);
+
+	// Unlinks a node and splays the parent of the changed position
+	virtual void removeNode(Node<Key, Value>* nodeToDelete) override;
+
+	// Recomputes the data of every node after rebalance()
+	virtual void rebuildNodeData() override;
+
+	// Splays node to the root. Every rotated node is recomputed with updateNode.
+	void splay(Node<Key, Value>* node);
+
 private:
 	/* You'll need this for problem 5. Stores the total number of inserts where the
 	   node was added at level strictly worse than 2*log n (n is the number of nodes
@@ -29,6 +71,8 @@ private:
 
 	int n; // To keep track of number of nodes
 
+	bool mSplayBounds; // Whether ordered searches splay the node they return
+
 	/* Helper functions are encouraged. */
 
 	// These are same as AVL rotations
@@ -50,6 +94,9 @@ private:
 
 	// Returns last accessed leaf node if key is not in tree
 	Node<Key, Value>* findHelper(const Key& key);
+
+	// Splays a boundary node if splaying on searches is enabled
+	iterator splayBound(Node<Key, Value>* bound);
 };
 
 /*
@@ -59,15 +106,94 @@ Begin implementations for the SplayTree class.
 */
 
 template<typename Key, typename Value>
-SplayTree<Key, Value>::SplayTree() : badInserts(0) {
+SplayTree<Key, Value>::SplayTree() : badInserts(0), mSplayBounds(false) {
 	n = 0;
 }
 
+/**
+* Copy constructor. The nodes are cloned by BinarySearchTree.
+*/
+template<typename Key, typename Value>
+SplayTree<Key, Value>::SplayTree(const SplayTree<Key, Value>& other)
+	: BinarySearchTree<Key, Value>(other)
+	, badInserts(other.badInserts)
+	, n(other.n)
+	, mSplayBounds(other.mSplayBounds)
+{
+
+}
+
+/**
+* Move constructor.
+*/
+template<typename Key, typename Value>
+SplayTree<Key, Value>::SplayTree(SplayTree<Key, Value>&& other) noexcept
+	: BinarySearchTree<Key, Value>(std::move(other))
+	, badInserts(other.badInserts)
+	, n(other.n)
+	, mSplayBounds(other.mSplayBounds)
+{
+	other.badInserts = 0;
+	other.n = 0;
+}
+
+/**
+* Copy assignment.
+*/
+template<typename Key, typename Value>
+SplayTree<Key, Value>& SplayTree<Key, Value>::operator=(const SplayTree<Key, Value>& other)
+{
+	// Self assignment
+	if (this == &other) {
+		return *this;
+	}
+
+	BinarySearchTree<Key, Value>::operator=(other);
+
+	badInserts = other.badInserts;
+	n = other.n;
+	mSplayBounds = other.mSplayBounds;
+
+	return *this;
+}
+
+/**
+* Move assignment.
+*/
+template<typename Key, typename Value>
+SplayTree<Key, Value>& SplayTree<Key, Value>::operator=(SplayTree<Key, Value>&& other) noexcept
+{
+	// Self assignment
+	if (this == &other) {
+		return *this;
+	}
+
+	BinarySearchTree<Key, Value>::operator=(std::move(other));
+
+	badInserts = other.badInserts;
+	n = other.n;
+	mSplayBounds = other.mSplayBounds;
+
+	other.badInserts = 0;
+	other.n = 0;
+
+	return *this;
+}
+
 template<typename Key, typename Value>
 int SplayTree<Key, Value>::report() const {
 	return badInserts;
 }
 
+/**
+* Hook for derived trees to recompute subtree data after a rotation. Called
+* bottom-up on every node whose children changed.
+*/
+template<typename Key, typename Value>
+void SplayTree<Key, Value>::updateNode(Node<Key, Value>* node) {
+
+}
+
 /**
 * This function will perform AVL LL Rotation then a 
 * right single splay rotation 
@@ -76,6 +202,9 @@ template<typename Key, typename Value>
 void SplayTree<Key, Value>::SplayLLRotation(Node<Key, Value>* x, Node<Key, Value>* y, Node<Key, Value>* z) {
 	AVLLLRotation(x, y, z);
 
+	// z is now below y and keeps its place during the single rotation
+	updateNode(z);
+
 	rightSingleRotation(x, y, z);
 }
 
@@ -87,6 +216,9 @@ template<typename Key, typename Value>
 void SplayTree<Key, Value>::SplayRRRotation(Node<Key, Value>* x, Node<Key, Value>* y, Node<Key, Value>* z) {
 	AVLRRRotation(x, y, z);
 
+	// z is now below y and keeps its place during the single rotation
+	updateNode(z);
+
 	leftSingleRotation(x, y, z);
 }
 
@@ -144,12 +276,10 @@ void SplayTree<Key, Value>::rightSingleRotation(Node<Key, Value>* x, Node<Key, V
 		// If x is already root
 		if (x->getParent() == NULL) {
 			BinarySearchTree<Key, Value>::mRoot = x;
-
-			return;
 		}
 
 		// If y was previously the left child of it's parent
-		if (x->getParent()->getLeft() == y) {
+		else if (x->getParent()->getLeft() == y) {
 			x->getParent()->setLeft(x);
 		}
 
@@ -158,6 +288,10 @@ void SplayTree<Key, Value>::rightSingleRotation(Node<Key, Value>* x, Node<Key, V
 			x->getParent()->setRight(x);
 		}
 	}
+
+	// y is now x's child
+	updateNode(y);
+	updateNode(x);
 }
 
 template<typename Key, typename Value>
@@ -212,12 +346,10 @@ void SplayTree<Key, Value>::leftSingleRotation(Node<Key, Value>* x, Node<Key, Va
 		// If x is already root
 		if (x->getParent() == NULL) {
 			BinarySearchTree<Key, Value>::mRoot = x;
-
-			return;
 		}
 
 		// If y was previously the left child of it's parent
-		if (x->getParent()->getLeft() == y) {
+		else if (x->getParent()->getLeft() == y) {
 			x->getParent()->setLeft(x);
 		}
 
@@ -226,6 +358,10 @@ void SplayTree<Key, Value>::leftSingleRotation(Node<Key, Value>* x, Node<Key, Va
 			x->getParent()->setRight(x);
 		}
 	}
+
+	// y is now x's child
+	updateNode(y);
+	updateNode(x);
 }
 
 template<typename Key, typename Value>
@@ -483,6 +619,11 @@ void SplayTree<Key, Value>::LRRotation(Node<Key, Value>* x, Node<Key, Value>* y,
 			zParent->setRight(x);
 		}
 	}
+
+	// y and z are now x's children
+	updateNode(y);
+	updateNode(z);
+	updateNode(x);
 }
 
 /**
@@ -595,83 +736,129 @@ void SplayTree<Key, Value>::RLRotation(Node<Key, Value>* x, Node<Key, Value>* y,
 			zParent->setRight(x);
 		}
 	}
+
+	// y and z are now x's children
+	updateNode(y);
+	updateNode(z);
+	updateNode(x);
 }
 
 /**
-* Insert function for a key value pair. Finds location to insert the node and then splays it to the top.
+* Calls updateNode on every node in post-order, so children are always done
+* before their parent.
 */
 template<typename Key, typename Value>
-void SplayTree<Key, Value>::insert(const std::pair<Key, Value>& keyValuePair)
-{
-	// Insert new node using BST::insert()
-	BinarySearchTree<Key, Value>::insert(keyValuePair);
+void SplayTree<Key, Value>::rebuildNodeData() {
+	Node<Key, Value>* currNode = BinarySearchTree<Key, Value>::getPostOrderFirst(BinarySearchTree<Key, Value>::mRoot);
 
-	// Increment number of nodes
-	++n;
+	while (currNode != NULL) {
+		updateNode(currNode);
 
-	// This function will update bad inserts if any
-	findHelper(keyValuePair.first);
+		currNode = BinarySearchTree<Key, Value>::getPostOrderNext(currNode);
+	}
+}
 
-	// Find newly inserted node in BST
-	Node<Key, Value>* insertedNode = BinarySearchTree<Key, Value>::internalFind(keyValuePair.first);
+/**
+* Splays a node to the root with zig, zig-zig and zig-zag steps. If automatic
+* rebalancing is on and the node is too deep, the tree is rebalanced first so
+* the splay itself is short.
+*/
+template<typename Key, typename Value>
+void SplayTree<Key, Value>::splay(Node<Key, Value>* node)
+{
+	if (BinarySearchTree<Key, Value>::mRebalanceFactor > 0) {
+		int depth = 0;
 
-	// Splay inserted node to the root
-	while (insertedNode != BinarySearchTree<Key, Value>::mRoot) {
-		// If inserted node is a child of the root
-		if (insertedNode->getParent() == BinarySearchTree<Key, Value>::mRoot) {
-			Node<Key, Value>* y = insertedNode->getParent();
+		for (Node<Key, Value>* currNode = node; currNode != BinarySearchTree<Key, Value>::mRoot; currNode = currNode->getParent()) {
+			++depth;
+		}
 
-			// If inserted node is the left child
-			if (insertedNode->getParent()->getLeft() == insertedNode) {
+		if (BinarySearchTree<Key, Value>::rebalanceNeeded(depth)) {
+			BinarySearchTree<Key, Value>::rebalance();
+		}
+	}
+
+	while (node != BinarySearchTree<Key, Value>::mRoot) {
+		// If node is a child of the root
+		if (node->getParent() == BinarySearchTree<Key, Value>::mRoot) {
+			Node<Key, Value>* y = node->getParent();
+
+			// If node is the left child
+			if (node->getParent()->getLeft() == node) {
 				// Perform right single rotation
-				rightSingleRotation(insertedNode, y, NULL);
+				rightSingleRotation(node, y, NULL);
 			}
 
-			// If inserted node is right child
+			// If node is right child
 			else {
 				// Perform left single rotation
-				leftSingleRotation(insertedNode, y, NULL);
+				leftSingleRotation(node, y, NULL);
 			}
 		}
 
-		// If inserted node is left child of its parent
-		else if (insertedNode->getParent()->getLeft() == insertedNode) {
-			Node<Key, Value>* y = insertedNode->getParent();
+		// If node is left child of its parent
+		else if (node->getParent()->getLeft() == node) {
+			Node<Key, Value>* y = node->getParent();
 			Node<Key, Value>* z = y->getParent();
 
 			// If y is also a left child of its parent
 			if (y->getParent()->getLeft() == y) {
 				// Perform LL Rotation
-				SplayLLRotation(insertedNode, y, z);
+				SplayLLRotation(node, y, z);
 			}
 
 			// If y is a right child of its parent
 			else {
 				// RL Rotation
-				RLRotation(insertedNode, y, z);
+				RLRotation(node, y, z);
 			}
 		}
 
-		// If inserted node is right child of its parent
+		// If node is right child of its parent
 		else {
-			Node<Key, Value>* y = insertedNode->getParent();
+			Node<Key, Value>* y = node->getParent();
 			Node<Key, Value>* z = y->getParent();
 
 			// If y is a left child of its parent
 			if (z->getLeft() == y) {
 				// LR Rotation
-				LRRotation(insertedNode, y, z);
+				LRRotation(node, y, z);
 			}
 
 			// If y is the right child of its parent
 			else {
 				// Perform RR Rotation
-				SplayRRRotation(insertedNode, y, z);
+				SplayRRRotation(node, y, z);
 			}
 		}
 	}
 }
 
+/**
+* Insert function for a key value pair. Finds location to insert the node and then splays it to the top.
+*/
+template<typename Key, typename Value>
+void SplayTree<Key, Value>::insert(const std::pair<Key, Value>& keyValuePair)
+{
+	// Insert new node using BST::insert()
+	BinarySearchTree<Key, Value>::insert(keyValuePair);
+
+	// Increment number of nodes
+	++n;
+
+	// This function will update bad inserts if any
+	findHelper(keyValuePair.first);
+
+	// Find newly inserted node in BST
+	Node<Key, Value>* insertedNode = BinarySearchTree<Key, Value>::internalFind(keyValuePair.first);
+
+	// Splay inserted node to the root
+	splay(insertedNode);
+
+	// If the key was already at the root no rotation recomputed it
+	updateNode(BinarySearchTree<Key, Value>::mRoot);
+}
+
 
 /**
 * This function will keep track of the number of bad inserts and
@@ -733,24 +920,40 @@ void SplayTree<Key, Value>::remove(const Key& key)
 {
 	Node<Key, Value>* nodeToDelete = BinarySearchTree<Key, Value>::internalFind(key);
 
-	Node<Key, Value>* nodeToSplay;
-
 	// If nodeToDelete is not in tree splay last accessed leaf node
 	if (nodeToDelete == NULL) {
-		nodeToSplay = findHelper(key);
+		Node<Key, Value>* nodeToSplay = findHelper(key);
+
 		// If tree is empty do nothing
 		if (nodeToSplay == NULL) {
 			return;
 		}
+
+		splay(nodeToSplay);
+
+		return;
 	}
 
+	removeNode(nodeToDelete);
+}
+
+/**
+* Unlinks a node that is known to be in the tree and splays the parent of the
+* position that changed to the top. Used by remove once the node has been found
+* and by erase, which already holds the node.
+*/
+template<typename Key, typename Value>
+void SplayTree<Key, Value>::removeNode(Node<Key, Value>* nodeToDelete)
+{
+	Node<Key, Value>* nodeToSplay;
+
 	// If nodeToDelete is a leaf node
-	else if (nodeToDelete->getLeft() == NULL && nodeToDelete->getRight() == NULL) {
+	if (nodeToDelete->getLeft() == NULL && nodeToDelete->getRight() == NULL) {
 		nodeToSplay = nodeToDelete->getParent();
 
 		// If tree is empty do nothing
 		if (nodeToSplay == NULL) {
-			BinarySearchTree<Key, Value>::remove(key);
+			BinarySearchTree<Key, Value>::removeNode(nodeToDelete);
 			return;
 		}
 	}
@@ -775,7 +978,7 @@ void SplayTree<Key, Value>::remove(const Key& key)
 
 		// If tree is empty do nothing
 		if (nodeToSplay == NULL) {
-			BinarySearchTree<Key, Value>::remove(key);
+			BinarySearchTree<Key, Value>::removeNode(nodeToDelete);
 			return;
 		}
 	}
@@ -786,69 +989,95 @@ void SplayTree<Key, Value>::remove(const Key& key)
 
 		// If tree is empty do nothing
 		if (nodeToSplay == NULL) {
-			BinarySearchTree<Key, Value>::remove(key);
+			BinarySearchTree<Key, Value>::removeNode(nodeToDelete);
 			return;
 		}
 	}
 
 	// Call BST Remove
-	BinarySearchTree<Key, Value>::remove(key);
+	BinarySearchTree<Key, Value>::removeNode(nodeToDelete);
 
 	// Splay node to splay to the root
-	while (nodeToSplay != BinarySearchTree<Key, Value>::mRoot) {
-		// If inserted node is a child of the root
-		if (nodeToSplay->getParent() == BinarySearchTree<Key, Value>::mRoot) {
-			Node<Key, Value>* y = nodeToSplay->getParent();
+	splay(nodeToSplay);
 
-			// If inserted node is the left child
-			if (nodeToSplay->getParent()->getLeft() == nodeToSplay) {
-				// Perform right single rotation
-				rightSingleRotation(nodeToSplay, y, NULL);
-			}
+	// If the node to splay was already the root no rotation recomputed it
+	updateNode(BinarySearchTree<Key, Value>::mRoot);
+}
 
-			// If inserted node is right child
-			else {
-				// Perform left single rotation
-				leftSingleRotation(nodeToSplay, y, NULL);
-			}
-		}
+/**
+* Turns splaying of the nodes returned by ordered searches on or off.
+*/
+template<typename Key, typename Value>
+void SplayTree<Key, Value>::setSplayBounds(bool enabled)
+{
+	mSplayBounds = enabled;
+}
 
-		// If inserted node is left child of its parent
-		else if (nodeToSplay->getParent()->getLeft() == nodeToSplay) {
-			Node<Key, Value>* y = nodeToSplay->getParent();
-			Node<Key, Value>* z = y->getParent();
+/**
+* Splays the node returned by an ordered search if enabled. Splaying only
+* rotates nodes, so the returned iterator stays valid.
+*/
+template<typename Key, typename Value>
+typename SplayTree<Key, Value>::iterator SplayTree<Key, Value>::splayBound(Node<Key, Value>* bound)
+{
+	if (mSplayBounds && bound != NULL) {
+		splay(bound);
+	}
 
-			// If y is also a left child of its parent
-			if (y->getParent()->getLeft() == y) {
-				// Perform LL Rotation
-				SplayLLRotation(nodeToSplay, y, z);
-			}
+	return iterator(bound, this);
+}
 
-			// If y is a right child of its parent
-			else {
-				// RL Rotation
-				RLRotation(nodeToSplay, y, z);
-			}
-		}
+/**
+* Returns an iterator to the first item whose key is not less than key.
+*/
+template<typename Key, typename Value>
+typename SplayTree<Key, Value>::iterator SplayTree<Key, Value>::lower_bound(const Key& key)
+{
+	return splayBound(BinarySearchTree<Key, Value>::internalCeiling(key, true));
+}
 
-		// If inserted node is right child of its parent
-		else {
-			Node<Key, Value>* y = nodeToSplay->getParent();
-			Node<Key, Value>* z = y->getParent();
+/**
+* Returns an iterator to the first item whose key is greater than key.
+*/
+template<typename Key, typename Value>
+typename SplayTree<Key, Value>::iterator SplayTree<Key, Value>::upper_bound(const Key& key)
+{
+	return splayBound(BinarySearchTree<Key, Value>::internalCeiling(key, false));
+}
 
-			// If y is a left child of its parent
-			if (z->getLeft() == y) {
-				// LR Rotation
-				LRRotation(nodeToSplay, y, z);
-			}
+/**
+* Returns an iterator to the last item whose key is not greater than key.
+*/
+template<typename Key, typename Value>
+typename SplayTree<Key, Value>::iterator SplayTree<Key, Value>::floor(const Key& key)
+{
+	return splayBound(BinarySearchTree<Key, Value>::internalFloor(key, true));
+}
 
-			// If y is the right child of its parent
-			else {
-				// Perform RR Rotation
-				SplayRRRotation(nodeToSplay, y, z);
-			}
-		}
+/**
+* Returns an iterator to the first item whose key is not less than key.
+*/
+template<typename Key, typename Value>
+typename SplayTree<Key, Value>::iterator SplayTree<Key, Value>::ceiling(const Key& key)
+{
+	return splayBound(BinarySearchTree<Key, Value>::internalCeiling(key, true));
+}
+
+/**
+* Returns a view over the items with lo <= key < hi. Only the lower boundary is
+* splayed, since that is where the next nearby scan will start.
+*/
+template<typename Key, typename Value>
+typename SplayTree<Key, Value>::range_view SplayTree<Key, Value>::range(const Key& lo, const Key& hi)
+{
+	// Empty range
+	if (!(lo < hi)) {
+		return range_view(BinarySearchTree<Key, Value>::end(), BinarySearchTree<Key, Value>::end());
 	}
+
+	iterator first = lower_bound(lo);
+
+	return range_view(first, iterator(BinarySearchTree<Key, Value>::internalCeiling(hi, true), this));
 }
 
 /*
@@ -0,0 +1,695 @@
+#ifndef TREAP_H
+#define TREAP_H
+
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <random>
+#include "../bst/bst.h"
+
+/**
+* A special kind of node for a treap, which adds a random priority and the size of
+* the subtree rooted at the node.
+*/
+template <typename Key, typename Value>
+class TreapNode : public Node<Key, Value>
+{
+public:
+	// Constructor/destructor. New nodes are leaves, so their subtree size is 1.
+	TreapNode(const Key& key, const Value& value, TreapNode<Key, Value>* parent, unsigned int priority);
+	virtual ~TreapNode();
+
+	// Getter/setter for the node's priority. A node's priority is never lower
+	// than its children's.
+	unsigned int getPriority() const;
+	void setPriority(unsigned int priority);
+
+	// Getter/setter for the number of nodes in the subtree rooted at this node.
+	int getSize() const;
+	void setSize(int size);
+
+	// Getters for parent, left, and right. These need to be redefined since they
+	// return pointers to TreapNodes - not plain Nodes.
+	virtual TreapNode<Key, Value>* getParent() const override;
+	virtual TreapNode<Key, Value>* getLeft() const override;
+	virtual TreapNode<Key, Value>* getRight() const override;
+
+	// Copies the priority and subtree size as well as the item
+	virtual TreapNode<Key, Value>* clone(Node<Key, Value>* parent) const override;
+
+protected:
+	unsigned int mPriority;
+	int mSize;
+};
+
+/*
+--------------------------------------------
+Begin implementations for the TreapNode class.
+--------------------------------------------
+*/
+
+/**
+* Constructor for a TreapNode.
+*/
+template<typename Key, typename Value>
+TreapNode<Key, Value>::TreapNode(const Key& key, const Value& value, TreapNode<Key, Value>* parent, unsigned int priority)
+	: Node<Key, Value>(key, value, parent)
+	, mPriority(priority)
+	, mSize(1)
+{
+
+}
+
+/**
+* Destructor.
+*/
+template<typename Key, typename Value>
+TreapNode<Key, Value>::~TreapNode()
+{
+
+}
+
+/**
+* Getter function for the priority.
+*/
+template<typename Key, typename Value>
+unsigned int TreapNode<Key, Value>::getPriority() const
+{
+	return mPriority;
+}
+
+/**
+* Setter function for the priority.
+*/
+template<typename Key, typename Value>
+void TreapNode<Key, Value>::setPriority(unsigned int priority)
+{
+	mPriority = priority;
+}
+
+/**
+* Getter function for the subtree size.
+*/
+template<typename Key, typename Value>
+int TreapNode<Key, Value>::getSize() const
+{
+	return mSize;
+}
+
+/**
+* Setter function for the subtree size.
+*/
+template<typename Key, typename Value>
+void TreapNode<Key, Value>::setSize(int size)
+{
+	mSize = size;
+}
+
+/**
+* Getter function for the parent. Used since the node inherits from a base node.
+*/
+template<typename Key, typename Value>
+TreapNode<Key, Value>* TreapNode<Key, Value>::getParent() const
+{
+	return static_cast<TreapNode<Key, Value>*>(this->mParent);
+}
+
+/**
+* Getter function for the left child. Used since the node inherits from a base node.
+*/
+template<typename Key, typename Value>
+TreapNode<Key, Value>* TreapNode<Key, Value>::getLeft() const
+{
+	return static_cast<TreapNode<Key, Value>*>(this->mLeft);
+}
+
+/**
+* Getter function for the right child. Used since the node inherits from a base node.
+*/
+template<typename Key, typename Value>
+TreapNode<Key, Value>* TreapNode<Key, Value>::getRight() const
+{
+	return static_cast<TreapNode<Key, Value>*>(this->mRight);
+}
+
+/**
+* Allocates a copy of this node with the given parent and no children.
+*/
+template<typename Key, typename Value>
+TreapNode<Key, Value>* TreapNode<Key, Value>::clone(Node<Key, Value>* parent) const
+{
+	TreapNode<Key, Value>* copy = new TreapNode<Key, Value>(this->getKey(), this->getValue(),
+		static_cast<TreapNode<Key, Value>*>(parent), mPriority);
+
+	copy->setSize(mSize);
+
+	return copy;
+}
+
+/*
+------------------------------------------
+End implementations for the TreapNode class.
+------------------------------------------
+*/
+
+/**
+* A templated balanced binary search tree implemented as a treap: a search tree by
+* key and a max-heap by random priority, which makes its shape that of a random
+* search tree, O(log n) deep in expectation. Splitting a treap at a key and joining
+* two treaps are single walks down the tree, so whole ranges can be cut off, handed
+* to another thread and joined back in O(log n) expected time.
+*/
+template <class Key, class Value>
+class Treap : public BinarySearchTree<Key, Value>
+{
+public:
+	Treap();
+
+	// Methods for inserting/removing elements from the tree
+	virtual void insert(const std::pair<Key, Value>& keyValuePair) override;
+	void remove(const Key& key);
+
+	typedef typename BinarySearchTree<Key, Value>::iterator iterator;
+	typedef typename BinarySearchTree<Key, Value>::const_iterator const_iterator;
+
+	// Returns the number of items in O(1)
+	int size() const;
+
+	// Moves every item with key >= key into greater in O(log n) expected time.
+	// Items already in greater are removed first.
+	void split(const Key& key, Treap<Key, Value>& greater);
+
+	// Moves every item of greater into this tree in O(log n) expected time and
+	// leaves greater empty. Every key in greater must be larger than every key in
+	// this tree; if not, the trees are merged instead.
+	void join(Treap<Key, Value>& greater);
+
+	// Moves every item of other into this tree and leaves other empty, in
+	// O(m log(n / m)) expected time for trees of sizes m <= n. For a key in both
+	// trees the value from other wins, as if its items had been inserted.
+	void merge(Treap<Key, Value>& other);
+
+protected:
+	// Allocates a TreapNode with a random priority
+	virtual TreapNode<Key, Value>* createNode(const Key& key, const Value& value, Node<Key, Value>* parent) override;
+
+	// Unlinks a node by joining its subtrees in its place
+	virtual void removeNode(Node<Key, Value>* node) override;
+
+	// Gives the complete tree left by rebalance() fresh priorities in heap order
+	virtual void rebuildNodeData() override;
+
+private:
+	// Returns the subtree size of a node, or 0 for NULL
+	static int getSubtreeSize(TreapNode<Key, Value>* node);
+
+	// Links left and right under node and recomputes node's subtree size.
+	// node's own parent pointer is left for the caller to set.
+	static void attach(TreapNode<Key, Value>* node, TreapNode<Key, Value>* left, TreapNode<Key, Value>* right);
+
+	// Joins two subtrees where every key in left is smaller than every key in
+	// right, and returns the root of the result
+	static TreapNode<Key, Value>* joinNodes(TreapNode<Key, Value>* left, TreapNode<Key, Value>* right);
+
+	// Splits a subtree into keys < key, the node with key (or NULL) and keys > key
+	static void splitNodes(TreapNode<Key, Value>* root, const Key& key, TreapNode<Key, Value>*& less,
+		TreapNode<Key, Value>*& equal, TreapNode<Key, Value>*& greater);
+
+	// Returns the root of the union of two subtrees. For a key in both, the
+	// value from theirs is kept.
+	static TreapNode<Key, Value>* uniteNodes(TreapNode<Key, Value>* mine, TreapNode<Key, Value>* theirs);
+
+	// Makes root the root of the tree and recomputes the count and bounds
+	void setRoot(TreapNode<Key, Value>* root);
+
+	TreapNode<Key, Value>* getRoot() const;
+
+	// Source of node priorities
+	std::mt19937 mRandom;
+};
+
+/*
+--------------------------------------------
+Begin implementations for the Treap class.
+--------------------------------------------
+*/
+
+template<typename Key, typename Value>
+Treap<Key, Value>::Treap() {
+
+}
+
+/**
+* Allocates a TreapNode with a random priority.
+*/
+template<typename Key, typename Value>
+TreapNode<Key, Value>* Treap<Key, Value>::createNode(const Key& key, const Value& value, Node<Key, Value>* parent) {
+	return new TreapNode<Key, Value>(key, value, static_cast<TreapNode<Key, Value>*>(parent), mRandom());
+}
+
+/**
+* Returns the root as a TreapNode.
+*/
+template<typename Key, typename Value>
+TreapNode<Key, Value>* Treap<Key, Value>::getRoot() const {
+	return static_cast<TreapNode<Key, Value>*>(BinarySearchTree<Key, Value>::mRoot);
+}
+
+/**
+* Returns the subtree size of a node, treating NULL as size 0.
+*/
+template<typename Key, typename Value>
+int Treap<Key, Value>::getSubtreeSize(TreapNode<Key, Value>* node) {
+	if (node == NULL) {
+		return 0;
+	}
+
+	return node->getSize();
+}
+
+/**
+* Returns the number of items in O(1).
+*/
+template<typename Key, typename Value>
+int Treap<Key, Value>::size() const {
+	return getSubtreeSize(getRoot());
+}
+
+/**
+* Links left and right under node and recomputes node's subtree size.
+*/
+template<typename Key, typename Value>
+void Treap<Key, Value>::attach(TreapNode<Key, Value>* node, TreapNode<Key, Value>* left, TreapNode<Key, Value>* right) {
+	node->setLeft(left);
+	node->setRight(right);
+
+	if (left != NULL) {
+		left->setParent(node);
+	}
+
+	if (right != NULL) {
+		right->setParent(node);
+	}
+
+	node->setSize(getSubtreeSize(left) + getSubtreeSize(right) + 1);
+}
+
+/**
+* Joins two subtrees by walking down the right spine of left and the left spine
+* of right, always keeping the root with the higher priority.
+*/
+template<typename Key, typename Value>
+TreapNode<Key, Value>* Treap<Key, Value>::joinNodes(TreapNode<Key, Value>* left, TreapNode<Key, Value>* right) {
+	// If either side is empty the other is the result
+	if (left == NULL) {
+		return right;
+	}
+
+	if (right == NULL) {
+		return left;
+	}
+
+	// left's root stays on top, right joins its right subtree
+	if (left->getPriority() > right->getPriority()) {
+		attach(left, left->getLeft(), joinNodes(left->getRight(), right));
+		return left;
+	}
+
+	// right's root stays on top, left joins its left subtree
+	attach(right, joinNodes(left, right->getLeft()), right->getRight());
+	return right;
+}
+
+/**
+* Splits a subtree by walking down the search path for key. Nodes on the path go
+* to whichever side their key belongs to, taking the subtree on that side along.
+*/
+template<typename Key, typename Value>
+void Treap<Key, Value>::splitNodes(TreapNode<Key, Value>* root, const Key& key, TreapNode<Key, Value>*& less,
+	TreapNode<Key, Value>*& equal, TreapNode<Key, Value>*& greater) {
+	// Empty subtree
+	if (root == NULL) {
+		less = NULL;
+		equal = NULL;
+		greater = NULL;
+		return;
+	}
+
+	// root and its left subtree are below key
+	if (root->getKey() < key) {
+		TreapNode<Key, Value>* rest;
+
+		splitNodes(root->getRight(), key, rest, equal, greater);
+		attach(root, root->getLeft(), rest);
+
+		less = root;
+	}
+
+	// root and its right subtree are above key
+	else if (key < root->getKey()) {
+		TreapNode<Key, Value>* rest;
+
+		splitNodes(root->getLeft(), key, less, equal, rest);
+		attach(root, rest, root->getRight());
+
+		greater = root;
+	}
+
+	// root holds key, so its subtrees are the two sides
+	else {
+		less = root->getLeft();
+		greater = root->getRight();
+
+		attach(root, NULL, NULL);
+
+		equal = root;
+	}
+
+	// The roots of the pieces are detached from root
+	if (less != NULL) {
+		less->setParent(NULL);
+	}
+
+	if (greater != NULL) {
+		greater->setParent(NULL);
+	}
+}
+
+/**
+* Unites two subtrees. The root with the higher priority stays on top, the other
+* subtree is split at its key, and each half is united with the matching child.
+*/
+template<typename Key, typename Value>
+TreapNode<Key, Value>* Treap<Key, Value>::uniteNodes(TreapNode<Key, Value>* mine, TreapNode<Key, Value>* theirs) {
+	// If either side is empty the other is the result
+	if (mine == NULL) {
+		return theirs;
+	}
+
+	if (theirs == NULL) {
+		return mine;
+	}
+
+	TreapNode<Key, Value>* less;
+	TreapNode<Key, Value>* equal;
+	TreapNode<Key, Value>* greater;
+
+	// mine's root stays on top
+	if (mine->getPriority() > theirs->getPriority()) {
+		splitNodes(theirs, mine->getKey(), less, equal, greater);
+
+		// The key is in both trees, so keep their value in this node
+		if (equal != NULL) {
+			mine->setValue(equal->getValue());
+			delete equal;
+		}
+
+		TreapNode<Key, Value>* left = mine->getLeft();
+		TreapNode<Key, Value>* right = mine->getRight();
+
+		attach(mine, uniteNodes(left, less), uniteNodes(right, greater));
+		return mine;
+	}
+
+	// theirs' root stays on top
+	splitNodes(mine, theirs->getKey(), less, equal, greater);
+
+	// The key is in both trees and theirs already has the value to keep
+	if (equal != NULL) {
+		delete equal;
+	}
+
+	TreapNode<Key, Value>* left = theirs->getLeft();
+	TreapNode<Key, Value>* right = theirs->getRight();
+
+	attach(theirs, uniteNodes(less, left), uniteNodes(greater, right));
+	return theirs;
+}
+
+/**
+* Makes root the root of the tree, then recomputes the node count from its size
+* and the cached bounds from its spines.
+*/
+template<typename Key, typename Value>
+void Treap<Key, Value>::setRoot(TreapNode<Key, Value>* root) {
+	if (root != NULL) {
+		root->setParent(NULL);
+	}
+
+	BinarySearchTree<Key, Value>::mRoot = root;
+	BinarySearchTree<Key, Value>::mNodeCount = getSubtreeSize(root);
+	BinarySearchTree<Key, Value>::recacheBounds();
+}
+
+/**
+* Inserts a key value pair. The new node goes where the search path first meets a
+* node with a lower priority, and the subtree there is split at the key to become
+* the new node's children, so no rotations are needed. A duplicate key updates
+* the value without changing the tree.
+*/
+template<typename Key, typename Value>
+void Treap<Key, Value>::insert(const std::pair<Key, Value>& keyValuePair)
+{
+	Node<Key, Value>* existing = BinarySearchTree<Key, Value>::internalFind(keyValuePair.first);
+
+	// If there is a duplicate entry
+	if (existing != NULL) {
+		// Update its value
+		existing->setValue(keyValuePair.second);
+		return;
+	}
+
+	TreapNode<Key, Value>* newNode = createNode(keyValuePair.first, keyValuePair.second, NULL);
+
+	TreapNode<Key, Value>* parent = NULL;
+	TreapNode<Key, Value>* currNode = getRoot();
+
+	// Walk down while the nodes on the path outrank the new node. Each of them
+	// gains one node in its subtree.
+	while (currNode != NULL && currNode->getPriority() > newNode->getPriority()) {
+		currNode->setSize(currNode->getSize() + 1);
+
+		parent = currNode;
+
+		// If key is less than currNode go to left child
+		if (newNode->getKey() < currNode->getKey()) {
+			currNode = currNode->getLeft();
+		}
+
+		// If key is greater than currNode go to right child
+		else {
+			currNode = currNode->getRight();
+		}
+	}
+
+	// The subtree below the new node's position becomes its children
+	TreapNode<Key, Value>* less;
+	TreapNode<Key, Value>* equal;
+	TreapNode<Key, Value>* greater;
+
+	splitNodes(currNode, newNode->getKey(), less, equal, greater);
+	attach(newNode, less, greater);
+
+	newNode->setParent(parent);
+
+	// If the new node is the root
+	if (parent == NULL) {
+		BinarySearchTree<Key, Value>::mRoot = newNode;
+	}
+
+	// If new node is lesser than parent
+	else if (newNode->getKey() < parent->getKey()) {
+		parent->setLeft(newNode);
+	}
+
+	// If new node is greater than parent
+	else {
+		parent->setRight(newNode);
+	}
+
+	BinarySearchTree<Key, Value>::cacheInsertedNode(newNode);
+}
+
+/**
+* Removes the node with the given key. Does nothing if the key is not in the tree.
+*/
+template<typename Key, typename Value>
+void Treap<Key, Value>::remove(const Key& key)
+{
+	Node<Key, Value>* nodeToDelete = BinarySearchTree<Key, Value>::internalFind(key);
+
+	// If node to delete does not exist do nothing
+	if (nodeToDelete == NULL) {
+		return;
+	}
+
+	removeNode(nodeToDelete);
+}
+
+/**
+* Unlinks a node that is known to be in the tree by joining its two subtrees and
+* putting the result in its place.
+*/
+template<typename Key, typename Value>
+void Treap<Key, Value>::removeNode(Node<Key, Value>* node)
+{
+	TreapNode<Key, Value>* nodeToDelete = static_cast<TreapNode<Key, Value>*>(node);
+
+	// Move the cached min/max off the node while it is still linked
+	BinarySearchTree<Key, Value>::uncacheRemovedNode(nodeToDelete);
+
+	TreapNode<Key, Value>* parent = nodeToDelete->getParent();
+	TreapNode<Key, Value>* replacement = joinNodes(nodeToDelete->getLeft(), nodeToDelete->getRight());
+
+	if (replacement != NULL) {
+		replacement->setParent(parent);
+	}
+
+	// If nodeToDelete was the root
+	if (parent == NULL) {
+		BinarySearchTree<Key, Value>::mRoot = replacement;
+	}
+
+	// If nodeToDelete was a left child
+	else if (parent->getLeft() == nodeToDelete) {
+		parent->setLeft(replacement);
+	}
+
+	// If nodeToDelete was a right child
+	else {
+		parent->setRight(replacement);
+	}
+
+	// Every ancestor lost one node from its subtree
+	for (TreapNode<Key, Value>* currNode = parent; currNode != NULL; currNode = currNode->getParent()) {
+		currNode->setSize(currNode->getSize() - 1);
+	}
+
+	// Free allocated memory
+	this->destroyNode(nodeToDelete);
+}
+
+/**
+* Cuts off every item with key >= key into greater. Both trees keep their nodes,
+* no node is copied.
+*/
+template<typename Key, typename Value>
+void Treap<Key, Value>::split(const Key& key, Treap<Key, Value>& greater)
+{
+	// Splitting into itself would lose the upper half
+	if (&greater == this) {
+		return;
+	}
+
+	greater.clear();
+
+	TreapNode<Key, Value>* less;
+	TreapNode<Key, Value>* equal;
+	TreapNode<Key, Value>* above;
+
+	splitNodes(getRoot(), key, less, equal, above);
+
+	setRoot(less);
+	greater.setRoot(joinNodes(equal, above));
+}
+
+/**
+* Appends every item of greater. Keys that do not all lie above this tree's keys
+* fall back to merge.
+*/
+template<typename Key, typename Value>
+void Treap<Key, Value>::join(Treap<Key, Value>& greater)
+{
+	// Joining with itself would link every node twice
+	if (&greater == this) {
+		return;
+	}
+
+	// If the key ranges overlap the trees have to be merged
+	if (BinarySearchTree<Key, Value>::mMax != NULL && greater.mMin != NULL &&
+		!(BinarySearchTree<Key, Value>::mMax->getKey() < greater.mMin->getKey())) {
+		merge(greater);
+		return;
+	}
+
+	TreapNode<Key, Value>* upper = greater.getRoot();
+
+	// greater gives up its nodes
+	greater.setRoot(NULL);
+
+	setRoot(joinNodes(getRoot(), upper));
+}
+
+/**
+* Unites the two trees node by node. Every node of both trees is reused, except
+* for the node in this tree for a key that is also in other.
+*/
+template<typename Key, typename Value>
+void Treap<Key, Value>::merge(Treap<Key, Value>& other)
+{
+	// Merging with itself would link every node twice
+	if (&other == this) {
+		return;
+	}
+
+	TreapNode<Key, Value>* theirs = other.getRoot();
+
+	// other gives up its nodes
+	other.setRoot(NULL);
+
+	setRoot(uniteNodes(getRoot(), theirs));
+}
+
+/**
+* Gives every node a fresh random priority and then restores heap order by
+* sifting each priority down, visiting nodes in post-order so both subtrees are
+* already heaps. Only priorities move, so the shape from rebalance() is kept, and
+* the total work is O(n) like building a binary heap.
+*/
+template<typename Key, typename Value>
+void Treap<Key, Value>::rebuildNodeData()
+{
+	Node<Key, Value>* currNode = BinarySearchTree<Key, Value>::getPostOrderFirst(BinarySearchTree<Key, Value>::mRoot);
+
+	while (currNode != NULL) {
+		TreapNode<Key, Value>* siftNode = static_cast<TreapNode<Key, Value>*>(currNode);
+
+		siftNode->setPriority(mRandom());
+		siftNode->setSize(getSubtreeSize(siftNode->getLeft()) + getSubtreeSize(siftNode->getRight()) + 1);
+
+		// Swap the priority down until both children are lower
+		while (true) {
+			TreapNode<Key, Value>* higher = siftNode;
+
+			if (siftNode->getLeft() != NULL && siftNode->getLeft()->getPriority() > higher->getPriority()) {
+				higher = siftNode->getLeft();
+			}
+
+			if (siftNode->getRight() != NULL && siftNode->getRight()->getPriority() > higher->getPriority()) {
+				higher = siftNode->getRight();
+			}
+
+			// Heap order holds here
+			if (higher == siftNode) {
+				break;
+			}
+
+			unsigned int priority = higher->getPriority();
+
+			higher->setPriority(siftNode->getPriority());
+			siftNode->setPriority(priority);
+
+			siftNode = higher;
+		}
+
+		currNode = BinarySearchTree<Key, Value>::getPostOrderNext(currNode);
+	}
+}
+
+/*
+------------------------------------------
+End implementations for the Treap class.
+------------------------------------------
+*/
+
+#endif
@@ -0,0 +1,634 @@
+#ifndef WAVLBST_H
+#define WAVLBST_H
+
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <algorithm>
+#include "../bst/bst.h"
+
+/**
+* A special kind of node for a weak AVL tree, which adds the rank as a data member.
+* A leaf has rank 0 and a missing child counts as rank -1.
+*/
+template <typename Key, typename Value>
+class WAVLNode : public Node<Key, Value>
+{
+public:
+	// Constructor/destructor. New nodes are leaves, so their rank is 0.
+	WAVLNode(const Key& key, const Value& value, WAVLNode<Key, Value>* parent);
+	virtual ~WAVLNode();
+
+	// Getter/setter for the node's rank.
+	int getRank() const;
+	void setRank(int rank);
+
+	// Getters for parent, left, and right. These need to be redefined since they
+	// return pointers to WAVLNodes - not plain Nodes.
+	virtual WAVLNode<Key, Value>* getParent() const override;
+	virtual WAVLNode<Key, Value>* getLeft() const override;
+	virtual WAVLNode<Key, Value>* getRight() const override;
+
+	// Copies the rank as well as the item
+	virtual WAVLNode<Key, Value>* clone(Node<Key, Value>* parent) const override;
+
+protected:
+	int mRank;
+};
+
+/*
+--------------------------------------------
+Begin implementations for the WAVLNode class.
+--------------------------------------------
+*/
+
+/**
+* Constructor for a WAVLNode. Nodes are initialized with a rank of 0.
+*/
+template<typename Key, typename Value>
+WAVLNode<Key, Value>::WAVLNode(const Key& key, const Value& value, WAVLNode<Key, Value>* parent)
+	: Node<Key, Value>(key, value, parent)
+	, mRank(0)
+{
+
+}
+
+/**
+* Destructor.
+*/
+template<typename Key, typename Value>
+WAVLNode<Key, Value>::~WAVLNode()
+{
+
+}
+
+/**
+* Getter function for the rank.
+*/
+template<typename Key, typename Value>
+int WAVLNode<Key, Value>::getRank() const
+{
+	return mRank;
+}
+
+/**
+* Setter function for the rank.
+*/
+template<typename Key, typename Value>
+void WAVLNode<Key, Value>::setRank(int rank)
+{
+	mRank = rank;
+}
+
+/**
+* Getter function for the parent. Used since the node inherits from a base node.
+*/
+template<typename Key, typename Value>
+WAVLNode<Key, Value>* WAVLNode<Key, Value>::getParent() const
+{
+	return static_cast<WAVLNode<Key, Value>*>(this->mParent);
+}
+
+/**
+* Getter function for the left child. Used since the node inherits from a base node.
+*/
+template<typename Key, typename Value>
+WAVLNode<Key, Value>* WAVLNode<Key, Value>::getLeft() const
+{
+	return static_cast<WAVLNode<Key, Value>*>(this->mLeft);
+}
+
+/**
+* Getter function for the right child. Used since the node inherits from a base node.
+*/
+template<typename Key, typename Value>
+WAVLNode<Key, Value>* WAVLNode<Key, Value>::getRight() const
+{
+	return static_cast<WAVLNode<Key, Value>*>(this->mRight);
+}
+
+/**
+* Allocates a copy of this node with the given parent and no children.
+*/
+template<typename Key, typename Value>
+WAVLNode<Key, Value>* WAVLNode<Key, Value>::clone(Node<Key, Value>* parent) const
+{
+	WAVLNode<Key, Value>* copy = new WAVLNode<Key, Value>(this->getKey(), this->getValue(), static_cast<WAVLNode<Key, Value>*>(parent));
+
+	copy->setRank(mRank);
+
+	return copy;
+}
+
+/*
+------------------------------------------
+End implementations for the WAVLNode class.
+------------------------------------------
+*/
+
+/**
+* A templated balanced binary search tree implemented as a weak AVL tree. Every node
+* stores a rank, and the rank difference between a node and its parent is always 1
+* or 2, with leaves at rank 0. Inserts rebalance exactly like an AVL tree, so a tree
+* built only by inserts is an AVL tree. Removes relax the AVL rule by allowing
+* nodes whose children are both 2 ranks lower, which lets every remove finish with
+* at most two rotations instead of one per level.
+*/
+template <class Key, class Value>
+class WAVLTree : public BinarySearchTree<Key, Value>
+{
+public:
+	WAVLTree();
+
+	// Methods for inserting/removing elements from the tree
+	virtual void insert(const std::pair<Key, Value>& keyValuePair) override;
+	void remove(const Key& key);
+
+	typedef typename BinarySearchTree<Key, Value>::iterator iterator;
+	typedef typename BinarySearchTree<Key, Value>::const_iterator const_iterator;
+
+	// Number of single rotations this tree has done (a double rotation counts as
+	// two), for comparing rebalancing cost between trees
+	long long rotations() const;
+
+protected:
+	// Allocates a WAVLNode for insert
+	virtual WAVLNode<Key, Value>* createNode(const Key& key, const Value& value, Node<Key, Value>* parent) override;
+
+	// Unlinks a node and restores the rank rules
+	virtual void removeNode(Node<Key, Value>* node) override;
+
+	// Recomputes every rank after rebalance()
+	virtual void rebuildNodeData() override;
+
+private:
+	// Rotations around x. Ranks are left to the callers.
+	void rotateLeft(WAVLNode<Key, Value>* x);
+	void rotateRight(WAVLNode<Key, Value>* x);
+
+	// Puts newNode in place of oldNode under oldNode's parent
+	void transplant(WAVLNode<Key, Value>* oldNode, WAVLNode<Key, Value>* newNode);
+
+	// Fixes a node with the same rank as its parent, starting at a new leaf
+	void insertFixup(WAVLNode<Key, Value>* node);
+
+	// Fixes a node 3 ranks below its parent, or a leaf of rank 1, after a remove.
+	// node may be NULL, so its parent is passed as well.
+	void removeFixup(WAVLNode<Key, Value>* node, WAVLNode<Key, Value>* parent);
+
+	// Returns the rank of node, or -1 for NULL
+	static int getRank(WAVLNode<Key, Value>* node);
+
+	WAVLNode<Key, Value>* getRoot() const;
+
+	// Rotations done by this tree
+	long long mRotations;
+};
+
+/*
+--------------------------------------------
+Begin implementations for the WAVLTree class.
+--------------------------------------------
+*/
+
+template<typename Key, typename Value>
+WAVLTree<Key, Value>::WAVLTree()
+	: mRotations(0)
+{
+
+}
+
+/**
+* Allocates a WAVLNode for insert.
+*/
+template<typename Key, typename Value>
+WAVLNode<Key, Value>* WAVLTree<Key, Value>::createNode(const Key& key, const Value& value, Node<Key, Value>* parent) {
+	return new WAVLNode<Key, Value>(key, value, static_cast<WAVLNode<Key, Value>*>(parent));
+}
+
+/**
+* Returns the root as a WAVLNode.
+*/
+template<typename Key, typename Value>
+WAVLNode<Key, Value>* WAVLTree<Key, Value>::getRoot() const {
+	return static_cast<WAVLNode<Key, Value>*>(BinarySearchTree<Key, Value>::mRoot);
+}
+
+/**
+* Returns the rank of node. A missing child has rank -1, one below a leaf.
+*/
+template<typename Key, typename Value>
+int WAVLTree<Key, Value>::getRank(WAVLNode<Key, Value>* node) {
+	if (node == NULL) {
+		return -1;
+	}
+
+	return node->getRank();
+}
+
+/**
+* Returns the number of single rotations this tree has done. A double rotation
+* counts as two.
+*/
+template<typename Key, typename Value>
+long long WAVLTree<Key, Value>::rotations() const {
+	return mRotations;
+}
+
+/**
+* Inserts a key value pair as a rank 0 leaf and then fixes the ranks above it.
+* A duplicate key updates the value without changing the tree.
+*/
+template<typename Key, typename Value>
+void WAVLTree<Key, Value>::insert(const std::pair<Key, Value>& keyValuePair)
+{
+	WAVLNode<Key, Value>* parent = NULL;
+	WAVLNode<Key, Value>* currNode = getRoot();
+
+	// Find the leaf position for the key
+	while (currNode != NULL) {
+		// If there is a duplicate entry
+		if (keyValuePair.first == currNode->getKey()) {
+			// Update currNode's value
+			currNode->setValue(keyValuePair.second);
+			return;
+		}
+
+		parent = currNode;
+
+		// If key is less than currNode go to left child
+		if (keyValuePair.first < currNode->getKey()) {
+			currNode = currNode->getLeft();
+		}
+
+		// If key is greater than currNode go to right child
+		else {
+			currNode = currNode->getRight();
+		}
+	}
+
+	WAVLNode<Key, Value>* newNode = createNode(keyValuePair.first, keyValuePair.second, parent);
+
+	// If the tree was empty the new node is the root
+	if (parent == NULL) {
+		BinarySearchTree<Key, Value>::mRoot = newNode;
+	}
+
+	// If new node is lesser than parent
+	else if (newNode->getKey() < parent->getKey()) {
+		parent->setLeft(newNode);
+	}
+
+	// If new node is greater than parent
+	else {
+		parent->setRight(newNode);
+	}
+
+	BinarySearchTree<Key, Value>::cacheInsertedNode(newNode);
+
+	insertFixup(newNode);
+}
+
+/**
+* Walks up while node has the same rank as its parent. If the sibling is one rank
+* below the parent, promoting the parent fixes this level and the problem moves
+* up. Otherwise one or two rotations fix the tree and the walk ends.
+*/
+template<typename Key, typename Value>
+void WAVLTree<Key, Value>::insertFixup(WAVLNode<Key, Value>* node)
+{
+	while (node->getParent() != NULL && node->getParent()->getRank() == node->getRank()) {
+		WAVLNode<Key, Value>* parent = node->getParent();
+		bool isLeft = (node == parent->getLeft());
+		WAVLNode<Key, Value>* sibling = isLeft ? parent->getRight() : parent->getLeft();
+
+		// Sibling is a 1-child, so promote the parent and move up
+		if (parent->getRank() - getRank(sibling) == 1) {
+			parent->setRank(parent->getRank() + 1);
+
+			node = parent;
+			continue;
+		}
+
+		// Sibling is a 2-child. The child of node on the inner side decides
+		// between a single and a double rotation.
+		WAVLNode<Key, Value>* inner = isLeft ? node->getRight() : node->getLeft();
+
+		// Inner child is a 2-child, so rotate node up
+		if (node->getRank() - getRank(inner) == 2) {
+			if (isLeft) {
+				rotateRight(parent);
+			}
+
+			else {
+				rotateLeft(parent);
+			}
+
+			parent->setRank(parent->getRank() - 1);
+		}
+
+		// Inner child is a 1-child, so rotate it up twice
+		else {
+			if (isLeft) {
+				rotateLeft(node);
+				rotateRight(parent);
+			}
+
+			else {
+				rotateRight(node);
+				rotateLeft(parent);
+			}
+
+			inner->setRank(inner->getRank() + 1);
+			node->setRank(node->getRank() - 1);
+			parent->setRank(parent->getRank() - 1);
+		}
+
+		break;
+	}
+}
+
+/**
+* Removes the node with the given key. Does nothing if the key is not in the tree.
+*/
+template<typename Key, typename Value>
+void WAVLTree<Key, Value>::remove(const Key& key)
+{
+	Node<Key, Value>* nodeToDelete = BinarySearchTree<Key, Value>::internalFind(key);
+
+	// If node to delete does not exist do nothing
+	if (nodeToDelete == NULL) {
+		return;
+	}
+
+	removeNode(nodeToDelete);
+}
+
+/**
+* Unlinks a node that is known to be in the tree. A node with two children is
+* replaced by its successor, which takes over its position and rank, so the node
+* that actually leaves its position has at most one child.
+*/
+template<typename Key, typename Value>
+void WAVLTree<Key, Value>::removeNode(Node<Key, Value>* node)
+{
+	WAVLNode<Key, Value>* nodeToDelete = static_cast<WAVLNode<Key, Value>*>(node);
+
+	// Move the cached min/max off the node while it is still linked
+	BinarySearchTree<Key, Value>::uncacheRemovedNode(nodeToDelete);
+
+	// The node that moves into the vacated position, and its new parent
+	WAVLNode<Key, Value>* child;
+	WAVLNode<Key, Value>* childParent;
+
+	// If there is no left child the right child moves up
+	if (nodeToDelete->getLeft() == NULL) {
+		child = nodeToDelete->getRight();
+		childParent = nodeToDelete->getParent();
+
+		transplant(nodeToDelete, child);
+	}
+
+	// If there is no right child the left child moves up
+	else if (nodeToDelete->getRight() == NULL) {
+		child = nodeToDelete->getLeft();
+		childParent = nodeToDelete->getParent();
+
+		transplant(nodeToDelete, child);
+	}
+
+	// Two children, so the successor takes nodeToDelete's place
+	else {
+		WAVLNode<Key, Value>* successor = nodeToDelete->getRight();
+
+		while (successor->getLeft() != NULL) {
+			successor = successor->getLeft();
+		}
+
+		child = successor->getRight();
+
+		// If the successor is the right child it keeps its right subtree
+		if (successor->getParent() == nodeToDelete) {
+			childParent = successor;
+		}
+
+		// Otherwise its right subtree takes its place first
+		else {
+			childParent = successor->getParent();
+
+			transplant(successor, child);
+
+			successor->setRight(nodeToDelete->getRight());
+			successor->getRight()->setParent(successor);
+		}
+
+		transplant(nodeToDelete, successor);
+
+		successor->setLeft(nodeToDelete->getLeft());
+		successor->getLeft()->setParent(successor);
+		successor->setRank(nodeToDelete->getRank());
+	}
+
+	// Free allocated memory
+	this->destroyNode(nodeToDelete);
+
+	removeFixup(child, childParent);
+}
+
+/**
+* Restores the rank rules after a remove. A parent left as a leaf of rank 1 is
+* demoted first. Then, while node is 3 ranks below its parent: if the sibling is
+* a 2-child, or a 1-child whose own children are both 2-children, demoting the
+* parent (and the sibling) fixes this level and the problem moves up. Otherwise
+* one or two rotations fix the tree and the walk ends.
+*/
+template<typename Key, typename Value>
+void WAVLTree<Key, Value>::removeFixup(WAVLNode<Key, Value>* node, WAVLNode<Key, Value>* parent)
+{
+	// Nothing above the removed position
+	if (parent == NULL) {
+		return;
+	}
+
+	// A leaf must have rank 0
+	if (parent->getLeft() == NULL && parent->getRight() == NULL && parent->getRank() == 1) {
+		parent->setRank(0);
+
+		node = parent;
+		parent = node->getParent();
+	}
+
+	while (parent != NULL && parent->getRank() - getRank(node) == 3) {
+		bool isLeft = (node == parent->getLeft());
+
+		// The sibling is at most 2 ranks below parent, which is at least rank 2,
+		// so it exists
+		WAVLNode<Key, Value>* sibling = isLeft ? parent->getRight() : parent->getLeft();
+
+		// Sibling is a 2-child, so demote the parent and move up
+		if (parent->getRank() - sibling->getRank() == 2) {
+			parent->setRank(parent->getRank() - 1);
+
+			node = parent;
+			parent = node->getParent();
+			continue;
+		}
+
+		WAVLNode<Key, Value>* inner = isLeft ? sibling->getLeft() : sibling->getRight();
+		WAVLNode<Key, Value>* outer = isLeft ? sibling->getRight() : sibling->getLeft();
+
+		// Both of the sibling's children are 2-children, so demote both and move up
+		if (sibling->getRank() - getRank(inner) == 2 && sibling->getRank() - getRank(outer) == 2) {
+			parent->setRank(parent->getRank() - 1);
+			sibling->setRank(sibling->getRank() - 1);
+
+			node = parent;
+			parent = node->getParent();
+			continue;
+		}
+
+		// Outer child is a 1-child, so rotate the sibling up
+		if (sibling->getRank() - getRank(outer) == 1) {
+			if (isLeft) {
+				rotateLeft(parent);
+			}
+
+			else {
+				rotateRight(parent);
+			}
+
+			sibling->setRank(sibling->getRank() + 1);
+			parent->setRank(parent->getRank() - 1);
+
+			// A leaf must have rank 0
+			if (parent->getLeft() == NULL && parent->getRight() == NULL) {
+				parent->setRank(parent->getRank() - 1);
+			}
+		}
+
+		// Only the inner child is a 1-child, so rotate it up twice
+		else {
+			if (isLeft) {
+				rotateRight(sibling);
+				rotateLeft(parent);
+			}
+
+			else {
+				rotateLeft(sibling);
+				rotateRight(parent);
+			}
+
+			inner->setRank(inner->getRank() + 2);
+			sibling->setRank(sibling->getRank() - 1);
+			parent->setRank(parent->getRank() - 2);
+		}
+
+		break;
+	}
+}
+
+/**
+* Puts newNode (which may be NULL) in place of oldNode under oldNode's parent.
+* oldNode's own links are left for the caller.
+*/
+template<typename Key, typename Value>
+void WAVLTree<Key, Value>::transplant(WAVLNode<Key, Value>* oldNode, WAVLNode<Key, Value>* newNode)
+{
+	WAVLNode<Key, Value>* parent = oldNode->getParent();
+
+	// If oldNode was the root
+	if (parent == NULL) {
+		BinarySearchTree<Key, Value>::mRoot = newNode;
+	}
+
+	// If oldNode was a left child
+	else if (oldNode == parent->getLeft()) {
+		parent->setLeft(newNode);
+	}
+
+	// If oldNode was a right child
+	else {
+		parent->setRight(newNode);
+	}
+
+	if (newNode != NULL) {
+		newNode->setParent(parent);
+	}
+}
+
+/**
+* Rotates x's right child up into x's place.
+*/
+template<typename Key, typename Value>
+void WAVLTree<Key, Value>::rotateLeft(WAVLNode<Key, Value>* x)
+{
+	++mRotations;
+
+	WAVLNode<Key, Value>* y = x->getRight();
+
+	// y's left subtree moves over to x
+	x->setRight(y->getLeft());
+
+	if (y->getLeft() != NULL) {
+		y->getLeft()->setParent(x);
+	}
+
+	// y takes x's place
+	transplant(x, y);
+
+	// x becomes y's left child
+	y->setLeft(x);
+	x->setParent(y);
+}
+
+/**
+* Rotates x's left child up into x's place.
+*/
+template<typename Key, typename Value>
+void WAVLTree<Key, Value>::rotateRight(WAVLNode<Key, Value>* x)
+{
+	++mRotations;
+
+	WAVLNode<Key, Value>* y = x->getLeft();
+
+	// y's right subtree moves over to x
+	x->setLeft(y->getRight());
+
+	if (y->getRight() != NULL) {
+		y->getRight()->setParent(x);
+	}
+
+	// y takes x's place
+	transplant(x, y);
+
+	// x becomes y's right child
+	y->setRight(x);
+	x->setParent(y);
+}
+
+/**
+* Sets every rank to the node's height minus one, in post-order so children are
+* done before their parent. The tree left by rebalance() is an AVL tree, and AVL
+* heights are valid ranks.
+*/
+template<typename Key, typename Value>
+void WAVLTree<Key, Value>::rebuildNodeData()
+{
+	Node<Key, Value>* currNode = BinarySearchTree<Key, Value>::getPostOrderFirst(BinarySearchTree<Key, Value>::mRoot);
+
+	while (currNode != NULL) {
+		WAVLNode<Key, Value>* currWAVLNode = static_cast<WAVLNode<Key, Value>*>(currNode);
+
+		currWAVLNode->setRank(std::max(getRank(currWAVLNode->getLeft()), getRank(currWAVLNode->getRight())) + 1);
+
+		currNode = BinarySearchTree<Key, Value>::getPostOrderNext(currNode);
+	}
+}
+
+/*
+------------------------------------------
+End implementations for the WAVLTree class.
+------------------------------------------
+*/
+
+#endif